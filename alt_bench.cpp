@@ -0,0 +1,75 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "maze_generators.h"
+#include "maze_solvers.h"
+#include "maze_alt.h"
+
+// Benchmark: A* with the Manhattan heuristic against A* with ALT landmarks, on a braided
+// maze without terrain and then with costs 1-16.
+// Usage: alt_bench [size] [landmarks] [queries] [braid]
+const int DEFAULT_SIZE = 4096;
+const int DEFAULT_LANDMARKS = 8;
+const int DEFAULT_QUERIES = 20;
+const double DEFAULT_BRAID = 0.3;
+const int TERRAIN_MAX_COST = 16;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int size = argc > 1 ? std::atoi(argv[1]) : DEFAULT_SIZE;
+    int landmarks = argc > 2 ? std::atoi(argv[2]) : DEFAULT_LANDMARKS;
+    int queries = argc > 3 ? std::atoi(argv[3]) : DEFAULT_QUERIES;
+    double braid = argc > 4 ? std::atof(argv[4]) : DEFAULT_BRAID;
+    if (size < 2 || landmarks < 1 || queries < 1) {
+        std::cerr << "Usage: alt_bench [size] [landmarks] [queries] [braid]" << std::endl;
+        return 1;
+    }
+
+    Grid grid = buildMaze(GENERATORS[1], 1, size, size);
+    std::mt19937 rng(2);
+    braidMaze(grid, rng, braid);
+    std::uniform_int_distribution<uint32_t> anyCell(0, grid.size() - 1);
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    for (int q = 0; q < queries; ++q) pairs.push_back({anyCell(rng), anyCell(rng)});
+    std::cout << size << "x" << size << " kruskal maze, braid " << braid << ", " << landmarks << " landmarks, " << queries << " queries" << std::endl;
+
+    int mismatches = 0;
+    for (int terrain = 0; terrain < 2; ++terrain) {
+        if (terrain) generateTerrain(grid, rng, 1, TERRAIN_MAX_COST);
+        std::cout << (terrain ? "terrain costs 1-16:" : "unit costs:") << std::endl;
+
+        auto start = std::chrono::steady_clock::now();
+        LandmarkIndex index(grid, landmarks);
+        std::cout << std::fixed << std::setprecision(2) << "  preprocessing " << secondsSince(start) << " s, " << index.bytesPerLandmark() / 1048576.0 << " MB per landmark, "
+                  << index.memoryBytes() / 1048576.0 << " MB total" << std::endl;
+
+        double manhattanSeconds = 0, altSeconds = 0;
+        uint64_t manhattanExpanded = 0, altExpanded = 0;
+        for (const auto& [from, to] : pairs) {
+            SolveResult plain, alt;
+            start = std::chrono::steady_clock::now();
+            solveAStarRadix(grid, from, to, plain);
+            manhattanSeconds += secondsSince(start);
+            start = std::chrono::steady_clock::now();
+            index.findPath(from, to, alt);
+            altSeconds += secondsSince(start);
+            manhattanExpanded += plain.expanded;
+            altExpanded += alt.expanded;
+            if (pathCost(grid, plain.path) != pathCost(grid, alt.path) || plain.path.empty() != alt.path.empty()) ++mismatches;
+        }
+        std::cout << std::fixed << std::setprecision(2) << "  manhattan: " << manhattanSeconds * 1000 / queries << " ms/query, "
+                  << manhattanExpanded / queries << " expanded" << std::endl;
+        std::cout << "  ALT:       " << altSeconds * 1000 / queries << " ms/query, " << altExpanded / queries << " expanded, "
+                  << static_cast<double>(manhattanExpanded) / std::max<uint64_t>(1, altExpanded) << "x fewer nodes, "
+                  << manhattanSeconds / altSeconds << "x faster" << std::defaultfloat << std::endl;
+    }
+    std::cout << (mismatches ? std::to_string(mismatches) + " cost mismatches" : std::string("ALT and Manhattan agree on every route cost")) << std::endl;
+    return mismatches ? 1 : 0;
+}
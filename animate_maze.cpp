@@ -0,0 +1,186 @@
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <optional>
+#include "maze_steps.h"
+
+// Animates any generator and then any solver from maze_steps.h, a number of steps per
+// frame. The algorithms know nothing about rendering; this loop just pulls steps.
+//   animate_maze [generator] [solver] [--size n] [--rate steps-per-frame] [--seed n] [--headless]
+// Up and down change the rate, space pauses.
+const int WINDOW_SIZE = 800;
+const int DEFAULT_SIZE = 40;
+const int MAX_RATE = 1 << 16;
+
+class Animation {
+public:
+    Animation(int size, int rate, uint32_t seed) : grid(size, size), marks(grid.size(), MARK_NONE), rng(seed), rate(rate) {
+        cellSize = std::max(1, WINDOW_SIZE / size);
+    }
+
+    // Start the next algorithm; solvers get a fresh set of marks
+    bool begin(const StepAlgorithm& algorithm) {
+        if (!algorithm.generator) std::fill(marks.begin(), marks.end(), MARK_NONE);
+        steps.emplace(algorithm.start(arena, grid, rng));
+        if (!*steps) {
+            std::cerr << "No room in the step arena for " << algorithm.name << std::endl;
+            return false;
+        }
+        steps->setBatch(std::min(rate, StepGenerator::MAX_BATCH));
+        return true;
+    }
+
+    // Pull up to count steps; false once the algorithm is done
+    bool advance(uint64_t count) {
+        for (uint64_t pulled = 0; pulled < count; pulled += steps->size()) {
+            if (!steps->next()) return false;
+            for (const Step& step : *steps) apply(step);
+        }
+        return true;
+    }
+
+    void handleKey(SDL_Keycode key) {
+        if (key == SDLK_SPACE) paused = !paused;
+        if (key == SDLK_UP) rate = std::min(MAX_RATE, rate * 2);
+        if (key == SDLK_DOWN) rate = std::max(1, rate / 2);
+        steps->setBatch(std::min(rate, StepGenerator::MAX_BATCH));
+    }
+
+    bool frame() { return paused || advance(rate); }
+
+    void draw(SDL_Renderer* renderer) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        for (int y = 0; y < grid.height; ++y) {
+            for (int x = 0; x < grid.width; ++x) {
+                uint32_t cell = grid.index(x, y);
+                int x1 = x * cellSize;
+                int y1 = y * cellSize;
+                if (marks[cell] != MARK_NONE) {
+                    if (marks[cell] & MARK_PATH) SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
+                    else SDL_SetRenderDrawColor(renderer, 40, 40, 120, 255);
+                    SDL_Rect rect = {x1, y1, cellSize, cellSize};
+                    SDL_RenderFillRect(renderer, &rect);
+                }
+                SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+                if (!grid.isOpen(cell, NORTH)) SDL_RenderDrawLine(renderer, x1, y1, x1 + cellSize, y1);
+                if (!grid.isOpen(cell, WEST)) SDL_RenderDrawLine(renderer, x1, y1, x1, y1 + cellSize);
+                if (x == grid.width - 1) SDL_RenderDrawLine(renderer, x1 + cellSize, y1, x1 + cellSize, y1 + cellSize);
+                if (y == grid.height - 1) SDL_RenderDrawLine(renderer, x1, y1 + cellSize, x1 + cellSize, y1 + cellSize);
+            }
+        }
+        Point p = grid.point(cursor);
+        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+        SDL_Rect rect = {p.x * cellSize + cellSize / 4, p.y * cellSize + cellSize / 4, std::max(1, cellSize / 2), std::max(1, cellSize / 2)};
+        SDL_RenderFillRect(renderer, &rect);
+        SDL_RenderPresent(renderer);
+    }
+
+    uint64_t stepCount() const { return taken; }
+    int stepsPerFrame() const { return rate; }
+
+private:
+    Grid grid;
+    std::vector<uint8_t> marks;
+    std::mt19937 rng;
+    StepArena arena;
+    std::optional<StepGenerator> steps;
+    int rate;
+    int cellSize;
+    bool paused = false;
+    uint32_t cursor = 0;
+    uint64_t taken = 0;
+
+    // Generators have already changed the grid; only the marks follow the steps
+    void apply(const Step& step) {
+        cursor = step.cell;
+        ++taken;
+        switch (step.event) {
+            case LOG_VISIT: marks[step.cell] |= MARK_VISITED; break;
+            case LOG_PATH: marks[step.cell] |= MARK_PATH; break;
+            case LOG_CLEAR: marks[step.cell] = MARK_NONE; break;
+            default: break;
+        }
+    }
+};
+
+int main(int argc, char* argv[]) {
+    std::string generatorName = "backtracker", solverName = "astar-heap";
+    int size = DEFAULT_SIZE, rate = 1;
+    uint32_t seed = std::random_device{}();
+    bool headless = false;
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) size = std::max(2, std::stoi(argv[++i]));
+        else if (arg == "--rate" && i + 1 < argc) rate = std::clamp(std::stoi(argv[++i]), 1, MAX_RATE);
+        else if (arg == "--seed" && i + 1 < argc) seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--headless") headless = true;
+        else if (positional++ == 0) generatorName = arg;
+        else solverName = arg;
+    }
+    const StepAlgorithm* generator = findStepAlgorithm(generatorName);
+    const StepAlgorithm* solver = findStepAlgorithm(solverName);
+    if (!generator || !generator->generator || !solver || solver->generator) {
+        std::cerr << "Usage: animate_maze [generator] [solver] [--size n] [--rate steps-per-frame] [--seed n] [--headless]\n  generators:";
+        for (const StepAlgorithm& algorithm : STEP_ALGORITHMS) {
+            if (algorithm.generator) std::cerr << " " << algorithm.name;
+        }
+        std::cerr << "\n  solvers:";
+        for (const StepAlgorithm& algorithm : STEP_ALGORITHMS) {
+            if (!algorithm.generator) std::cerr << " " << algorithm.name;
+        }
+        std::cerr << std::endl;
+        return 1;
+    }
+
+    Animation animation(size, headless ? StepGenerator::MAX_BATCH : rate, seed);
+    if (headless) {
+        // Same coroutines, drained at full speed
+        for (const StepAlgorithm* algorithm : {generator, solver}) {
+            auto start = std::chrono::steady_clock::now();
+            uint64_t before = animation.stepCount();
+            if (!animation.begin(*algorithm)) return 1;
+            while (animation.advance(UINT32_MAX)) {
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << algorithm->name << ": " << animation.stepCount() - before << " steps in " << seconds * 1000 << " ms" << std::endl;
+        }
+        return 0;
+    }
+
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    SDL_Window* window = SDL_CreateWindow("Maze Animation", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_SIZE, WINDOW_SIZE, SDL_WINDOW_SHOWN);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    if (!window || !renderer) {
+        std::cerr << "SDL Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    const StepAlgorithm* stages[] = {generator, solver};
+    int stage = 0;
+    animation.begin(*stages[stage]);
+    bool quit = false;
+    SDL_Event e;
+    while (!quit) {
+        while (SDL_PollEvent(&e) != 0) {
+            if (e.type == SDL_QUIT) quit = true;
+            else if (e.type == SDL_KEYDOWN) animation.handleKey(e.key.keysym.sym);
+        }
+        if (!animation.frame() && stage == 0) animation.begin(*stages[++stage]);
+        animation.draw(renderer);
+        std::string title = std::string("Maze Animation - ") + stages[stage]->name + " - step " + std::to_string(animation.stepCount()) + " - " +
+                            std::to_string(animation.stepsPerFrame()) + " steps/frame";
+        SDL_SetWindowTitle(window, title.c_str());
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cstdlib>
+#include <SDL2/SDL.h>
+#include "maze_archive.h"
+#include "maze_solvers.h"
+
+// Viewer for tile-compressed maze archives (maze_archive.h). Only the cells on screen are
+// read, and only the tiles under them are decoded, so a maze far larger than memory pans
+// as smoothly as a small one; tiles stay in the reader's cache while they are near.
+//   arrows / WASD   pan (a screen at a time with Page Up / Page Down)
+//   + / -           zoom
+//   space           shortest path between the visible top-left and bottom-right cells
+// Usage: archive_view <in.mza> [x y]
+const int WIDTH = 1024;
+const int HEIGHT = 768;
+const int MIN_CELL_SIZE = 2;
+const int MAX_CELL_SIZE = 32;
+const int PAN_CELLS = 8; // Cells per arrow key press
+
+class ArchiveView {
+public:
+    explicit ArchiveView(ArchiveReader& archive) : archive(archive), threads(static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))) {}
+
+    void moveTo(int x, int y) {
+        originX = std::max(0, std::min(x, archive.width() - columns()));
+        originY = std::max(0, std::min(y, archive.height() - rows()));
+        stale = true;
+    }
+
+    void pan(int dx, int dy) { moveTo(originX + dx, originY + dy); }
+
+    void zoom(int factor) {
+        int size = factor > 0 ? cellSize * 2 : cellSize / 2;
+        if (size < MIN_CELL_SIZE || size > MAX_CELL_SIZE) return;
+        // Keep the cell in the middle of the screen where it is
+        int centerX = originX + columns() / 2, centerY = originY + rows() / 2;
+        cellSize = size;
+        moveTo(centerX - columns() / 2, centerY - rows() / 2);
+    }
+
+    int columns() const { return std::min(WIDTH / cellSize, archive.width()); }
+    int rows() const { return std::min(HEIGHT / cellSize, archive.height()); }
+
+    // Re-reads the visible region when the view has moved; drops the old path
+    bool refresh() {
+        if (!stale) return true;
+        stale = false;
+        path.clear();
+        return archive.readRegion(originX, originY, columns(), rows(), region, threads);
+    }
+
+    void solve() {
+        SolveResult result;
+        if (solveBfs(region, 0, region.size() - 1, result)) path = result.path;
+        else std::cout << "Corners of the view are not connected inside it" << std::endl;
+    }
+
+    void draw(SDL_Renderer* renderer) {
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        for (int y = 0; y < region.height; ++y) {
+            for (int x = 0; x < region.width; ++x) {
+                uint32_t cell = region.index(x, y);
+                int x1 = x * cellSize, y1 = y * cellSize;
+                // East and south walls are drawn by the neighbor; only the region's edge needs them here
+                if (!region.isOpen(cell, NORTH)) SDL_RenderDrawLine(renderer, x1, y1, x1 + cellSize, y1);
+                if (!region.isOpen(cell, WEST)) SDL_RenderDrawLine(renderer, x1, y1, x1, y1 + cellSize);
+                if (x + 1 == region.width) SDL_RenderDrawLine(renderer, x1 + cellSize, y1, x1 + cellSize, y1 + cellSize);
+                if (y + 1 == region.height) SDL_RenderDrawLine(renderer, x1, y1 + cellSize, x1 + cellSize, y1 + cellSize);
+            }
+        }
+        SDL_SetRenderDrawColor(renderer, 255, 64, 64, 255);
+        for (size_t i = 1; i < path.size(); ++i) {
+            int half = cellSize / 2;
+            int x1 = static_cast<int>(path[i - 1] % region.width) * cellSize + half, y1 = static_cast<int>(path[i - 1] / region.width) * cellSize + half;
+            int x2 = static_cast<int>(path[i] % region.width) * cellSize + half, y2 = static_cast<int>(path[i] / region.width) * cellSize + half;
+            SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
+        }
+    }
+
+    std::string title() const {
+        auto stats = archive.cacheStats();
+        return "Maze archive " + std::to_string(archive.width()) + "x" + std::to_string(archive.height()) + " at " + std::to_string(originX) + "," +
+               std::to_string(originY) + ", " + std::to_string(cellSize) + " px cells, " + std::to_string(stats.misses) + " tiles decoded" +
+               (path.empty() ? "" : ", path " + std::to_string(path.size() - 1) + " steps");
+    }
+
+private:
+    ArchiveReader& archive;
+    int threads;
+    int originX = 0, originY = 0;
+    int cellSize = 8;
+    bool stale = true;
+    Grid region;
+    std::vector<uint32_t> path;
+};
+
+bool init(SDL_Window** window, SDL_Renderer** renderer) {
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        std::cout << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    *window = SDL_CreateWindow("Maze archive", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WIDTH, HEIGHT, SDL_WINDOW_SHOWN);
+    if (*window == nullptr) {
+        std::cout << "SDL_CreateWindow Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    *renderer = SDL_CreateRenderer(*window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    if (*renderer == nullptr) {
+        std::cout << "SDL_CreateRenderer Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2 && argc != 4) {
+        std::cerr << "Usage: archive_view <in.mza> [x y]" << std::endl;
+        return 1;
+    }
+    ArchiveReader archive;
+    if (!archive.open(argv[1])) {
+        std::cerr << "Cannot read archive: " << argv[1] << std::endl;
+        return 1;
+    }
+    ArchiveView view(archive);
+    if (argc == 4) view.moveTo(std::atoi(argv[2]), std::atoi(argv[3]));
+    else view.moveTo(0, 0);
+    if (!view.refresh()) {
+        std::cerr << "Cannot read archive region" << std::endl;
+        return 1;
+    }
+
+    SDL_Window* window = nullptr;
+    SDL_Renderer* renderer = nullptr;
+
+    if (!init(&window, &renderer)) {
+        return 1;
+    }
+
+    bool quit = false;
+    SDL_Event e;
+
+    while (!quit) {
+        while (SDL_PollEvent(&e) != 0) {
+            if (e.type == SDL_QUIT) {
+                quit = true;
+            } else if (e.type == SDL_KEYDOWN) {
+                switch (e.key.keysym.sym) {
+                    case SDLK_ESCAPE: quit = true; break;
+                    case SDLK_LEFT: case SDLK_a: view.pan(-PAN_CELLS, 0); break;
+                    case SDLK_RIGHT: case SDLK_d: view.pan(PAN_CELLS, 0); break;
+                    case SDLK_UP: case SDLK_w: view.pan(0, -PAN_CELLS); break;
+                    case SDLK_DOWN: case SDLK_s: view.pan(0, PAN_CELLS); break;
+                    case SDLK_PAGEUP: view.pan(0, -view.rows()); break;
+                    case SDLK_PAGEDOWN: view.pan(0, view.rows()); break;
+                    case SDLK_PLUS: case SDLK_EQUALS: view.zoom(1); break;
+                    case SDLK_MINUS: view.zoom(-1); break;
+                    case SDLK_SPACE: view.solve(); break;
+                    default: break;
+                }
+            }
+        }
+
+        if (!view.refresh()) {
+            std::cerr << "Cannot read archive region" << std::endl;
+            break;
+        }
+        SDL_SetWindowTitle(window, view.title().c_str());
+
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+
+        view.draw(renderer);
+
+        SDL_RenderPresent(renderer);
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+
+    return 0;
+}
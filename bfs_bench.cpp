@@ -0,0 +1,86 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include "maze_generators.h"
+#include "parallel_bfs.h"
+
+// Benchmark: whole-maze distances from one corner, serial BFS against the parallel
+// direction-optimizing BFS at 1, 2, 4, ... threads. Throughput is in millions of
+// traversed edges per second (each passage counted once).
+// Usage: bfs_bench [size] [algorithm] [braid] [maxThreads] [--trace file]
+const int DEFAULT_SIZE = 16384;
+const double DEFAULT_BRAID = 0.5;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Reference: one queue, one thread
+void serialDistances(const Grid& grid, uint32_t source, std::vector<uint32_t>& distance) {
+    distance.assign(grid.size(), ParallelBfs::UNREACHED);
+    std::vector<uint32_t> queue;
+    queue.reserve(grid.size());
+    queue.push_back(source);
+    distance[source] = 0;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t cell = queue[head];
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next) && distance[next] == ParallelBfs::UNREACHED) {
+                distance[next] = distance[cell] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    startTraceFromArgs(argc, argv);
+    int size = argc > 1 ? std::atoi(argv[1]) : DEFAULT_SIZE;
+    std::string algorithm = argc > 2 ? argv[2] : "prim";
+    double braid = argc > 3 ? std::atof(argv[3]) : DEFAULT_BRAID;
+    int maxThreads = argc > 4 ? std::atoi(argv[4]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const GeneratorInfo* generator = findGenerator(algorithm);
+    if (size < 2 || !generator || maxThreads < 1) {
+        std::cerr << "Usage: bfs_bench [size] [algorithm] [braid] [maxThreads] [--trace file]" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Grid grid = buildMaze(*generator, 1, size, size);
+    std::mt19937 rng(2);
+    if (braid > 0) braidMaze(grid, rng, braid);
+    uint64_t passages = 0;
+    for (uint8_t cell : grid.cells) passages += ((cell & EAST) ? 1 : 0) + ((cell & SOUTH) ? 1 : 0);
+    std::cout << size << "x" << size << " " << algorithm << " maze, braid " << braid << ", " << passages << " passages: " << secondsSince(start)
+              << " s" << std::endl;
+
+    std::vector<uint32_t> reference;
+    start = std::chrono::steady_clock::now();
+    serialDistances(grid, 0, reference);
+    double serialSeconds = secondsSince(start);
+    std::cout << "serial:     " << serialSeconds << " s, " << passages / serialSeconds / 1e6 << " MTEPS" << std::endl;
+
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    int mismatches = 0;
+    for (int threads : threadCounts) {
+        ParallelBfs bfs(grid, threads);
+        start = std::chrono::steady_clock::now();
+        const std::vector<uint32_t>& distance = bfs.run(0);
+        double seconds = secondsSince(start);
+        bool same = distance == reference;
+        if (!same) ++mismatches;
+        std::cout << threads << " threads: " << seconds << " s, " << passages / seconds / 1e6 << " MTEPS, " << serialSeconds / seconds << "x serial, "
+                  << bfs.levels() << " levels (" << bfs.topDown() << " top-down, " << bfs.bottomUp() << " bottom-up), "
+                  << bfs.edgesExamined() << " edges examined" << (same ? "" : ", DISTANCES DIFFER") << std::endl;
+    }
+    MAZE_TRACE_STOP();
+    return mismatches ? 1 : 0;
+}
@@ -1,9 +1,14 @@
 #include <iostream>
+#include <string>
 #include <vector>
+#include <random>
 #include <SDL2/SDL.h>
 #include <ctime>
-#include <cstdlib>
+#include "maze_generators.h"
 
+// Uniform spanning tree mazes: Aldous-Broder by default, or "wilson" / "hybrid" as the
+// first argument. Every perfect maze of the grid is equally likely, so unlike the
+// backtracker there is no long river and no bias towards any direction.
 const int WIDTH = 800;
 const int HEIGHT = 600;
 const int ROWS = 30;
@@ -12,56 +17,32 @@ const int CELL_SIZE = 20;
 
 class Maze {
 public:
-    Maze(int rows, int cols) : rows(rows), cols(cols) {
-        maze.resize(rows, std::vector<int>(cols, 1));
-        visited.resize(rows, std::vector<bool>(cols, false));
-    }
-
-    void generate(int startX, int startY) {
-        std::vector<std::pair<int, int>> directions = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
-        std::pair<int, int> current = {startX, startY};
-        visited[startY][startX] = true;
-        maze[startY][startX] = 0;
-
-        while (true) {
-            std::random_shuffle(directions.begin(), directions.end());
-            bool moved = false;
-
-            for (auto dir : directions) {
-                int nx = current.first + dir.first;
-                int ny = current.second + dir.second;
-
-                if (nx >= 0 && ny >= 0 && nx < cols && ny < rows && !visited[ny][nx]) {
-                    maze[ny][nx] = 0;
-                    visited[ny][nx] = true;
-                    current = {nx, ny};
-                    moved = true;
-                    break;
-                }
-            }
-
-            if (!moved) {
-                break;
-            }
-        }
+    Maze(int rows, int cols) : grid(cols, rows) {}
+
+    bool generate(const std::string& algorithm, uint32_t seed) {
+        const GeneratorInfo* generator = findGenerator(algorithm);
+        if (!generator) return false;
+        std::mt19937 rng(seed);
+        generator->generate(grid, rng);
+        return true;
     }
 
     void draw(SDL_Renderer* renderer) {
-        for (int y = 0; y < rows; ++y) {
-            for (int x = 0; x < cols; ++x) {
-                if (maze[y][x] == 1) {
-                    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-                    SDL_Rect rect = {x * CELL_SIZE, y * CELL_SIZE, CELL_SIZE, CELL_SIZE};
-                    SDL_RenderFillRect(renderer, &rect);
-                }
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        for (int y = 0; y < grid.height; ++y) {
+            for (int x = 0; x < grid.width; ++x) {
+                uint32_t cell = grid.index(x, y);
+                int x1 = x * CELL_SIZE, y1 = y * CELL_SIZE;
+                if (!grid.isOpen(cell, NORTH)) SDL_RenderDrawLine(renderer, x1, y1, x1 + CELL_SIZE, y1);
+                if (!grid.isOpen(cell, WEST)) SDL_RenderDrawLine(renderer, x1, y1, x1, y1 + CELL_SIZE);
+                if (!grid.isOpen(cell, EAST)) SDL_RenderDrawLine(renderer, x1 + CELL_SIZE, y1, x1 + CELL_SIZE, y1 + CELL_SIZE);
+                if (!grid.isOpen(cell, SOUTH)) SDL_RenderDrawLine(renderer, x1, y1 + CELL_SIZE, x1 + CELL_SIZE, y1 + CELL_SIZE);
             }
         }
     }
 
 private:
-    int rows, cols;
-    std::vector<std::vector<int>> maze;
-    std::vector<std::vector<bool>> visited;
+    Grid grid;
 };
 
 bool init(SDL_Window** window, SDL_Renderer** renderer) {
@@ -85,8 +66,13 @@ bool init(SDL_Window** window, SDL_Renderer** renderer) {
     return true;
 }
 
-int main() {
-    srand(time(0));
+int main(int argc, char* argv[]) {
+    std::string algorithm = argc > 1 ? argv[1] : "aldous-broder";
+    Maze maze(ROWS, COLS);
+    if (!maze.generate(algorithm, static_cast<uint32_t>(time(0)))) {
+        std::cout << "Unknown algorithm: " << algorithm << " (try aldous-broder, wilson or hybrid)" << std::endl;
+        return 1;
+    }
 
     SDL_Window* window = nullptr;
     SDL_Renderer* renderer = nullptr;
@@ -95,9 +81,6 @@ int main() {
         return 1;
     }
 
-    Maze maze(ROWS, COLS);
-    maze.generate(0, 0);
-
     bool quit = false;
     SDL_Event e;
 
@@ -0,0 +1,101 @@
+#ifndef CHUNK_WORLD_H
+#define CHUNK_WORLD_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include "lru_cache.h"
+#include "maze_generators.h"
+
+// Unbounded maze made of square chunks generated on demand.
+//
+// Each chunk is a perfect maze seeded from (world seed, chunk coordinates), so it can be
+// thrown away and regenerated identically at any time. The edge shared by two chunks gets
+// its openings from a hash of the world seed and that edge alone, so both sides agree on
+// them without either neighbour being generated. Every chunk is internally connected and
+// every edge has at least one opening, which keeps the whole world connected.
+struct ChunkKey {
+    int64_t cx, cy;
+
+    bool operator==(const ChunkKey& other) const {
+        return cx == other.cx && cy == other.cy;
+    }
+};
+
+struct ChunkKeyHash {
+    size_t operator()(const ChunkKey& key) const {
+        return static_cast<size_t>(mixBits(static_cast<uint64_t>(key.cx) * 0x100000001B3ull ^ static_cast<uint64_t>(key.cy)));
+    }
+};
+
+class ChunkWorld {
+public:
+    static const int OPENINGS_PER_EDGE = 2;
+
+    ChunkWorld(uint64_t seed, size_t cacheBytes, int chunkSize = 32) : seed(seed), chunkSize(chunkSize), cache(cacheBytes) {}
+
+    int size() const { return chunkSize; }
+
+    // Chunk holding world cell (x, y)
+    ChunkKey chunkOf(int64_t x, int64_t y) const {
+        return {floorDiv(x), floorDiv(y)};
+    }
+
+    // The chunk, from the cache or freshly generated
+    std::shared_ptr<const Grid> chunk(const ChunkKey& key) {
+        std::shared_ptr<const Grid> grid = cache.get(key);
+        if (grid) return grid;
+        ++generated;
+        auto fresh = std::make_shared<Grid>(generate(key));
+        cache.put(key, fresh, sizeof(Grid) + fresh->cells.size());
+        return fresh;
+    }
+
+    // Passage bits of a world cell; border bits lead into the neighbouring chunk
+    uint8_t cell(int64_t x, int64_t y) {
+        ChunkKey key = chunkOf(x, y);
+        std::shared_ptr<const Grid> grid = chunk(key);
+        return grid->cells[grid->index(static_cast<int>(x - key.cx * chunkSize), static_cast<int>(y - key.cy * chunkSize))];
+    }
+
+    size_t chunksGenerated() const { return generated; }
+    LruCache<ChunkKey, Grid, ChunkKeyHash>::Stats cacheStats() { return cache.stats(); }
+
+private:
+    uint64_t seed;
+    int chunkSize;
+    LruCache<ChunkKey, Grid, ChunkKeyHash> cache;
+    std::atomic<size_t> generated{0};
+
+    int64_t floorDiv(int64_t v) const {
+        return v >= 0 ? v / chunkSize : -((-v + chunkSize - 1) / chunkSize);
+    }
+
+    // Offset of the i-th opening along an edge; vertical edges are keyed by the chunk to
+    // their west, horizontal edges by the chunk to their north
+    int opening(int64_t cx, int64_t cy, bool vertical, int i) const {
+        uint64_t h = mixBits(seed ^ mixBits(static_cast<uint64_t>(cx) ^ mixBits(static_cast<uint64_t>(cy) * 2 + (vertical ? 1 : 0))));
+        return static_cast<int>(mixBits(h + i) % static_cast<uint64_t>(chunkSize));
+    }
+
+    Grid generate(const ChunkKey& key) const {
+        Grid grid(chunkSize, chunkSize);
+        uint64_t chunkSeed = mixBits(seed ^ mixBits(static_cast<uint64_t>(key.cx) ^ mixBits(static_cast<uint64_t>(key.cy))));
+        std::seed_seq sequence = {static_cast<uint32_t>(chunkSeed), static_cast<uint32_t>(chunkSeed >> 32)};
+        std::mt19937 rng(sequence);
+        generateBacktracker(grid, rng);
+
+        int last = chunkSize - 1;
+        for (int i = 0; i < OPENINGS_PER_EDGE; ++i) {
+            grid.cells[grid.index(last, opening(key.cx, key.cy, true, i))] |= EAST;
+            grid.cells[grid.index(0, opening(key.cx - 1, key.cy, true, i))] |= WEST;
+            grid.cells[grid.index(opening(key.cx, key.cy, false, i), last)] |= SOUTH;
+            grid.cells[grid.index(opening(key.cx, key.cy - 1, false, i), 0)] |= NORTH;
+        }
+        return grid;
+    }
+};
+
+#endif
@@ -0,0 +1,115 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include "maze_generators.h"
+#include "maze_solvers.h"
+#include "maze_steps.h"
+#include "maze_verifier.h"
+
+// Benchmark: headless cost of the coroutine step generators against the plain loops,
+// resuming once per step and once per batch of StepGenerator::MAX_BATCH steps. Each
+// coroutine generator must carve a perfect maze, exactly the one its plain loop carves,
+// and each coroutine solver must find exactly the path of its plain solver.
+// Usage: coro_bench [size] [repeats]
+const int DEFAULT_SIZE = 1024;
+const int DEFAULT_REPEATS = 3;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Run a step generator to completion; returns the number of steps
+uint64_t drain(const StepAlgorithm& algorithm, StepArena& arena, Grid& grid, uint64_t seed, int batch) {
+    std::mt19937 rng(static_cast<uint32_t>(seed));
+    StepGenerator steps = algorithm.start(arena, grid, rng);
+    steps.setBatch(batch);
+    uint64_t count = 0;
+    while (steps.next()) count += steps.size();
+    return count;
+}
+
+// The LOG_PATH cells a solver yields, from start to goal
+std::vector<uint32_t> pathSteps(const StepAlgorithm& algorithm, StepArena& arena, Grid& grid) {
+    std::mt19937 rng(1);
+    StepGenerator steps = algorithm.start(arena, grid, rng);
+    steps.setBatch(StepGenerator::MAX_BATCH);
+    std::vector<uint32_t> path;
+    while (steps.next()) {
+        for (const Step& step : steps) {
+            if (step.event == LOG_PATH) path.push_back(step.cell);
+        }
+    }
+    if (!path.empty() && path.front() != 0) std::reverse(path.begin(), path.end());
+    return path;
+}
+
+int main(int argc, char* argv[]) {
+    int size = argc > 1 ? std::atoi(argv[1]) : DEFAULT_SIZE;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : DEFAULT_REPEATS;
+    if (size < 2 || repeats < 1) {
+        std::cerr << "Usage: coro_bench [size] [repeats]" << std::endl;
+        return 1;
+    }
+
+    StepArena arena;
+    int failures = 0;
+    std::cout << size << "x" << size << ", best of " << repeats << std::endl;
+    std::cout << std::left << std::setw(14) << "algorithm" << std::right << std::setw(12) << "plain ms" << std::setw(14) << "batch 1 ms"
+              << std::setw(14) << "batch " + std::to_string(StepGenerator::MAX_BATCH) + " ms" << std::setw(12) << "ns/step" << std::endl;
+    for (const StepAlgorithm& algorithm : STEP_ALGORITHMS) {
+        const GeneratorInfo* plain = algorithm.generator ? findGenerator(algorithm.name) : nullptr;
+        const SolverInfo* solver = algorithm.generator ? nullptr : findSolver(algorithm.name);
+        Grid maze = buildMaze(GENERATORS[0], 1, size, size); // What the solvers run on
+        if (solver) {
+            SolveResult result;
+            solver->solve(maze, 0, maze.size() - 1, result);
+            if (pathSteps(algorithm, arena, maze) != result.path) {
+                std::cout << "FAIL " << algorithm.name << ": coroutine path differs from the plain solver" << std::endl;
+                ++failures;
+            }
+        }
+
+        double best[3] = {1e30, 1e30, 1e30};
+        uint64_t steps = 0;
+        for (int r = 0; r < repeats; ++r) {
+            // Plain loop, where there is one
+            Grid reference = algorithm.generator ? Grid(size, size) : maze;
+            auto start = std::chrono::steady_clock::now();
+            if (plain) {
+                std::mt19937 rng(1);
+                plain->generate(reference, rng);
+            } else if (solver) {
+                SolveResult result;
+                solver->solve(reference, 0, reference.size() - 1, result);
+            }
+            if (plain || solver) best[0] = std::min(best[0], secondsSince(start));
+
+            for (int mode = 1; mode <= 2; ++mode) {
+                Grid grid = algorithm.generator ? Grid(size, size) : maze;
+                start = std::chrono::steady_clock::now();
+                steps = drain(algorithm, arena, grid, 1, mode == 1 ? 1 : StepGenerator::MAX_BATCH);
+                best[mode] = std::min(best[mode], secondsSince(start));
+                if (plain && grid.cells != reference.cells) {
+                    std::cout << "FAIL " << algorithm.name << ": coroutine maze differs from the plain loop" << std::endl;
+                    ++failures;
+                } else if (algorithm.generator && !verifyGrid(grid).perfect()) {
+                    std::cout << "FAIL " << algorithm.name << ": maze is not perfect" << std::endl;
+                    ++failures;
+                }
+            }
+        }
+
+        std::cout << std::left << std::setw(14) << algorithm.name << std::right << std::fixed << std::setprecision(2) << std::setw(12);
+        if (plain || solver) std::cout << best[0] * 1000;
+        else std::cout << "-";
+        std::cout << std::setw(14) << best[1] * 1000 << std::setw(14) << best[2] * 1000 << std::setw(12) << best[2] * 1e9 / std::max<uint64_t>(1, steps)
+                  << "   " << steps << " steps" << std::defaultfloat << std::endl;
+    }
+    std::cout << "arena " << arena.bytesUsed() << " bytes in use after the run, no frame allocations on the heap" << std::endl;
+    return failures ? 1 : 0;
+}
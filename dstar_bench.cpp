@@ -0,0 +1,116 @@
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include "maze_generators.h"
+#include "maze_dstar.h"
+
+// Benchmark: D* Lite replanning after single wall flips, against a full re-solve.
+// Usage: dstar_bench [size] [flips] [braid]
+const int DEFAULT_SIZE = 4000;
+const int DEFAULT_FLIPS = 1000;
+const double DEFAULT_BRAID = 0.5;
+const int VERIFY_EVERY = 100; // Check the repaired distance against a full BFS this often
+const int STEPS_PER_FLIP = 4; // The agent walks a few cells between wall flips
+const int MAX_ATTEMPTS_PER_FLIP = 4; // Give up when most flips would cut the goal off
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Reference distance by breadth-first search
+uint32_t bfsDistance(const Grid& grid, uint32_t start, uint32_t goal) {
+    std::vector<uint32_t> dist(grid.size(), DStarLite::INF);
+    std::vector<uint32_t> queue = {start};
+    dist[start] = 0;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t cell = queue[head];
+        if (cell == goal) break;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next) && dist[next] == DStarLite::INF) {
+                dist[next] = dist[cell] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+    return dist[goal];
+}
+
+int main(int argc, char* argv[]) {
+    int size = argc > 1 ? std::atoi(argv[1]) : DEFAULT_SIZE;
+    int flips = argc > 2 ? std::atoi(argv[2]) : DEFAULT_FLIPS;
+    double braid = argc > 3 ? std::atof(argv[3]) : DEFAULT_BRAID;
+    if (size < 2 || flips < 1) {
+        std::cerr << "Usage: dstar_bench [size] [flips] [braid]" << std::endl;
+        return 1;
+    }
+
+    Grid grid = buildMaze(GENERATORS[0], 1, size, size);
+    std::mt19937 rng(3);
+    braidMaze(grid, rng, braid);
+    uint32_t start = 0, goal = grid.size() - 1;
+
+    auto begin = std::chrono::steady_clock::now();
+    DStarLite planner(grid, start, goal);
+    planner.computePath();
+    double initial = secondsSince(begin);
+    std::cout << size << "x" << size << " maze, braid " << braid << ": initial plan " << initial * 1000 << " ms, "
+              << planner.cellsExpanded() << " cells expanded, distance " << planner.distance() << std::endl;
+
+    begin = std::chrono::steady_clock::now();
+    uint32_t reference = bfsDistance(grid, start, goal);
+    double fullSolve = secondsSince(begin);
+
+    // Flip walls near the agent's route so most flips actually matter, then walk on. A flip
+    // that leaves no route to the goal is undone and not counted.
+    std::vector<double> micros;
+    std::vector<size_t> touched;
+    int mismatches = 0, reverted = 0;
+    std::uniform_int_distribution<int> offset(-16, 16);
+    std::uniform_int_distribution<int> anyDirection(0, 3);
+    for (int attempt = 0; static_cast<int>(micros.size()) < flips && attempt < flips * MAX_ATTEMPTS_PER_FLIP; ++attempt) {
+        std::vector<uint32_t> route = planner.path();
+        Point p = grid.point(route.empty() ? start : route[std::min<size_t>(route.size() - 1, 1 + rng() % 256)]);
+        int x = std::clamp(p.x + offset(rng), 0, size - 1), y = std::clamp(p.y + offset(rng), 0, size - 1);
+        uint32_t cell = grid.index(x, y);
+        Direction dir = DIRECTIONS[anyDirection(rng)];
+
+        begin = std::chrono::steady_clock::now();
+        bool open = !grid.isOpen(cell, dir);
+        planner.setPassage(cell, dir, open);
+        planner.computePath();
+        double elapsed = secondsSince(begin) * 1e6;
+        if (planner.distance() == DStarLite::INF) {
+            planner.setPassage(cell, dir, !open);
+            planner.computePath();
+            ++reverted;
+            continue;
+        }
+        micros.push_back(elapsed);
+        touched.push_back(planner.cellsExpanded());
+
+        if (micros.size() % VERIFY_EVERY == 1 && planner.distance() != bfsDistance(grid, start, goal)) ++mismatches;
+        for (int s = 0; s < STEPS_PER_FLIP && start != goal; ++s) {
+            uint32_t next = planner.nextStep(start);
+            if (next == start) break;
+            start = next;
+        }
+        planner.moveStart(start);
+    }
+    if (micros.empty()) {
+        std::cerr << "No flip left a route to the goal (" << reverted << " undone)" << std::endl;
+        return 1;
+    }
+
+    std::sort(micros.begin(), micros.end());
+    std::sort(touched.begin(), touched.end());
+    auto at = [](const auto& values, double p) { return values[static_cast<size_t>(p * (values.size() - 1))]; };
+    std::cout << "full BFS solve: " << fullSolve * 1000 << " ms (distance " << reference << ")" << std::endl;
+    std::cout << micros.size() << " of " << flips << " wall flips applied (" << reverted << " undone for cutting off the goal): replan p50 " << at(micros, 0.5) << " us, p99 " << at(micros, 0.99) << " us; cells expanded p50 "
+              << at(touched, 0.5) << ", p99 " << at(touched, 0.99) << " of " << grid.size() << "; " << mismatches << " mismatches" << std::endl;
+    return mismatches || static_cast<int>(micros.size()) < flips ? 1 : 0;
+}
@@ -0,0 +1,142 @@
+#ifndef ELLER_STREAM_H
+#define ELLER_STREAM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "maze_grid.h"
+
+// Eller's algorithm as a row stream. Only the current row is kept: a set label per column,
+// a union-find over the labels, and the south passages of the row above. Each call to
+// nextRow carves one row and hands it back with all four passage bits set, so the rows can
+// go straight to a file, a pipe or a renderer. Memory is O(width) however many rows are
+// produced.
+//
+// Labels are renumbered after every row in order of first appearance, so they stay below
+// the width and the union-find never grows; cells that start a new set take the next free
+// labels. Merges are union-find links rather than relabelling the row, so a row costs
+// O(width) even when every cell ends up in one set.
+class EllerStream {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    EllerStream(int width, std::mt19937& rng)
+        : width(width), rng(rng), label(width, NONE), parent(width), remaining(width), renamed(width, NONE), wentDown(width), southAbove(width), cells(width) {}
+
+    // Carves the next row and returns its cells. The last row joins every set still apart
+    // and has no passages south; the stream can go on after it, starting a new maze.
+    const std::vector<uint8_t>& nextRow(bool lastRow = false) {
+        for (int x = 0; x < width; ++x) {
+            if (label[x] == NONE) label[x] = fresh++;
+            cells[x] = southAbove[x] ? NORTH : 0;
+        }
+        uint32_t labels = fresh;
+        for (uint32_t id = 0; id < labels; ++id) parent[id] = id;
+
+        // Join neighbours in different sets, all of them on the last row. The coin flips are
+        // random, so the loops below avoid branching on them.
+        for (int x = 0; x + 1 < width; ++x) {
+            uint32_t a = find(label[x]), b = find(label[x + 1]);
+            bool join = (a != b) & (coin() | lastRow);
+            parent[b] = join ? a : b;
+            cells[x] |= join ? EAST : 0;
+            cells[x + 1] |= join ? WEST : 0;
+        }
+        ++rows;
+        if (lastRow) {
+            std::fill(label.begin(), label.end(), NONE);
+            std::fill(southAbove.begin(), southAbove.end(), 0);
+            fresh = 0;
+            return cells;
+        }
+
+        // Every set sends at least one passage south: a coin flip per cell, forced on the
+        // last cell of a set that has none yet
+        for (uint32_t id = 0; id < labels; ++id) {
+            remaining[id] = 0;
+            wentDown[id] = 0;
+            renamed[id] = NONE;
+        }
+        for (int x = 0; x < width; ++x) {
+            label[x] = find(label[x]);
+            ++remaining[label[x]];
+        }
+        fresh = 0;
+        for (int x = 0; x < width; ++x) {
+            uint32_t set = label[x];
+            bool lastOfSet = --remaining[set] == 0;
+            bool down = coin() | (lastOfSet & !wentDown[set]);
+            wentDown[set] |= down;
+            southAbove[x] = down;
+            cells[x] |= down ? SOUTH : 0;
+            bool first = down & (renamed[set] == NONE);
+            renamed[set] = first ? fresh : renamed[set];
+            fresh += first;
+            label[x] = down ? renamed[set] : NONE;
+        }
+        return cells;
+    }
+
+    int rowWidth() const { return width; }
+    uint64_t rowsDone() const { return rows; }
+    size_t memoryBytes() const {
+        return (label.size() + parent.size() + remaining.size() + renamed.size()) * sizeof(uint32_t) + wentDown.size() + southAbove.size() + cells.size();
+    }
+
+private:
+    int width;
+    std::mt19937& rng;
+    uint32_t bits = 0;
+    int bitsLeft = 0;
+    uint32_t fresh = 0;
+    uint64_t rows = 0;
+    std::vector<uint32_t> label;     // Set of each column, NONE for a cell not yet in one
+    std::vector<uint32_t> parent;    // Union-find over this row's labels
+    std::vector<uint32_t> remaining; // Cells of each set not yet given their coin flip
+    std::vector<uint32_t> renamed;   // Label each set carries into the next row
+    std::vector<uint8_t> wentDown;
+    std::vector<uint8_t> southAbove;
+    std::vector<uint8_t> cells;
+
+    // One random bit, 32 per draw
+    bool coin() {
+        if (bitsLeft == 0) {
+            bits = rng();
+            bitsLeft = 32;
+        }
+        bool bit = bits & 1;
+        bits >>= 1;
+        --bitsLeft;
+        return bit;
+    }
+
+    uint32_t find(uint32_t id) {
+        while (parent[id] != id) {
+            parent[id] = parent[parent[id]];
+            id = parent[id];
+        }
+        return id;
+    }
+};
+
+// Streams a width x height maze to sink(row, y), which returns false to stop early. A height
+// of 0 streams rows until the sink stops, without ever closing the maze. Returns the number
+// of rows produced.
+template <typename Sink>
+uint64_t streamEller(int width, uint64_t height, std::mt19937& rng, Sink&& sink) {
+    EllerStream stream(width, rng);
+    for (uint64_t y = 0; height == 0 || y < height; ++y) {
+        if (!sink(stream.nextRow(y + 1 == height).data(), y)) return y + 1;
+    }
+    return height;
+}
+
+inline void generateEller(Grid& grid, std::mt19937& rng) {
+    streamEller(grid.width, grid.height, rng, [&](const uint8_t* row, uint64_t y) {
+        std::copy(row, row + grid.width, grid.cells.begin() + grid.index(0, static_cast<int>(y)));
+        return true;
+    });
+}
+
+#endif
@@ -1,61 +1,84 @@
 #include <iostream>
+#include <string>
+#include <deque>
 #include <vector>
+#include <random>
+#include <chrono>
 #include <SDL2/SDL.h>
 #include <ctime>
 #include <cstdlib>
+#include "eller_stream.h"
+#include "maze_io.h"
 
+// Eller's algorithm from eller_stream.h. With no arguments the window shows an endless
+// maze scrolling upwards, one new row at a time. With --out the maze is written as a maze
+// file ("-" for standard output) without ever being held in memory:
+//   ellers_maze --out maze.bin --width 1000000 --height 100000 [--seed n] [--bits 2|4]
 const int WIDTH = 800;
 const int HEIGHT = 600;
 const int ROWS = 30;
-const int COLS = 30;
+const int COLS = 40;
 const int CELL_SIZE = 20;
+const int FRAMES_PER_ROW = 6;
 
 class Maze {
 public:
-    Maze(int rows, int cols) : rows(rows), cols(cols) {
-        maze.resize(rows, std::vector<int>(cols, 1));
-        set.resize(rows, std::vector<int>(cols, -1));
+    Maze(int rows, int cols, uint32_t seed) : rows(rows), rng(seed), stream(cols, rng) {
+        while (static_cast<int>(visible.size()) < rows) addRow();
     }
 
-    void generate() {
-        for (int row = 0; row < rows; ++row) {
-            if (row != 0) {
-                // Remove horizontal walls between sets
-                for (int col = 0; col < cols - 1; ++col) {
-                    if (set[row][col] != set[row][col + 1]) {
-                        maze[row][col] = 0;
-                        set[row][col + 1] = set[row][col];
-                    }
-                }
-            }
-
-            // Randomly remove vertical walls
-            for (int col = 0; col < cols; ++col) {
-                if (rand() % 2 == 0 && col < cols - 1) {
-                    maze[row][col] = 0;
-                }
-            }
-        }
+    // Scroll one row: the top row goes, a freshly carved one comes in at the bottom
+    void addRow() {
+        visible.push_back(stream.nextRow());
+        if (static_cast<int>(visible.size()) > rows) visible.pop_front();
     }
 
     void draw(SDL_Renderer* renderer) {
-        for (int y = 0; y < rows; ++y) {
-            for (int x = 0; x < cols; ++x) {
-                if (maze[y][x] == 1) {
-                    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-                    SDL_Rect rect = {x * CELL_SIZE, y * CELL_SIZE, CELL_SIZE, CELL_SIZE};
-                    SDL_RenderFillRect(renderer, &rect);
-                }
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        for (int y = 0; y < static_cast<int>(visible.size()); ++y) {
+            const std::vector<uint8_t>& row = visible[y];
+            for (int x = 0; x < static_cast<int>(row.size()); ++x) {
+                int x1 = x * CELL_SIZE, y1 = y * CELL_SIZE;
+                if (!(row[x] & NORTH)) SDL_RenderDrawLine(renderer, x1, y1, x1 + CELL_SIZE, y1);
+                if (!(row[x] & WEST)) SDL_RenderDrawLine(renderer, x1, y1, x1, y1 + CELL_SIZE);
+                if (!(row[x] & EAST)) SDL_RenderDrawLine(renderer, x1 + CELL_SIZE, y1, x1 + CELL_SIZE, y1 + CELL_SIZE);
             }
         }
     }
 
 private:
-    int rows, cols;
-    std::vector<std::vector<int>> maze;
-    std::vector<std::vector<int>> set;
+    int rows;
+    std::mt19937 rng;
+    EllerStream stream;
+    std::deque<std::vector<uint8_t>> visible;
 };
 
+// Function to stream a maze straight to a maze file, reporting throughput on stderr so
+// standard output stays free for the maze itself
+int writeMaze(const std::string& path, int width, int height, uint32_t seed, int bits) {
+    MazeFileWriter writer;
+    if (!writer.open(path, width, height, bits)) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return 1;
+    }
+    std::mt19937 rng(seed);
+    auto start = std::chrono::steady_clock::now();
+    EllerStream stream(width, rng);
+    bool ok = true;
+    uint64_t rows = 0;
+    while (ok && rows < static_cast<uint64_t>(height)) {
+        ok = writer.writeRow(stream.nextRow(rows + 1 == static_cast<uint64_t>(height)).data());
+        ++rows;
+    }
+    ok = writer.close() && ok;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double cells = static_cast<double>(width) * rows;
+    std::cerr << width << "x" << rows << " maze: " << seconds << " s, " << cells / seconds / 1e6 << " Mcells/s, "
+              << cells * bits / 8 / seconds / 1e6 << " MB/s, " << stream.memoryBytes() / 1024 << " KB of row state"
+              << (ok ? "" : ", WRITE FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
+
 bool init(SDL_Window** window, SDL_Renderer** renderer) {
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         std::cout << "SDL_Init Error: " << SDL_GetError() << std::endl;
@@ -77,8 +100,27 @@ bool init(SDL_Window** window, SDL_Renderer** renderer) {
     return true;
 }
 
-int main() {
-    srand(time(0));
+int main(int argc, char* argv[]) {
+    std::string out;
+    int width = COLS, height = ROWS, bits = 2;
+    uint32_t seed = static_cast<uint32_t>(time(0));
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "--out") out = argv[i + 1];
+        else if (option == "--width") width = std::atoi(argv[i + 1]);
+        else if (option == "--height") height = std::atoi(argv[i + 1]);
+        else if (option == "--seed") seed = static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        else if (option == "--bits") bits = std::atoi(argv[i + 1]);
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+    if (argc % 2 == 0 || width < 1 || height < 1) {
+        std::cerr << "Usage: ellers_maze [--out path|-] [--width n] [--height n] [--seed n] [--bits 2|4]" << std::endl;
+        return 1;
+    }
+    if (!out.empty()) return writeMaze(out, width, height, seed, bits);
 
     SDL_Window* window = nullptr;
     SDL_Renderer* renderer = nullptr;
@@ -87,18 +129,18 @@ int main() {
         return 1;
     }
 
-    Maze maze(ROWS, COLS);
-    maze.generate();
+    Maze maze(ROWS, COLS, seed);
 
     bool quit = false;
     SDL_Event e;
 
-    while (!quit) {
+    for (int frame = 1; !quit; ++frame) {
         while (SDL_PollEvent(&e) != 0) {
             if (e.type == SDL_QUIT) {
                 quit = true;
             }
         }
+        if (frame % FRAMES_PER_ROW == 0) maze.addRow();
 
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
         SDL_RenderClear(renderer);
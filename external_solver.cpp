@@ -0,0 +1,120 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include "external_solver.h"
+#include "maze_solvers.h"
+#include "maze_trace.h"
+
+// Solves a tile archive (maze_archive.h) with the out-of-core BFS of external_solver.h,
+// keeping the solver within a memory budget however big the maze is, and reports the I/O
+// it took. By default the path runs from the top-left to the bottom-right cell.
+// Usage: external_solver <in.mza> [--memory MB] [--scratch prefix] [--from x y] [--to x y]
+//                        [--path out.mzp] [--check] [--trace file]
+// --path writes the path as a packed path file (maze_path.h). --check also solves the
+// whole maze in memory with solveBfs, compares the lengths and walks the path file; only
+// for mazes that fit. --trace (build with -DMAZE_TRACE) records each tile drain and load.
+const size_t IN_CORE_BYTES_PER_CELL = 6; // Grid byte, BFS parent byte and queue entry
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double megabytes(uint64_t bytes) {
+    return bytes / 1048576.0;
+}
+
+int main(int argc, char* argv[]) {
+    startTraceFromArgs(argc, argv);
+    if (argc < 2) {
+        std::cerr << "Usage: external_solver <in.mza> [--memory MB] [--scratch prefix] [--from x y] [--to x y] [--path out.mzp] [--check]\n"
+                  << "                       [--trace file]" << std::endl;
+        return 1;
+    }
+    std::string in = argv[1], scratch = in, pathOut;
+    size_t memory = EXTERNAL_MEMORY_BYTES;
+    int fromX = 0, fromY = 0, toX = -1, toY = -1;
+    bool check = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--memory" && i + 1 < argc) memory = static_cast<size_t>(std::atof(argv[++i]) * 1048576);
+        else if (arg == "--scratch" && i + 1 < argc) scratch = argv[++i];
+        else if (arg == "--path" && i + 1 < argc) pathOut = argv[++i];
+        else if (arg == "--from" && i + 2 < argc) {
+            fromX = std::atoi(argv[++i]);
+            fromY = std::atoi(argv[++i]);
+        } else if (arg == "--to" && i + 2 < argc) {
+            toX = std::atoi(argv[++i]);
+            toY = std::atoi(argv[++i]);
+        } else if (arg == "--check") check = true;
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    // The solver holds decoded tiles itself, so the reader keeps none
+    ArchiveReader archive(0);
+    if (!archive.open(in)) {
+        std::cerr << "Cannot read archive: " << in << std::endl;
+        return 1;
+    }
+    if (toX < 0) {
+        toX = archive.width() - 1;
+        toY = archive.height() - 1;
+    }
+    uint64_t cells = static_cast<uint64_t>(archive.width()) * archive.height();
+
+    ExternalBfs solver(archive, memory);
+    auto start = std::chrono::steady_clock::now();
+    if (!solver.solve(fromX, fromY, toX, toY, scratch, pathOut)) {
+        std::cerr << "External solve failed (bad cells or I/O error)" << std::endl;
+        return 1;
+    }
+    double seconds = secondsSince(start);
+    const ExternalStats& stats = solver.stats();
+
+    std::cout << archive.width() << "x" << archive.height() << " in " << archive.tileSize() << "-cell tiles, budget " << megabytes(memory) << " MB ("
+              << stats.residentTiles << " resident tiles)" << std::endl;
+    if (stats.found) std::cout << "  path: " << stats.pathLength << " steps from " << fromX << "," << fromY << " to " << toX << "," << toY << std::endl;
+    else std::cout << "  no path from " << fromX << "," << fromY << " to " << toX << "," << toY << std::endl;
+    std::cout << "  time: " << seconds << " s, " << stats.visited / seconds / 1e6 << " Mcells/s visited" << std::endl;
+    std::cout << "  memory: peak " << megabytes(stats.peakBytes) << " MB; in memory solveBfs would need " << megabytes(cells * IN_CORE_BYTES_PER_CELL)
+              << " MB" << std::endl;
+    std::cout << "  search: " << stats.visited << " cells visited, " << stats.corrections << " corrections, " << stats.activations << " tile activations, "
+              << stats.tileLoads << " tile loads" << std::endl;
+    std::cout << "  frontier: " << stats.frontierEntries << " edge crossings (" << stats.rejectedEntries << " into closed walls)" << std::endl;
+    std::cout << "  I/O: read " << megabytes(stats.bytesRead()) << " MB (maze " << megabytes(stats.archiveBytesRead) << ", distances "
+              << megabytes(stats.stateBytesRead) << ", spill " << megabytes(stats.spillBytesRead) << "), wrote " << megabytes(stats.bytesWritten())
+              << " MB (distances " << megabytes(stats.stateBytesWritten) << ", spill " << megabytes(stats.spillBytesWritten) << ", path "
+              << megabytes(stats.pathBytesWritten) << ")" << std::endl;
+
+    int status = 0;
+    if (check) {
+        Grid grid;
+        if (!archive.readRegion(0, 0, archive.width(), archive.height(), grid)) {
+            std::cerr << "Cannot read the whole maze for --check" << std::endl;
+            return 1;
+        }
+        SolveResult result;
+        bool found = solveBfs(grid, grid.index(fromX, fromY), grid.index(toX, toY), result);
+        bool same = found == stats.found && (!found || result.path.size() - 1 == stats.pathLength);
+        if (same && found && !pathOut.empty()) {
+            // Every step of the path file must go through an open wall
+            PathFileReader reader;
+            Point cell, previous = {fromX, fromY};
+            uint64_t walked = 0;
+            same = reader.open(pathOut) && reader.steps() == stats.pathLength;
+            while (same && reader.next(cell)) {
+                if (walked++ > 0) same = grid.isOpen(grid.index(previous.x, previous.y), directionTo(previous, cell));
+                previous = cell;
+            }
+            same = same && walked == stats.pathLength + 1 && previous == Point{toX, toY};
+        }
+        std::cout << "  check: in-memory BFS " << (found ? std::to_string(result.path.size() - 1) + " steps" : std::string("no path"))
+                  << (same ? ", same" : ", DIFFERENT") << std::endl;
+        if (!same) status = 1;
+    }
+    MAZE_TRACE_STOP();
+    return status;
+}
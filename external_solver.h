@@ -0,0 +1,423 @@
+#ifndef EXTERNAL_SOLVER_H
+#define EXTERNAL_SOLVER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+#include "maze_archive.h"
+#include "maze_path.h"
+#include "maze_trace.h"
+
+// Out-of-core breadth-first search over a tile archive (maze_archive.h), for mazes whose
+// distance arrays do not fit in memory.
+//
+// Only a fixed number of tiles are resident at a time, each as its decoded passage bits
+// and a distance per cell. Evicted distances go to a scratch file at a fixed offset per
+// tile. A search step crossing a tile edge becomes a frontier entry for the neighbouring
+// tile; entries are buffered in memory and, when the buffers outgrow their share of the
+// budget, appended to a spill file as blocks chained per tile. A tile is loaded only to
+// drain its frontier, and the schedule prefers tiles that are already resident unless
+// their frontier is well behind the one with the smallest distance, which keeps the wave
+// roughly in BFS order without reloading a tile for every few cells.
+//
+// Distances are label-correcting: a shorter distance arriving later overwrites a longer
+// one and is propagated again, so braided mazes come out exact too. In a perfect maze
+// every cell has one distance and nothing is ever corrected. Steps into the west or north
+// neighbour are sent without knowing whether the wall is open, since that bit belongs to
+// the neighbour's tile; the neighbour checks it when it drains the entry.
+//
+// Memory is bounded by the budget plus a few dozen bytes of bookkeeping per tile.
+const size_t EXTERNAL_MEMORY_BYTES = 256 << 20;
+const int RESIDENT_SLACK_TILES = 2; // How far behind (in tile widths of distance) a resident tile may run
+const uint64_t NO_BLOCK = ~uint64_t(0);
+
+struct ExternalStats {
+    bool found = false;
+    uint64_t pathLength = 0;        // Steps from start to goal
+    uint64_t visited = 0;           // Cells given a distance (corrections included)
+    uint64_t corrections = 0;       // Distances overwritten by a shorter one
+    uint64_t frontierEntries = 0;   // Steps across tile edges
+    uint64_t rejectedEntries = 0;   // Of those, into a closed wall
+    uint64_t activations = 0;       // Times a tile's frontier was drained
+    uint64_t tileLoads = 0;         // Tiles read into a slot
+    uint64_t archiveBytesRead = 0;  // Compressed maze read
+    uint64_t stateBytesRead = 0;    // Distances read back
+    uint64_t stateBytesWritten = 0; // Distances written out on eviction
+    uint64_t spillBytesRead = 0;    // Frontier blocks read
+    uint64_t spillBytesWritten = 0; // Frontier blocks written
+    uint64_t pathBytesWritten = 0;  // Path file
+    size_t residentTiles = 0;       // Slots the budget allows
+    size_t peakBytes = 0;           // Largest working set of the solver's own buffers
+
+    uint64_t bytesRead() const { return archiveBytesRead + stateBytesRead + spillBytesRead; }
+    uint64_t bytesWritten() const { return stateBytesWritten + spillBytesWritten + pathBytesWritten; }
+};
+
+class ExternalBfs {
+public:
+    // The archive's own cache should be small (or 0): the solver keeps decoded tiles in its slots
+    ExternalBfs(ArchiveReader& archive, size_t memoryBytes = EXTERNAL_MEMORY_BYTES) : archive(archive), memoryBytes(memoryBytes) {}
+
+    ~ExternalBfs() { closeScratch(); }
+
+    // Scratch files are scratchPrefix + ".dist" and ".spill", removed afterwards. With
+    // pathOut the path is written there as a path file (maze_path.h). False on an I/O
+    // error; stats().found tells whether the goal was reached.
+    bool solve(int startX, int startY, int goalX, int goalY, const std::string& scratchPrefix, const std::string& pathOut = "") {
+        stats_ = ExternalStats();
+        prefix = scratchPrefix;
+        if (!inside(startX, startY) || !inside(goalX, goalY)) return false;
+        if (static_cast<uint64_t>(archive.tileSize()) * archive.tileSize() > 0x0FFFFFFF || !openScratch()) return false;
+        setup();
+        emit(startX, startY, 0, 0);
+        goal = {goalX, goalY};
+        goalDist = UINT32_MAX;
+        bool ok = true;
+        for (int t = pickTile(); ok && t >= 0; t = pickTile()) ok = drain(t) && !failed;
+        if (ok && goalDist != UINT32_MAX) {
+            stats_.found = true;
+            stats_.pathLength = goalDist;
+            if (!pathOut.empty()) ok = writePath(startX, startY, pathOut);
+        }
+        closeScratch();
+        return ok;
+    }
+
+    const ExternalStats& stats() const { return stats_; }
+
+private:
+    struct Entry {
+        uint32_t cell; // Local index, with the wall to check (EAST or SOUTH, or 0) in the top 4 bits
+        uint32_t dist;
+    };
+
+    struct Pending {
+        std::vector<Entry> buffer;
+        uint64_t spillHead = NO_BLOCK; // Last block appended to the spill file
+        uint32_t minDist = UINT32_MAX; // UINT32_MAX when there is nothing to drain
+    };
+
+    struct Slot {
+        int tile = -1;
+        std::shared_ptr<const ArchiveReader::Tile> cells;
+        std::vector<uint32_t> dist; // Distance + 1, 0 for not reached
+        bool dirty = false;
+        uint64_t lastUse = 0;
+    };
+
+    ArchiveReader& archive;
+    size_t memoryBytes;
+    ExternalStats stats_;
+    std::string prefix;
+    std::FILE* distFile = nullptr;
+    std::FILE* spillFile = nullptr;
+    uint64_t spillEnd = 0;
+    int tileSize = 0, across = 0, down = 0;
+    size_t tileCells = 0, bufferLimit = 0, buffered = 0;
+    std::vector<Pending> pending;
+    std::vector<int> slotOf;
+    std::vector<bool> stored; // Tile has distances in the scratch file
+    std::vector<Slot> slots;
+    std::vector<int> buffering; // Tiles with entries in memory
+    std::priority_queue<std::pair<uint32_t, int>, std::vector<std::pair<uint32_t, int>>, std::greater<>> ready;
+    std::pair<int, int> goal;
+    uint32_t goalDist = UINT32_MAX;
+    uint64_t useClock = 0;
+    size_t transientBytes = 0;
+    bool failed = false; // A spill write failed
+
+    bool inside(int x, int y) const { return x >= 0 && y >= 0 && x < archive.width() && y < archive.height(); }
+    int tileWidth(int t) const { return std::min(tileSize, archive.width() - (t % across) * tileSize); }
+    int tileHeight(int t) const { return std::min(tileSize, archive.height() - (t / across) * tileSize); }
+
+    bool openScratch() {
+        distFile = std::fopen((prefix + ".dist").c_str(), "w+b");
+        spillFile = std::fopen((prefix + ".spill").c_str(), "w+b");
+        return distFile && spillFile;
+    }
+
+    void closeScratch() {
+        if (distFile) {
+            std::fclose(distFile);
+            std::remove((prefix + ".dist").c_str());
+            distFile = nullptr;
+        }
+        if (spillFile) {
+            std::fclose(spillFile);
+            std::remove((prefix + ".spill").c_str());
+            spillFile = nullptr;
+        }
+    }
+
+    // Three quarters of the budget for slots (passage bits and distances), the rest for
+    // frontier buffers
+    void setup() {
+        tileSize = archive.tileSize();
+        across = archive.tilesAcross();
+        down = archive.tilesDown();
+        tileCells = static_cast<size_t>(tileSize) * tileSize;
+        size_t tiles = static_cast<size_t>(across) * down;
+        size_t slotCount = std::max<size_t>(2, memoryBytes / 4 * 3 / (tileCells * (1 + sizeof(uint32_t))));
+        slots.assign(std::min(slotCount, tiles), Slot());
+        bufferLimit = std::max<size_t>(1024, memoryBytes / 4 / sizeof(Entry));
+        pending.assign(tiles, Pending());
+        slotOf.assign(tiles, -1);
+        stored.assign(tiles, false);
+        buffering.clear();
+        buffered = 0;
+        spillEnd = 0;
+        failed = false;
+        useClock = 0;
+        ready = decltype(ready)();
+        stats_.residentTiles = slots.size();
+        noteMemory();
+    }
+
+    void noteMemory() {
+        size_t bookkeeping = pending.size() * (sizeof(Pending) + sizeof(int)) + stored.size() / 8 + ready.size() * sizeof(std::pair<uint32_t, int>);
+        size_t resident = 0;
+        for (const Slot& slot : slots) resident += (slot.cells ? slot.cells->size() : 0) + slot.dist.capacity() * sizeof(uint32_t);
+        stats_.peakBytes = std::max(stats_.peakBytes, bookkeeping + resident + buffered * sizeof(Entry) + transientBytes);
+    }
+
+    // Queues a step into global cell (x, y) at distance dist; check is the wall of that
+    // cell which must be open for the step to count
+    void emit(int x, int y, uint32_t dist, int check) {
+        int t = (y / tileSize) * across + x / tileSize;
+        uint32_t local = static_cast<uint32_t>((y % tileSize) * tileWidth(t) + x % tileSize);
+        Pending& p = pending[t];
+        if (p.buffer.empty()) buffering.push_back(t);
+        p.buffer.push_back({local | (static_cast<uint32_t>(check) << 28), dist});
+        ++buffered;
+        ++stats_.frontierEntries;
+        if (dist < p.minDist) {
+            p.minDist = dist;
+            ready.push({dist, t});
+        }
+        if (buffered > bufferLimit && !spill()) failed = true;
+    }
+
+    // Every buffer becomes one block on the spill file: previous block, count, entries
+    bool spill() {
+        noteMemory();
+        bool ok = true;
+        for (int t : buffering) {
+            Pending& p = pending[t];
+            uint8_t header[16];
+            putFixed(header, p.spillHead, 8);
+            putFixed(header + 8, p.buffer.size(), 8);
+            size_t bytes = p.buffer.size() * sizeof(Entry);
+            ok = ok && fseeko(spillFile, static_cast<off_t>(spillEnd), SEEK_SET) == 0 && std::fwrite(header, 1, sizeof(header), spillFile) == sizeof(header) &&
+                 std::fwrite(p.buffer.data(), 1, bytes, spillFile) == bytes;
+            p.spillHead = spillEnd;
+            spillEnd += sizeof(header) + bytes;
+            stats_.spillBytesWritten += sizeof(header) + bytes;
+            std::vector<Entry>().swap(p.buffer);
+        }
+        buffering.clear();
+        buffered = 0;
+        return ok;
+    }
+
+    // Resident tile with the smallest frontier if it is within the slack of the global
+    // smallest, otherwise the global smallest; -1 when the search is over
+    int pickTile() {
+        while (!ready.empty() && pending[ready.top().second].minDist != ready.top().first) ready.pop();
+        if (ready.empty()) return -1;
+        uint32_t smallest = ready.top().first;
+        if (smallest >= goalDist) return -1;
+        uint64_t limit = static_cast<uint64_t>(smallest) + static_cast<uint64_t>(RESIDENT_SLACK_TILES) * tileSize;
+        int best = -1;
+        for (const Slot& slot : slots) {
+            if (slot.tile >= 0 && pending[slot.tile].minDist <= limit && (best < 0 || pending[slot.tile].minDist < pending[best].minDist)) best = slot.tile;
+        }
+        return best >= 0 ? best : ready.top().second;
+    }
+
+    // Makes tile t resident, writing back the least recently used slot if it is taken
+    Slot* load(int t) {
+        if (slotOf[t] >= 0) {
+            Slot& slot = slots[slotOf[t]];
+            slot.lastUse = ++useClock;
+            return &slot;
+        }
+        MAZE_TRACE_SCOPE("load tile");
+        size_t victim = 0;
+        for (size_t i = 1; i < slots.size(); ++i) {
+            if (slots[i].lastUse < slots[victim].lastUse) victim = i;
+        }
+        Slot& slot = slots[victim];
+        if (slot.tile >= 0) {
+            if (slot.dirty) {
+                size_t bytes = static_cast<size_t>(tileWidth(slot.tile)) * tileHeight(slot.tile) * sizeof(uint32_t);
+                if (fseeko(distFile, static_cast<off_t>(slot.tile * tileCells * sizeof(uint32_t)), SEEK_SET) != 0 ||
+                    std::fwrite(slot.dist.data(), 1, bytes, distFile) != bytes) {
+                    return nullptr;
+                }
+                stats_.stateBytesWritten += bytes;
+                stored[slot.tile] = true;
+            }
+            slotOf[slot.tile] = -1;
+        }
+        int tx = t % across, ty = t / across;
+        slot.cells = archive.tile(tx, ty);
+        if (!slot.cells) return nullptr;
+        stats_.archiveBytesRead += archive.tileBytes(tx, ty);
+        ++stats_.tileLoads;
+        size_t cells = static_cast<size_t>(tileWidth(t)) * tileHeight(t);
+        slot.dist.resize(tileCells);
+        if (stored[t]) {
+            if (fseeko(distFile, static_cast<off_t>(t * tileCells * sizeof(uint32_t)), SEEK_SET) != 0 ||
+                std::fread(slot.dist.data(), sizeof(uint32_t), cells, distFile) != cells) {
+                return nullptr;
+            }
+            stats_.stateBytesRead += cells * sizeof(uint32_t);
+        } else {
+            std::fill(slot.dist.begin(), slot.dist.end(), 0);
+        }
+        slot.tile = t;
+        slot.dirty = false;
+        slot.lastUse = ++useClock;
+        slotOf[t] = static_cast<int>(victim);
+        noteMemory();
+        return &slot;
+    }
+
+    // Takes tile t's frontier out of memory and the spill file, smallest distance first
+    bool takeFrontier(int t, std::vector<Entry>& entries) {
+        Pending& p = pending[t];
+        entries.swap(p.buffer);
+        std::vector<Entry>().swap(p.buffer);
+        buffered -= entries.size();
+        buffering.erase(std::remove(buffering.begin(), buffering.end(), t), buffering.end());
+        for (uint64_t block = p.spillHead; block != NO_BLOCK;) {
+            uint8_t header[16];
+            if (fseeko(spillFile, static_cast<off_t>(block), SEEK_SET) != 0 || std::fread(header, 1, sizeof(header), spillFile) != sizeof(header)) return false;
+            size_t count = getFixed(header + 8, 8), offset = entries.size();
+            entries.resize(offset + count);
+            if (std::fread(entries.data() + offset, sizeof(Entry), count, spillFile) != count) return false;
+            stats_.spillBytesRead += sizeof(header) + count * sizeof(Entry);
+            block = getFixed(header, 8);
+        }
+        p.spillHead = NO_BLOCK;
+        p.minDist = UINT32_MAX;
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.dist < b.dist; });
+        return true;
+    }
+
+    // BFS inside tile t from its frontier; steps off the tile are emitted to the neighbours
+    bool drain(int t) {
+        MAZE_TRACE_SCOPE("drain tile");
+        ++stats_.activations;
+        Slot* slot = load(t);
+        std::vector<Entry> entries;
+        if (!slot || !takeFrontier(t, entries)) return false;
+        const uint8_t* bits = slot->cells->data();
+        uint32_t* dist = slot->dist.data();
+        int width = tileWidth(t), height = tileHeight(t);
+        int x0 = (t % across) * tileSize, y0 = (t / across) * tileSize;
+        std::vector<uint32_t> queue;
+        transientBytes = entries.capacity() * sizeof(Entry);
+
+        auto relax = [&](uint32_t cell, uint32_t d) {
+            if (dist[cell] != 0 && dist[cell] <= d + 1) return;
+            if (dist[cell] != 0) ++stats_.corrections;
+            dist[cell] = d + 1;
+            ++stats_.visited;
+            queue.push_back(cell);
+        };
+
+        size_t next = 0, head = 0;
+        while (head < queue.size() || next < entries.size()) {
+            // Seeds join the queue in distance order so it stays a BFS queue
+            if (next < entries.size() && (head == queue.size() || entries[next].dist + 1 <= dist[queue[head]])) {
+                const Entry& entry = entries[next++];
+                uint32_t cell = entry.cell & 0x0FFFFFFF;
+                int check = static_cast<int>(entry.cell >> 28);
+                bool open = check == 0 || (check == EAST && (bits[cell] & 1)) || (check == SOUTH && (bits[cell] & 2));
+                if (open) relax(cell, entry.dist);
+                else ++stats_.rejectedEntries;
+                continue;
+            }
+            uint32_t cell = queue[head++];
+            uint32_t d = dist[cell] - 1;
+            int x = static_cast<int>(cell % width), y = static_cast<int>(cell / width);
+            if (bits[cell] & 1) {
+                if (x + 1 < width) relax(cell + 1, d + 1);
+                else if (x0 + x + 1 < archive.width()) emit(x0 + x + 1, y0 + y, d + 1, 0);
+            }
+            if (bits[cell] & 2) {
+                if (y + 1 < height) relax(cell + width, d + 1);
+                else if (y0 + y + 1 < archive.height()) emit(x0 + x, y0 + y + 1, d + 1, 0);
+            }
+            if (x > 0) {
+                if (bits[cell - 1] & 1) relax(cell - 1, d + 1);
+            } else if (x0 > 0) {
+                emit(x0 - 1, y0 + y, d + 1, EAST);
+            }
+            if (y > 0) {
+                if (bits[cell - width] & 2) relax(cell - width, d + 1);
+            } else if (y0 > 0) {
+                emit(x0 + x, y0 - 1, d + 1, SOUTH);
+            }
+        }
+        transientBytes += queue.capacity() * sizeof(uint32_t);
+        noteMemory();
+        transientBytes = 0;
+        if (!queue.empty()) slot->dirty = true;
+        if (goal.first / tileSize + goal.second / tileSize * across == t) {
+            uint32_t reached = dist[(goal.second - y0) * width + goal.first - x0];
+            if (reached != 0) goalDist = reached - 1;
+        }
+        return true;
+    }
+
+    // Distance of global cell (x, y), UINT32_MAX if unreached; loads its tile
+    bool distanceAt(int x, int y, uint32_t& d, uint8_t& bits) {
+        int t = (y / tileSize) * across + x / tileSize;
+        Slot* slot = load(t);
+        if (!slot) return false;
+        size_t local = static_cast<size_t>(y % tileSize) * tileWidth(t) + x % tileSize;
+        d = slot->dist[local] - 1;
+        bits = (*slot->cells)[local];
+        return true;
+    }
+
+    // Walks back from the goal through cells one step closer each time, writing each move
+    // into its place in the path file (maze_path.h) as it is found
+    bool writePath(int startX, int startY, const std::string& pathOut) {
+        PathFileWriter writer;
+        bool ok = writer.open(pathOut, {startX, startY}, goalDist);
+        int x = goal.first, y = goal.second;
+        for (uint32_t d = goalDist; ok && d > 0; --d) {
+            uint32_t nd;
+            uint8_t here, there;
+            if (!distanceAt(x, y, nd, here)) return false;
+            bool stepped = false;
+            for (Direction dir : DIRECTIONS) {
+                Point next = stepPoint({x, y}, dir);
+                if (!inside(next.x, next.y) || !distanceAt(next.x, next.y, nd, there) || nd != d - 1) continue;
+                bool open = dir == EAST ? (here & 1) : dir == SOUTH ? (here & 2) : dir == WEST ? (there & 1) : (there & 2);
+                if (open) {
+                    writer.pushBackward(opposite(dir));
+                    x = next.x;
+                    y = next.y;
+                    stepped = true;
+                    break;
+                }
+            }
+            ok = stepped;
+        }
+        ok = writer.close() && ok && x == startX && y == startY;
+        stats_.pathBytesWritten = writer.fileBytes();
+        return ok;
+    }
+};
+
+#endif
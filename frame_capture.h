@@ -0,0 +1,306 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Offline frame capture: a software framebuffer written to raw video without a window.
+//
+// FrameCanvas is the renderer's side: the picture as one palette index per pixel. Painting
+// records the rectangles it touched, and takeChanges() packs just those rectangles and
+// their pixels into a FrameChanges, so a frame where ten cells changed hands over ten
+// small rectangles however big the video is.
+//
+// CaptureWriter runs a writer thread that owns a FrameEncoder: a copy of the picture and
+// the encoded frame (Y4M 4:2:0 planes or PPM RGB). It applies each frame's changes,
+// converts only the changed rectangles and writes the frame out, while the renderer goes
+// on with the next frame. Up to CAPTURE_BUFFERS frames of changes can be queued; past
+// that the renderer sleeps until the writer catches up (timed in stallSeconds), and the
+// writer sleeps while there is nothing queued.
+//
+// Y4M goes to one file ("-" for stdout, to pipe into an encoder). PPM goes to numbered
+// files: <prefix>000000.ppm, <prefix>000001.ppm, ...
+enum CaptureFormat { CAPTURE_Y4M, CAPTURE_PPM };
+
+struct CaptureColor {
+    uint8_t r, g, b;
+};
+
+const int CAPTURE_BUFFERS = 8; // Frames queued for the writer before the renderer waits
+
+struct CaptureRect {
+    int x, y, w, h;
+};
+
+// What one frame painted: the rectangles, then their palette indices row by row
+struct FrameChanges {
+    std::vector<CaptureRect> rects;
+    std::vector<uint8_t> pixels;
+};
+
+class FrameCanvas {
+public:
+    FrameCanvas(int width, int height) : w(width), h(height), pixels(static_cast<size_t>(width) * height, 0) {
+        fill(0, 0, width, height, 0);
+    }
+
+    int width() const { return w; }
+    int height() const { return h; }
+
+    // Paint a rectangle in a palette color, clipped to the frame
+    void fill(int x, int y, int rw, int rh, uint8_t color) {
+        int x2 = std::min(w, x + rw), y2 = std::min(h, y + rh);
+        x = std::max(0, x);
+        y = std::max(0, y);
+        if (x >= x2 || y >= y2) return;
+        for (int row = y; row < y2; ++row) std::memset(&pixels[static_cast<size_t>(row) * w + x], color, x2 - x);
+        dirty.push_back({x, y, x2 - x, y2 - y});
+    }
+
+    // Move what was painted since the last call into changes, reusing its storage
+    void takeChanges(FrameChanges& changes) {
+        changes.rects.swap(dirty);
+        dirty.clear();
+        changes.pixels.clear();
+        for (const CaptureRect& rect : changes.rects) {
+            for (int y = rect.y; y < rect.y + rect.h; ++y) {
+                const uint8_t* row = &pixels[static_cast<size_t>(y) * w + rect.x];
+                changes.pixels.insert(changes.pixels.end(), row, row + rect.w);
+            }
+        }
+    }
+
+private:
+    int w, h;
+    std::vector<uint8_t> pixels; // Palette indices
+    std::vector<CaptureRect> dirty;
+};
+
+class FrameEncoder {
+public:
+    FrameEncoder() = default;
+
+    // Y4M needs an even width and height for its 4:2:0 chroma
+    FrameEncoder(int width, int height, CaptureFormat format, const std::vector<CaptureColor>& palette)
+        : w(width), h(height), format(format), palette(palette), pixels(static_cast<size_t>(width) * height, 0) {
+        size_t area = static_cast<size_t>(width) * height;
+        encoded.assign(format == CAPTURE_Y4M ? area + 2 * (area / 4) : area * 3, 0);
+        for (const CaptureColor& color : palette) {
+            // BT.601, limited range
+            luma.push_back(static_cast<uint8_t>(16 + ((66 * color.r + 129 * color.g + 25 * color.b + 128) >> 8)));
+            blue.push_back(128 + ((-38 * color.r - 74 * color.g + 112 * color.b + 128) >> 8));
+            red.push_back(128 + ((112 * color.r - 94 * color.g - 18 * color.b + 128) >> 8));
+        }
+    }
+
+    // Bring the picture and the encoded frame up to date with one frame's changes
+    void apply(const FrameChanges& changes) {
+        const uint8_t* in = changes.pixels.data();
+        for (const CaptureRect& rect : changes.rects) {
+            for (int y = rect.y; y < rect.y + rect.h; ++y, in += rect.w) {
+                std::memcpy(&pixels[static_cast<size_t>(y) * w + rect.x], in, rect.w);
+            }
+        }
+        // Encoded after every rectangle is copied: Y4M chroma blocks reach past their rectangle
+        for (const CaptureRect& rect : changes.rects) {
+            if (format == CAPTURE_Y4M) encodeYuv(rect);
+            else encodeRgb(rect);
+        }
+    }
+
+    const std::vector<uint8_t>& frame() const { return encoded; }
+    uint64_t pixelsEncoded() const { return converted; }
+
+private:
+    int w = 0, h = 0;
+    CaptureFormat format = CAPTURE_Y4M;
+    std::vector<CaptureColor> palette;
+    std::vector<uint8_t> luma;
+    std::vector<int> blue, red;     // Chroma of each palette color
+    std::vector<uint8_t> pixels;    // Palette indices
+    std::vector<uint8_t> encoded;   // The frame as written
+    uint64_t converted = 0;
+
+    void encodeRgb(const CaptureRect& rect) {
+        for (int y = rect.y; y < rect.y + rect.h; ++y) {
+            const uint8_t* in = &pixels[static_cast<size_t>(y) * w + rect.x];
+            uint8_t* out = &encoded[(static_cast<size_t>(y) * w + rect.x) * 3];
+            for (int x = 0; x < rect.w; ++x, out += 3) {
+                const CaptureColor& color = palette[in[x]];
+                out[0] = color.r;
+                out[1] = color.g;
+                out[2] = color.b;
+            }
+        }
+        converted += static_cast<uint64_t>(rect.w) * rect.h;
+    }
+
+    // Widened to whole 2x2 chroma blocks; chroma is the average of the block
+    void encodeYuv(const CaptureRect& rect) {
+        int x1 = rect.x & ~1, y1 = rect.y & ~1;
+        int x2 = std::min(w, (rect.x + rect.w + 1) & ~1), y2 = std::min(h, (rect.y + rect.h + 1) & ~1);
+        size_t area = static_cast<size_t>(w) * h;
+        uint8_t* planeY = encoded.data();
+        uint8_t* planeU = planeY + area;
+        uint8_t* planeV = planeU + area / 4;
+        for (int y = y1; y < y2; y += 2) {
+            const uint8_t* top = &pixels[static_cast<size_t>(y) * w];
+            const uint8_t* bottom = top + w;
+            uint8_t* lumaTop = planeY + static_cast<size_t>(y) * w;
+            uint8_t* lumaBottom = lumaTop + w;
+            size_t chroma = static_cast<size_t>(y / 2) * (w / 2);
+            for (int x = x1; x < x2; x += 2) {
+                uint8_t a = top[x], b = top[x + 1], c = bottom[x], d = bottom[x + 1];
+                lumaTop[x] = luma[a];
+                lumaTop[x + 1] = luma[b];
+                lumaBottom[x] = luma[c];
+                lumaBottom[x + 1] = luma[d];
+                planeU[chroma + x / 2] = static_cast<uint8_t>((blue[a] + blue[b] + blue[c] + blue[d] + 2) >> 2);
+                planeV[chroma + x / 2] = static_cast<uint8_t>((red[a] + red[b] + red[c] + red[d] + 2) >> 2);
+            }
+        }
+        converted += static_cast<uint64_t>(x2 - x1) * (y2 - y1);
+    }
+};
+
+class CaptureWriter {
+public:
+    ~CaptureWriter() { close(); }
+
+    bool open(const std::string& path, CaptureFormat captureFormat, int width, int height, int fps, const std::vector<CaptureColor>& palette) {
+        format = captureFormat;
+        target = path;
+        char header[64];
+        if (format == CAPTURE_Y4M) {
+            file = path == "-" ? stdout : std::fopen(path.c_str(), "wb");
+            if (!file) return false;
+            int length = std::snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+            ok = std::fwrite(header, 1, length, file) == static_cast<size_t>(length);
+            written += length;
+        } else {
+            frameHeader = std::string(header, std::snprintf(header, sizeof(header), "P6\n%d %d\n255\n", width, height));
+        }
+        encoder = FrameEncoder(width, height, format, palette);
+        jobs.assign(CAPTURE_BUFFERS, FrameChanges());
+        ready.clear();
+        spare.clear();
+        for (int i = 0; i < CAPTURE_BUFFERS; ++i) spare.push_back(i);
+        finished = false;
+        worker = std::thread([this] { run(); });
+        return ok;
+    }
+
+    // Queue what the canvas painted since the last frame; sleeps only while every buffer is queued
+    void submit(FrameCanvas& canvas) {
+        int job = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (spare.empty()) {
+                auto start = std::chrono::steady_clock::now();
+                hasSpare.wait(lock, [&] { return !spare.empty(); }); // The writer is behind
+                stalled += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+            job = spare.front();
+            spare.pop_front();
+        }
+        canvas.takeChanges(jobs[job]);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready.push_back(job);
+        }
+        hasReady.notify_one();
+    }
+
+    // Write out what is queued; false if any write failed
+    bool close() {
+        if (worker.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished = true;
+            }
+            hasReady.notify_one();
+            worker.join();
+        }
+        if (file) {
+            ok = std::fflush(file) == 0 && ok;
+            if (file != stdout) ok = std::fclose(file) == 0 && ok;
+            file = nullptr;
+        }
+        return ok;
+    }
+
+    // Read these after close()
+    uint64_t framesWritten() const { return frames; }
+    uint64_t bytesWritten() const { return written; }
+    uint64_t pixelsEncoded() const { return encoder.pixelsEncoded(); }
+    double encodeSeconds() const { return encoding; } // Writer thread converting pixels
+    double writeSeconds() const { return writing; }   // Writer thread in fwrite
+    double stallSeconds() const { return stalled; }   // Renderer waiting for a buffer
+
+private:
+    CaptureFormat format = CAPTURE_Y4M;
+    std::string target, frameHeader;
+    std::FILE* file = nullptr;
+    FrameEncoder encoder; // Writer thread only
+    std::vector<FrameChanges> jobs;
+    std::mutex mutex;
+    std::condition_variable hasReady, hasSpare;
+    std::deque<int> ready; // Renderer to writer
+    std::deque<int> spare; // Writer back to renderer
+    std::thread worker;
+    bool finished = false;
+    bool ok = true;
+    uint64_t frames = 0, written = 0;
+    double encoding = 0, writing = 0, stalled = 0;
+
+    void run() {
+        for (;;) {
+            int job = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                hasReady.wait(lock, [&] { return !ready.empty() || finished; });
+                if (ready.empty()) return;
+                job = ready.front();
+                ready.pop_front();
+            }
+            auto start = std::chrono::steady_clock::now();
+            encoder.apply(jobs[job]);
+            auto encoded = std::chrono::steady_clock::now();
+            encoding += std::chrono::duration<double>(encoded - start).count();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                spare.push_back(job); // The changes are in the encoder, the renderer may reuse them
+            }
+            hasSpare.notify_one();
+            write(encoder.frame());
+            writing += std::chrono::duration<double>(std::chrono::steady_clock::now() - encoded).count();
+        }
+    }
+
+    void write(const std::vector<uint8_t>& frame) {
+        if (format == CAPTURE_Y4M) {
+            ok = ok && std::fwrite("FRAME\n", 1, 6, file) == 6 && std::fwrite(frame.data(), 1, frame.size(), file) == frame.size();
+            written += 6 + frame.size();
+        } else {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%06llu.ppm", static_cast<unsigned long long>(frames));
+            std::FILE* out = std::fopen((target + name).c_str(), "wb");
+            ok = ok && out && std::fwrite(frameHeader.data(), 1, frameHeader.size(), out) == frameHeader.size() &&
+                 std::fwrite(frame.data(), 1, frame.size(), out) == frame.size();
+            if (out) ok = std::fclose(out) == 0 && ok;
+            written += frameHeader.size() + frame.size();
+        }
+        ++frames;
+    }
+};
+
+#endif
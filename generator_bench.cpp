@@ -0,0 +1,144 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include "maze_generators.h"
+#include "maze_verifier.h"
+#include "maze_io.h"
+
+// Benchmark: every generator in the table at one size on one thread, then the parallel
+// generators over 1, 2, 4, ... threads at a larger size: fork-join recursive division, and
+// the packed binary tree and sidewinder in GB/s of packed maze output. Parallel output is
+// checked to be identical for every thread count and to be a perfect maze. With an output
+// path the sidewinder maze is also streamed to a maze file.
+// Usage: generator_bench [size] [packedSize] [maxThreads] [out] [--trace file]
+const int DEFAULT_SIZE = 1024;
+const int DEFAULT_PACKED_SIZE = 16384;
+const int STREAM_ROWS = 4096; // Rows per chunk when streaming to a file
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Unpacks rows the way MazeFileReader does and feeds them to the streaming verifier
+VerifyReport verifyPacked(const std::vector<uint8_t>& packed, int width, int height) {
+    size_t rowBytes = packedRowBytes(width);
+    StreamingVerifier verifier(width);
+    std::vector<uint8_t> cells(width), south(width, 0);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = packed.data() + static_cast<size_t>(y) * rowBytes;
+        uint8_t westOpen = 0;
+        for (int x = 0; x < width; ++x) {
+            uint8_t bits = (row[x >> 2] >> ((x & 3) * 2)) & 3;
+            cells[x] = (south[x] ? NORTH : 0) | westOpen | ((bits & 1) ? EAST : 0) | ((bits & 2) ? SOUTH : 0);
+            westOpen = (bits & 1) ? WEST : 0;
+            south[x] = bits & 2;
+        }
+        verifier.addRow(cells.data());
+    }
+    return verifier.finish();
+}
+
+int main(int argc, char* argv[]) {
+    startTraceFromArgs(argc, argv);
+    int size = argc > 1 ? std::atoi(argv[1]) : DEFAULT_SIZE;
+    int packedSize = argc > 2 ? std::atoi(argv[2]) : DEFAULT_PACKED_SIZE;
+    int maxThreads = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string out = argc > 4 ? argv[4] : "";
+    if (size < 2 || packedSize < 2 || maxThreads < 1) {
+        std::cerr << "Usage: generator_bench [size] [packedSize] [maxThreads] [out] [--trace file]" << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    std::cout << size << "x" << size << ", one thread:" << std::endl;
+    for (const GeneratorInfo& generator : GENERATORS) {
+        auto start = std::chrono::steady_clock::now();
+        Grid grid = buildMaze(generator, 1, size, size);
+        double seconds = secondsSince(start);
+        bool perfect = verifyGrid(grid).perfect();
+        if (!perfect) ++failures;
+        std::cout << "  " << std::left << std::setw(15) << generator.name << std::right << std::fixed << std::setprecision(1) << std::setw(9)
+                  << seconds * 1000 << " ms " << std::setw(8) << grid.size() / seconds / 1e6 << " Mcells/s" << (perfect ? "" : "  NOT PERFECT") << std::endl;
+    }
+
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    // Recursive division against its own serial run; tasks must not change the maze
+    {
+        Grid reference(packedSize, packedSize);
+        auto start = std::chrono::steady_clock::now();
+        divideSerial(reference, {0, 0, packedSize, packedSize, 1});
+        double serialSeconds = secondsSince(start);
+        if (!verifyGrid(reference).perfect()) ++failures;
+        std::cout << packedSize << "x" << packedSize << " recursive division, serial " << serialSeconds * 1000 << " ms, cutoff " << DIVISION_CUTOFF
+                  << " cells:" << std::endl;
+        for (int threads : threadCounts) {
+            WorkStealingPool pool(threads);
+            Grid grid(packedSize, packedSize);
+            start = std::chrono::steady_clock::now();
+            generateRecursiveDivisionParallel(grid, 1, pool);
+            double seconds = secondsSince(start);
+            bool same = grid.cells == reference.cells;
+            if (!same) ++failures;
+            std::cout << "  division    " << std::setw(3) << threads << " threads " << std::setw(9) << seconds * 1000 << " ms " << std::setw(8)
+                      << grid.size() / seconds / 1e6 << " Mcells/s " << std::setprecision(2) << std::setw(5) << serialSeconds / seconds << "x serial"
+                      << std::setprecision(1) << (same ? "" : "  DIFFERS FROM SERIAL") << std::endl;
+        }
+    }
+
+    size_t bytes = packedRowBytes(packedSize) * packedSize;
+    std::cout << packedSize << "x" << packedSize << " packed, " << bytes / (1 << 20) << " MB:" << std::endl;
+    const PackedAlgorithm algorithms[] = {PACKED_BINARY_TREE, PACKED_SIDEWINDER};
+    for (PackedAlgorithm algorithm : algorithms) {
+        const char* name = algorithm == PACKED_BINARY_TREE ? "binary-tree" : "sidewinder";
+        std::vector<uint8_t> reference, packed(bytes);
+        for (int threads : threadCounts) {
+            auto start = std::chrono::steady_clock::now();
+            generatePacked(algorithm, 1, packedSize, packedSize, threads, packed.data());
+            double seconds = secondsSince(start);
+            std::string note;
+            if (reference.empty()) {
+                reference = packed;
+                if (!verifyPacked(packed, packedSize, packedSize).perfect()) note = "  NOT PERFECT";
+            } else if (packed != reference) {
+                note = "  DIFFERS FROM ONE THREAD";
+            }
+            if (!note.empty()) ++failures;
+            std::cout << "  " << std::left << std::setw(12) << name << std::right << std::setw(3) << threads << " threads " << std::setw(9)
+                      << seconds * 1000 << " ms " << std::setprecision(2) << std::setw(7) << bytes / seconds / 1e9 << " GB/s " << std::setprecision(1)
+                      << std::setw(9) << static_cast<double>(packedSize) * packedSize / seconds / 1e6 << " Mcells/s" << note << std::endl;
+        }
+    }
+
+    // Stream to a file a chunk of rows at a time; memory stays at one chunk however big the maze
+    if (!out.empty()) {
+        MazeFileWriter writer;
+        if (!writer.open(out, packedSize, packedSize, 2)) {
+            std::cerr << "Cannot write " << out << std::endl;
+            return 1;
+        }
+        size_t rowBytes = packedRowBytes(packedSize);
+        std::vector<uint8_t> chunk(rowBytes * STREAM_ROWS);
+        auto start = std::chrono::steady_clock::now();
+        bool ok = true;
+        for (int y = 0; ok && y < packedSize; y += STREAM_ROWS) {
+            int rows = std::min(STREAM_ROWS, packedSize - y);
+            generatePackedRows(PACKED_SIDEWINDER, 1, packedSize, packedSize, y, rows, maxThreads, chunk.data());
+            for (int r = 0; ok && r < rows; ++r) ok = writer.writePackedRow(chunk.data() + static_cast<size_t>(r) * rowBytes);
+        }
+        ok = writer.close() && ok;
+        double seconds = secondsSince(start);
+        std::cout << "sidewinder to " << out << ": " << std::setprecision(3) << seconds << " s, " << std::setprecision(2) << bytes / seconds / 1e9 << " GB/s"
+                  << (ok ? "" : ", WRITE FAILED") << std::endl;
+        if (!ok) ++failures;
+    }
+    MAZE_TRACE_STOP();
+    return failures ? 1 : 0;
+}
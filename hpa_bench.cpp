@@ -0,0 +1,119 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "maze_generators.h"
+#include "maze_hpa.h"
+
+// Benchmark: flat A* against hierarchical A* on a braided maze, plus incremental rebuilds.
+// Usage: hpa_bench [size] [queries] [clusterSize] [braid] [--trace file]
+const int DEFAULT_SIZE = 2000;
+const int DEFAULT_QUERIES = 20;
+const int DEFAULT_CLUSTER = 32;
+const double DEFAULT_BRAID = 0.5;
+const int WALL_FLIPS = 100;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Reference A* over cells with the Manhattan heuristic; returns the path length or -1
+long long flatAStar(const Grid& grid, uint32_t start, uint32_t goal, size_t& expanded) {
+    const uint32_t INF = UINT32_MAX;
+    std::vector<uint32_t> gScore(grid.size(), INF);
+    Point target = grid.point(goal);
+    auto heuristic = [&](uint32_t cell) {
+        Point p = grid.point(cell);
+        return static_cast<uint32_t>(std::abs(p.x - target.x) + std::abs(p.y - target.y));
+    };
+
+    typedef std::pair<uint32_t, uint32_t> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    gScore[start] = 0;
+    open.push({heuristic(start), start});
+    expanded = 0;
+    while (!open.empty()) {
+        auto [f, cell] = open.top();
+        open.pop();
+        if (f != gScore[cell] + heuristic(cell)) continue;
+        ++expanded;
+        if (cell == goal) return gScore[cell];
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (!grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, next)) continue;
+            if (gScore[cell] + 1 < gScore[next]) {
+                gScore[next] = gScore[cell] + 1;
+                open.push({gScore[next] + heuristic(next), next});
+            }
+        }
+    }
+    return -1;
+}
+
+int main(int argc, char* argv[]) {
+    startTraceFromArgs(argc, argv);
+    int size = argc > 1 ? std::atoi(argv[1]) : DEFAULT_SIZE;
+    int queries = argc > 2 ? std::atoi(argv[2]) : DEFAULT_QUERIES;
+    int clusterSize = argc > 3 ? std::atoi(argv[3]) : DEFAULT_CLUSTER;
+    double braid = argc > 4 ? std::atof(argv[4]) : DEFAULT_BRAID;
+    if (size < 2 || queries < 1) {
+        std::cerr << "Usage: hpa_bench [size] [queries] [clusterSize] [braid] [--trace file]" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Grid grid = buildMaze(GENERATORS[0], 1, size, size);
+    std::mt19937 rng(2);
+    braidMaze(grid, rng, braid);
+    std::cout << size << "x" << size << " backtracker maze, braid " << braid << ": " << secondsSince(start) << " s" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    HierarchicalSolver solver(grid, clusterSize);
+    solver.update();
+    std::cout << "HPA* index, " << solver.clustersRebuilt() << " clusters of " << clusterSize << ": " << secondsSince(start) << " s, "
+              << solver.memoryBytes() / (1024 * 1024) << " MB" << std::endl;
+
+    // Random start/goal pairs, timed with both solvers and checked for equal lengths
+    std::uniform_int_distribution<uint32_t> anyCell(0, grid.size() - 1);
+    double flatSeconds = 0, hpaSeconds = 0;
+    size_t flatExpanded = 0, hpaExpanded = 0;
+    int mismatches = 0;
+    for (int q = 0; q < queries; ++q) {
+        uint32_t from = anyCell(rng), to = anyCell(rng);
+        size_t expanded = 0;
+        start = std::chrono::steady_clock::now();
+        long long flatLength = flatAStar(grid, from, to, expanded);
+        flatSeconds += secondsSince(start);
+        flatExpanded += expanded;
+
+        start = std::chrono::steady_clock::now();
+        std::vector<uint32_t> path = solver.findPath(from, to);
+        hpaSeconds += secondsSince(start);
+        hpaExpanded += solver.abstractNodesExpanded();
+
+        long long hpaLength = path.empty() ? -1 : static_cast<long long>(path.size()) - 1;
+        if (hpaLength != flatLength) ++mismatches;
+    }
+    std::cout << "flat A*: " << flatSeconds * 1000 / queries << " ms/query, " << flatExpanded / queries << " cells expanded" << std::endl;
+    std::cout << "HPA*:    " << hpaSeconds * 1000 / queries << " ms/query, " << hpaExpanded / queries << " entrances expanded, "
+              << flatSeconds / hpaSeconds << "x faster, " << mismatches << " length mismatches" << std::endl;
+
+    // Flip random interior walls; only the clusters on either side of each are rebuilt
+    std::uniform_int_distribution<int> anyDirection(0, 3);
+    size_t rebuilt = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < WALL_FLIPS; ++i) {
+        uint32_t cell = anyCell(rng);
+        Direction dir = DIRECTIONS[anyDirection(rng)];
+        solver.setPassage(cell, dir, !grid.isOpen(cell, dir));
+        solver.update();
+        rebuilt += solver.clustersRebuilt();
+    }
+    std::cout << WALL_FLIPS << " wall flips: " << secondsSince(start) * 1000 / WALL_FLIPS << " ms each, " << static_cast<double>(rebuilt) / WALL_FLIPS
+              << " clusters rebuilt each" << std::endl;
+    MAZE_TRACE_STOP();
+    return mismatches ? 1 : 0;
+}
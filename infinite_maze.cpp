@@ -0,0 +1,193 @@
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "chunk_world.h"
+
+// Endless maze explored on demand: chunks are generated as the camera reaches them and
+// evicted from a fixed-size cache behind it, so memory stays flat however far it scrolls
+const int WINDOW_SIZE = 800;
+const int CELL_SIZE = 8;
+const int CHUNK_SIZE = 32;
+const size_t DEFAULT_CACHE_KB = 1024;
+const int STEPS_PER_FRAME = 2;
+const int SEARCH_CHUNKS_BEHIND = 1; // Planning box around the navigator, in chunks
+const int SEARCH_CHUNKS_AHEAD = 2;
+const int SEARCH_CHUNKS_ABOVE = 2;
+
+struct WorldPoint {
+    int64_t x, y;
+};
+
+// Walks east forever, planning a few chunks at a time with a BFS over a bounded box
+class Explorer {
+public:
+    explicit Explorer(ChunkWorld& world) : world(world) {}
+
+    WorldPoint position() const { return navigator; }
+    uint64_t steps() const { return taken; }
+    const std::vector<WorldPoint>& route() const { return path; }
+
+    void step() {
+        if (next >= path.size()) plan();
+        if (next < path.size()) {
+            navigator = path[next++];
+            ++taken;
+        }
+    }
+
+private:
+    ChunkWorld& world;
+    WorldPoint navigator = {0, 0};
+    std::vector<WorldPoint> path;
+    size_t next = 0;
+    uint64_t taken = 0;
+
+    // BFS inside a box of chunks to any cell in the last chunk column ahead; the box grows
+    // vertically if that column cannot be reached inside it
+    void plan() {
+        path.clear();
+        next = 0;
+        int c = world.size();
+        ChunkKey here = world.chunkOf(navigator.x, navigator.y);
+        for (int above = SEARCH_CHUNKS_ABOVE; above <= 8 * SEARCH_CHUNKS_ABOVE && path.empty(); above *= 2) {
+            int64_t x0 = (here.cx - SEARCH_CHUNKS_BEHIND) * c, y0 = (here.cy - above) * c;
+            int w = (SEARCH_CHUNKS_BEHIND + SEARCH_CHUNKS_AHEAD + 1) * c, h = (2 * above + 1) * c;
+            int64_t goalX = (here.cx + SEARCH_CHUNKS_AHEAD) * c;
+
+            std::vector<int32_t> cameFrom(static_cast<size_t>(w) * h, -1);
+            std::vector<int32_t> queue;
+            int32_t source = static_cast<int32_t>((navigator.y - y0) * w + (navigator.x - x0));
+            cameFrom[source] = source;
+            queue.push_back(source);
+            int32_t found = -1;
+            for (size_t head = 0; head < queue.size() && found < 0; ++head) {
+                int32_t at = queue[head];
+                int lx = at % w, ly = at / w;
+                if (x0 + lx >= goalX) {
+                    found = at;
+                    break;
+                }
+                uint8_t open = world.cell(x0 + lx, y0 + ly);
+                const int dx[4] = {0, 0, 1, -1}, dy[4] = {-1, 1, 0, 0};
+                for (int d = 0; d < 4; ++d) {
+                    int nx = lx + dx[d], ny = ly + dy[d];
+                    if (!(open & DIRECTIONS[d]) || nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+                    int32_t n = ny * w + nx;
+                    if (cameFrom[n] >= 0) continue;
+                    cameFrom[n] = at;
+                    queue.push_back(n);
+                }
+            }
+            for (int32_t at = found; at >= 0 && at != source; at = cameFrom[at]) path.push_back({x0 + at % w, y0 + at / w});
+            std::reverse(path.begin(), path.end());
+        }
+    }
+};
+
+void drawWorld(SDL_Renderer* renderer, ChunkWorld& world, const Explorer& explorer) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+    SDL_RenderClear(renderer);
+
+    // Camera centred on the navigator
+    int cellsAcross = WINDOW_SIZE / CELL_SIZE;
+    WorldPoint nav = explorer.position();
+    int64_t left = nav.x - cellsAcross / 2, top = nav.y - cellsAcross / 2;
+    int c = world.size();
+
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE); // Walls color
+    ChunkKey first = world.chunkOf(left, top), last = world.chunkOf(left + cellsAcross, top + cellsAcross);
+    for (int64_t cy = first.cy; cy <= last.cy; ++cy) {
+        for (int64_t cx = first.cx; cx <= last.cx; ++cx) {
+            std::shared_ptr<const Grid> chunk = world.chunk({cx, cy}); // One cache lookup per chunk
+            for (int y = 0; y < c; ++y) {
+                for (int x = 0; x < c; ++x) {
+                    int px = static_cast<int>((cx * c + x - left) * CELL_SIZE), py = static_cast<int>((cy * c + y - top) * CELL_SIZE);
+                    if (px < -CELL_SIZE || py < -CELL_SIZE || px > WINDOW_SIZE || py > WINDOW_SIZE) continue;
+                    uint8_t open = chunk->cells[chunk->index(x, y)];
+                    // Each cell draws its north and west walls; the neighbours cover the rest
+                    if (!(open & NORTH)) SDL_RenderDrawLine(renderer, px, py, px + CELL_SIZE, py);
+                    if (!(open & WEST)) SDL_RenderDrawLine(renderer, px, py, px, py + CELL_SIZE);
+                }
+            }
+        }
+    }
+
+    SDL_SetRenderDrawColor(renderer, 0, 255, 0, SDL_ALPHA_OPAQUE); // Path color
+    for (const WorldPoint& p : explorer.route()) {
+        SDL_RenderDrawPoint(renderer, static_cast<int>((p.x - left) * CELL_SIZE + CELL_SIZE / 2), static_cast<int>((p.y - top) * CELL_SIZE + CELL_SIZE / 2));
+    }
+
+    SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE); // Navigator color
+    SDL_Rect navigator = {static_cast<int>((nav.x - left) * CELL_SIZE) + 2, static_cast<int>((nav.y - top) * CELL_SIZE) + 2, CELL_SIZE - 3, CELL_SIZE - 3};
+    SDL_RenderFillRect(renderer, &navigator);
+    SDL_RenderPresent(renderer);
+}
+
+void printStats(ChunkWorld& world, const Explorer& explorer) {
+    auto stats = world.cacheStats();
+    WorldPoint p = explorer.position();
+    std::cout << explorer.steps() << " steps, at (" << p.x << ", " << p.y << "): " << world.chunksGenerated() << " chunks generated, "
+              << stats.entries << " cached (" << stats.bytes / 1024 << " / " << stats.capacity / 1024 << " KB), " << stats.evictions
+              << " evictions" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t seed = 1;
+    size_t cacheKb = DEFAULT_CACHE_KB;
+    uint64_t headlessSteps = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i]);
+        else if (arg == "--cache-kb" && i + 1 < argc) cacheKb = std::stoull(argv[++i]);
+        else if (arg == "--headless" && i + 1 < argc) headlessSteps = std::stoull(argv[++i]);
+        else {
+            std::cerr << "Usage: infinite_maze [--seed n] [--cache-kb n] [--headless steps]" << std::endl;
+            return 1;
+        }
+    }
+
+    ChunkWorld world(seed, cacheKb * 1024, CHUNK_SIZE);
+    Explorer explorer(world);
+
+    // Without a window: walk the given number of steps and report cache behaviour
+    if (headlessSteps > 0) {
+        for (uint64_t i = 1; i <= headlessSteps; ++i) {
+            explorer.step();
+            if (i % (headlessSteps / 10 ? headlessSteps / 10 : 1) == 0) printStats(world, explorer);
+        }
+        return 0;
+    }
+
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    SDL_Window* window = SDL_CreateWindow("Infinite Maze", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_SIZE, WINDOW_SIZE, SDL_WINDOW_SHOWN);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    if (!window || !renderer) {
+        std::cerr << "SDL Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    bool quit = false;
+    bool paused = false;
+    SDL_Event e;
+    while (!quit) {
+        while (SDL_PollEvent(&e) != 0) {
+            if (e.type == SDL_QUIT) quit = true;
+            else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_SPACE) paused = !paused;
+        }
+        if (!paused) {
+            for (int i = 0; i < STEPS_PER_FRAME; ++i) explorer.step();
+        }
+        drawWorld(renderer, world, explorer);
+    }
+    printStats(world, explorer);
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,61 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free latency histogram in microseconds. Buckets are log-linear: each power of two
+// is split into 8 sub-buckets, so percentiles are accurate to about 12%.
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKETS = 8;
+    static const int BUCKETS = 40 * SUB_BUCKETS;
+
+    void record(uint64_t us) {
+        counts[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sumUs.fetch_add(us, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+
+    double meanUs() const {
+        uint64_t n = count();
+        return n ? static_cast<double>(sumUs.load(std::memory_order_relaxed)) / n : 0;
+    }
+
+    // Upper edge of the bucket holding the p-th fraction of samples
+    uint64_t percentileUs(double p) const {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(p * (n - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += counts[i].load(std::memory_order_relaxed);
+            if (seen >= target) return upperEdge(i);
+        }
+        return upperEdge(BUCKETS - 1);
+    }
+
+private:
+    std::atomic<uint64_t> counts[BUCKETS] = {};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sumUs{0};
+
+    static int bucketOf(uint64_t us) {
+        if (us < SUB_BUCKETS) return static_cast<int>(us);
+        int exponent = 63 - __builtin_clzll(us); // us >= 8, so exponent >= 3
+        int sub = static_cast<int>((us >> (exponent - 3)) & (SUB_BUCKETS - 1));
+        int bucket = (exponent - 2) * SUB_BUCKETS + sub;
+        return bucket < BUCKETS ? bucket : BUCKETS - 1;
+    }
+
+    static uint64_t upperEdge(int bucket) {
+        if (bucket < SUB_BUCKETS) return bucket + 1;
+        int exponent = bucket / SUB_BUCKETS + 2;
+        uint64_t sub = bucket % SUB_BUCKETS;
+        return ((SUB_BUCKETS + sub + 1) << (exponent - 3));
+    }
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+// Thread-safe least-recently-used cache bounded by the total byte size of its values.
+// Values are shared, so an entry evicted while a reader still holds it stays alive.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    explicit LruCache(size_t capacityBytes) : capacity(capacityBytes) {}
+
+    std::shared_ptr<const Value> get(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            ++misses;
+            return nullptr;
+        }
+        order.splice(order.begin(), order, it->second);
+        ++hits;
+        return it->second->value;
+    }
+
+    // Insert or replace; entries larger than the whole budget are not cached
+    void put(const Key& key, std::shared_ptr<const Value> value, size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            used -= it->second->bytes;
+            order.erase(it->second);
+            entries.erase(it);
+        }
+        if (bytes > capacity) return;
+
+        order.push_front({key, std::move(value), bytes});
+        entries[key] = order.begin();
+        used += bytes;
+        while (used > capacity) {
+            const Entry& victim = order.back();
+            used -= victim.bytes;
+            entries.erase(victim.key);
+            order.pop_back();
+            ++evictions;
+        }
+    }
+
+    struct Stats {
+        size_t entries, bytes, capacity, hits, misses, evictions;
+    };
+
+    Stats stats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return {entries.size(), used, capacity, hits, misses, evictions};
+    }
+
+private:
+    struct Entry {
+        Key key;
+        std::shared_ptr<const Value> value;
+        size_t bytes;
+    };
+
+    std::mutex mutex;
+    std::list<Entry> order; // Most recently used first
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> entries;
+    size_t capacity;
+    size_t used = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+};
+
+#endif
@@ -102,6 +102,7 @@ public:
 
     void moveNavigator(SDL_Renderer* renderer) {
         Point navigator = {0, 0}; // Starting position
+        size_t step = 0; // Index of the navigator on the path
         int alpha = 255; // For fading effect
         bool fadingOut = true;
 
@@ -141,7 +142,7 @@ public:
             SDL_Delay(100); // Delay for visualization speed
 
             // Move to the next step in the path
-            navigator = path[std::min(static_cast<size_t>(path.size() - 1), static_cast<size_t>(std::find(path.begin(), path.end(), navigator) - path.begin() + 1))];
+            navigator = path[std::min(path.size() - 1, ++step)];
         }
     }
 
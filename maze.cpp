@@ -7,64 +7,154 @@
 #include <cmath>
 #include <iostream>
 #include <climits> // Include for INT_MAX
+#include <cstdint>
+#include <thread>
+#include <atomic>
+#include <string>
+#include "spsc_queue.h"
+#include "maze_grid.h"
+#include "maze_dstar.h"
+#include "maze_path.h"
+#include "maze_log.h"
+#include "maze_profile.h"
+#include "maze_trace.h"
 
 // Maze generation and solving with SDL
 const int WINDOW_SIZE = 600;
 const int CELL_SIZE = 20;
 const int MAZE_SIZE = WINDOW_SIZE / CELL_SIZE;
 const int FADE_SPEED = 10; // Speed of fading effect
+const int EVENT_QUEUE_SIZE = 1 << 16; // Carve events buffered between generator and render thread
+const int MAX_EVENTS_PER_FRAME = 1 << 14; // Keeps each frame short while a large maze is streaming in
 
-enum Direction { NORTH = 1, SOUTH = 2, EAST = 4, WEST = 8 };
 std::random_device rd;
 std::mt19937 rng(rd());
 
-struct Point {
-    int x, y;
-
-    // Operator to compare two Points
-    bool operator==(const Point& other) const {
-        return x == other.x && y == other.y;
-    }
+// One carved passage, streamed from the generator thread to the render thread
+struct CarveEvent {
+    uint32_t cell; // Index of the cell the passage was carved from
+    uint8_t dir;   // Direction of the passage
+};
 
-    bool operator<(const Point& other) const {
-        return x < other.x || (x == other.x && y < other.y);
+// Drain pending window events; returns false once the window is closed.
+// Mouse clicks are collected in window coordinates when clicks is given.
+bool pollEvents(std::vector<Point>* clicks = nullptr) {
+    MAZE_PROFILE_SCOPE(PHASE_EVENTS);
+    MAZE_TRACE_SCOPE("events");
+    SDL_Event e;
+    bool running = true;
+    while (SDL_PollEvent(&e)) {
+        if (e.type == SDL_QUIT) running = false;
+        if (e.type == SDL_MOUSEBUTTONDOWN && clicks) clicks->push_back({e.button.x, e.button.y});
+        MAZE_PROFILE_KEY(e);
     }
-};
+    return running;
+}
 
 class Maze {
 public:
-    Maze(int size) : size(size), cells(size * size, 0) {
-        generateMaze();
+    Maze(int size) : size(size), cells(size * size, 0) {}
+
+    ~Maze() {
+        if (texture) SDL_DestroyTexture(texture);
+    }
+
+    // Write every carve, expansion and path cell to an event log for later replay
+    void record(EventLogWriter* writer) {
+        log = writer;
+    }
+
+    // Create the cached maze texture with every wall standing; carve events erase walls from it
+    bool createTexture(SDL_Renderer* renderer) {
+        texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, size * CELL_SIZE + 1, size * CELL_SIZE + 1);
+        if (!texture) {
+            std::cerr << "Failed to create maze texture: " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        SDL_SetRenderTarget(renderer, texture);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+        SDL_RenderClear(renderer);
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE); // Walls color
+        for (int i = 0; i <= size; ++i) {
+            SDL_RenderDrawLine(renderer, 0, i * CELL_SIZE, size * CELL_SIZE, i * CELL_SIZE);
+            SDL_RenderDrawLine(renderer, i * CELL_SIZE, 0, i * CELL_SIZE, size * CELL_SIZE);
+        }
+        SDL_SetRenderTarget(renderer, nullptr);
+        return true;
+    }
+
+    // Erase the wall removed by a carve event from the cached texture
+    void applyCarve(SDL_Renderer* renderer, const CarveEvent& event) {
+        drawWall(renderer, event.cell, static_cast<Direction>(event.dir), true);
+    }
+
+    // Erase (open) or redraw (closed) one wall in the cached texture; the texture must be the render target
+    void drawWall(SDL_Renderer* renderer, uint32_t cell, Direction dir, bool open) {
+        int nx = static_cast<int>(cell % size) * CELL_SIZE;
+        int ny = static_cast<int>(cell / size) * CELL_SIZE;
+
+        // Leave the corner pixels alone so neighbouring walls stay joined
+        if (open) SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+        else SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+        switch (dir) {
+            case NORTH: SDL_RenderDrawLine(renderer, nx + 1, ny, nx + CELL_SIZE - 1, ny); break;
+            case SOUTH: SDL_RenderDrawLine(renderer, nx + 1, ny + CELL_SIZE, nx + CELL_SIZE - 1, ny + CELL_SIZE); break;
+            case EAST: SDL_RenderDrawLine(renderer, nx + CELL_SIZE, ny + 1, nx + CELL_SIZE, ny + CELL_SIZE - 1); break;
+            case WEST: SDL_RenderDrawLine(renderer, nx, ny + 1, nx, ny + CELL_SIZE - 1); break;
+        }
+    }
+
+    // Drain up to MAX_EVENTS_PER_FRAME carve events into the cached texture
+    void drainCarves(SDL_Renderer* renderer, SpscQueue<CarveEvent>& events) {
+        MAZE_TRACE_SCOPE("drain carves");
+        SDL_SetRenderTarget(renderer, texture);
+        CarveEvent event;
+        int drained = 0;
+        while (drained < MAX_EVENTS_PER_FRAME && events.pop(event)) {
+            applyCarve(renderer, event);
+            ++drained;
+        }
+        MAZE_PROFILE_COUNT(COUNTER_DRAW_CALLS, drained);
+        SDL_SetRenderTarget(renderer, nullptr);
     }
 
     void draw(SDL_Renderer* renderer) {
+        drawScene(renderer);
+        present(renderer);
+    }
+
+    // Draw maze and path without presenting, so overlays can be added on top
+    void drawScene(SDL_Renderer* renderer) {
+        MAZE_PROFILE_SCOPE(PHASE_DRAW);
+        MAZE_TRACE_SCOPE("draw");
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE); // Set background to black
         SDL_RenderClear(renderer);
 
-        for (int y = 0; y < size; ++y) {
-            for (int x = 0; x < size; ++x) {
-                int cell = cells[y * size + x];
-                int nx = x * CELL_SIZE;
-                int ny = y * CELL_SIZE;
-
-                SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE); // Walls color
-                if (!(cell & NORTH)) SDL_RenderDrawLine(renderer, nx, ny, nx + CELL_SIZE, ny);
-                if (!(cell & EAST)) SDL_RenderDrawLine(renderer, nx + CELL_SIZE, ny, nx + CELL_SIZE, ny + CELL_SIZE);
-                if (!(cell & SOUTH)) SDL_RenderDrawLine(renderer, nx, ny + CELL_SIZE, nx + CELL_SIZE, ny + CELL_SIZE);
-                if (!(cell & WEST)) SDL_RenderDrawLine(renderer, nx, ny, nx, ny + CELL_SIZE);
-            }
-        }
+        SDL_Rect dst = {0, 0, size * CELL_SIZE + 1, size * CELL_SIZE + 1};
+        SDL_RenderCopy(renderer, texture, nullptr, &dst);
 
         // Draw the path once after generating the maze
         SDL_SetRenderDrawColor(renderer, 0, 255, 0, SDL_ALPHA_OPAQUE); // Path color
         for (const auto& p : path) {
             SDL_RenderDrawPoint(renderer, p.x * CELL_SIZE + CELL_SIZE / 2, p.y * CELL_SIZE + CELL_SIZE / 2);
         }
+        MAZE_PROFILE_COUNT(COUNTER_DRAW_CALLS, 2 + path.size());
+    }
 
-        SDL_RenderPresent(renderer);
+    void present(SDL_Renderer* renderer) {
+        MAZE_PROFILE_HUD(renderer);
+        {
+            MAZE_PROFILE_SCOPE(PHASE_PRESENT);
+            MAZE_TRACE_SCOPE("present");
+            SDL_RenderPresent(renderer);
+        }
+        MAZE_PROFILE_FRAME();
     }
 
     void solveMaze(SDL_Renderer* renderer) {
+        MAZE_PROFILE_SCOPE(PHASE_SOLVE);
+        MAZE_TRACE_SCOPE("solve");
         // A* algorithm to find the path
         std::priority_queue<std::pair<int, Point>, std::vector<std::pair<int, Point>>, std::greater<>> openSet;
         std::vector<int> dist(size * size, INT_MAX);
@@ -75,7 +165,9 @@ public:
         while (!openSet.empty()) {
             Point p = openSet.top().second;
             openSet.pop();
+            MAZE_PROFILE_COUNT(COUNTER_NODES_EXPANDED, 1);
 
+            if (log) log->visit(p.y * size + p.x);
             if (p.x == size - 1 && p.y == size - 1) break; // End reached
 
             std::vector<Point> neighbors = getNeighbors(p);
@@ -89,41 +181,101 @@ public:
             }
         }
 
-        // Store the path for visualization
-        path.clear();
-        Point current = {size - 1, size - 1};
-        while (!(current.x == 0 && current.y == 0)) {
-            path.push_back(current);
-            current = cameFrom[current.y * size + current.x];
+        // Store the path for visualization: count its steps, then fill the moves from the end
+        Point goal = {size - 1, size - 1};
+        size_t steps = 0;
+        for (Point current = goal; !(current.x == 0 && current.y == 0); current = cameFrom[current.y * size + current.x]) ++steps;
+        path.reset({0, 0}, steps);
+        for (Point current = goal; steps > 0;) {
+            Point previous = cameFrom[current.y * size + current.x];
+            path.setMove(--steps, directionTo(previous, current));
+            current = previous;
+        }
+        path.setEnd(goal);
+        if (log) {
+            for (const auto& p : path) log->path(p.y * size + p.x);
         }
-        path.push_back({0, 0}); // Add the start point
-        std::reverse(path.begin(), path.end()); // Reverse to start from the beginning
     }
 
-    void moveNavigator(SDL_Renderer* renderer) {
+    // Open or close one wall at runtime; while the navigator runs, its planner repairs the route
+    void toggleWall(SDL_Renderer* renderer, Point p, Direction dir) {
+        int nx = p.x, ny = p.y;
+        if (!move(nx, ny, dir)) return; // Outer walls stay
+        bool open = !(cells[p.y * size + p.x] & dir);
+        if (open) {
+            cells[p.y * size + p.x] |= dir;
+            cells[ny * size + nx] |= opposite(dir);
+        } else {
+            cells[p.y * size + p.x] &= ~dir;
+            cells[ny * size + nx] &= ~opposite(dir);
+        }
+        if (planner) planner->setPassage(static_cast<uint32_t>(p.y * size + p.x), dir, open);
+
+        SDL_SetRenderTarget(renderer, texture);
+        drawWall(renderer, static_cast<uint32_t>(p.y * size + p.x), dir, open);
+        SDL_SetRenderTarget(renderer, nullptr);
+    }
+
+    // Returns false if the window was closed before the navigator reached the end.
+    // Clicking near a wall toggles it; D* Lite repairs the route without a full re-solve.
+    bool moveNavigator(SDL_Renderer* renderer) {
         Point navigator = {0, 0}; // Starting position
         int alpha = 255; // For fading effect
         bool fadingOut = true;
 
+        Grid grid(size, size);
+        for (size_t i = 0; i < cells.size(); ++i) grid.cells[i] = static_cast<uint8_t>(cells[i]);
+        uint32_t goal = grid.index(size - 1, size - 1);
+        DStarLite dstar(grid, 0, goal);
+        planner = &dstar;
+        std::vector<Point> clicks;
+
         while (navigator.x != size - 1 || navigator.y != size - 1) {
+            MAZE_TRACE_SCOPE("navigator frame");
+            clicks.clear();
+            if (!pollEvents(&clicks)) {
+                planner = nullptr;
+                return false;
+            }
+            for (const Point& click : clicks) {
+                Point cell;
+                Direction dir;
+                if (wallAt(click, cell, dir)) toggleWall(renderer, cell, dir);
+            }
+
+            // Replan from the navigator's cell; only cells affected by toggled walls are revisited
+            uint32_t at = grid.index(navigator.x, navigator.y);
+            {
+                MAZE_PROFILE_SCOPE(PHASE_SOLVE);
+                MAZE_TRACE_SCOPE("replan");
+                dstar.moveStart(at);
+                dstar.computePath();
+                MAZE_PROFILE_COUNT(COUNTER_NODES_EXPANDED, dstar.cellsExpanded());
+            }
+            dstar.path(path);
+
             SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE); // Clear background
-            draw(renderer); // Draw maze and path
-
-            SDL_SetRenderDrawColor(renderer, 255, 0, 0, alpha); // Color for the navigator (circle)
-            int radius = CELL_SIZE / 4;
-
-            // Draw the navigator as a circle
-            for (int w = 0; w < 2 * radius; w++) {
-                for (int h = 0; h < 2 * radius; h++) {
-                    int dx = radius - w; // horizontal offset
-                    int dy = radius - h; // vertical offset
-                    if ((dx * dx + dy * dy) <= (radius * radius)) {
-                        SDL_RenderDrawPoint(renderer, navigator.x * CELL_SIZE + dx, navigator.y * CELL_SIZE + dy);
+            drawScene(renderer); // Draw maze and path
+
+            {
+                MAZE_PROFILE_SCOPE(PHASE_DRAW);
+                SDL_SetRenderDrawColor(renderer, 255, 0, 0, alpha); // Color for the navigator (circle)
+                int radius = CELL_SIZE / 4;
+
+                // Draw the navigator as a circle
+                for (int w = 0; w < 2 * radius; w++) {
+                    for (int h = 0; h < 2 * radius; h++) {
+                        int dx = radius - w; // horizontal offset
+                        int dy = radius - h; // vertical offset
+                        if ((dx * dx + dy * dy) <= (radius * radius)) {
+                            SDL_RenderDrawPoint(renderer, navigator.x * CELL_SIZE + dx, navigator.y * CELL_SIZE + dy);
+                            MAZE_PROFILE_COUNT(COUNTER_DRAW_CALLS, 1);
+                        }
                     }
                 }
             }
 
-            SDL_RenderPresent(renderer);
+            present(renderer);
 
             // Update alpha for fade effect
             if (fadingOut) {
@@ -140,21 +292,23 @@ public:
 
             SDL_Delay(100); // Delay for visualization speed
 
-            // Move to the next step in the path
-            navigator = path[std::min(static_cast<size_t>(path.size() - 1), static_cast<size_t>(std::find(path.begin(), path.end(), navigator) - path.begin() + 1))];
+            // Move to the next step of the repaired path (wait in place while walled in)
+            navigator = grid.point(dstar.nextStep(at));
         }
+        planner = nullptr;
+        return true;
     }
 
-private:
-    int size;
-    std::vector<int> cells;
-    std::vector<Point> path; // Path from start to end
-
-    void generateMaze() {
+    // Runs on the generator thread; every carved passage is pushed to the render thread (if any).
+    // Setting cancel stops it early, even while it waits for room in the queue.
+    void generateMaze(SpscQueue<CarveEvent>* events, const std::atomic<bool>* cancel = nullptr) {
+        MAZE_PROFILE_SCOPE(PHASE_GENERATE);
+        MAZE_TRACE_SCOPE("generate");
         std::stack<Point> stack;
         stack.push({0, 0});
 
         while (!stack.empty()) {
+            if (cancel && cancel->load(std::memory_order_relaxed)) return;
             Point p = stack.top();
             stack.pop();
 
@@ -167,11 +321,41 @@ private:
                     cells[p.y * size + p.x] |= dir;
                     cells[ny * size + nx] |= opposite(dir);
                     stack.push({nx, ny});
+                    MAZE_PROFILE_COUNT(COUNTER_CELLS_CARVED, 1);
+
+                    CarveEvent event = {static_cast<uint32_t>(p.y * size + p.x), static_cast<uint8_t>(dir)};
+                    if (log) log->carve(event.cell, dir);
+                    while (events && !events->push(event)) {
+                        if (cancel && cancel->load(std::memory_order_relaxed)) return; // Window closed
+                        std::this_thread::yield(); // Render thread is behind
+                    }
                 }
             }
         }
     }
 
+private:
+    int size;
+    std::vector<int> cells;
+    PackedPath path; // Path from start to end, 2 bits per step
+    SDL_Texture* texture = nullptr; // Cached maze walls, updated incrementally
+    EventLogWriter* log = nullptr;
+    DStarLite* planner = nullptr; // Set while the navigator is running
+
+    // Map a window position to the nearest wall of the cell under it
+    bool wallAt(Point pixel, Point& cell, Direction& dir) {
+        cell = {pixel.x / CELL_SIZE, pixel.y / CELL_SIZE};
+        if (cell.x < 0 || cell.y < 0 || cell.x >= size || cell.y >= size) return false;
+        int left = pixel.x % CELL_SIZE, top = pixel.y % CELL_SIZE;
+        int right = CELL_SIZE - left, bottom = CELL_SIZE - top;
+        int nearest = std::min({left, top, right, bottom});
+        if (nearest == top) dir = NORTH;
+        else if (nearest == bottom) dir = SOUTH;
+        else if (nearest == left) dir = WEST;
+        else dir = EAST;
+        return true;
+    }
+
     bool move(int& x, int& y, Direction dir) {
         switch (dir) {
             case NORTH: if (y > 0) --y; else return false; break;
@@ -207,23 +391,83 @@ private:
 };
 
 int main(int argc, char* argv[]) {
+    std::string recordPath;
+    std::string tracePath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) recordPath = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc) tracePath = argv[++i];
+    }
+
+#ifdef MAZE_TRACE
+    if (!tracePath.empty()) MAZE_TRACE_START(tracePath);
+    MAZE_TRACE_THREAD("main");
+#else
+    if (!tracePath.empty()) std::cerr << "Tracing is not compiled in; rebuild with -DMAZE_TRACE" << std::endl;
+#endif
+
+    // Recording runs headless at full speed; play the log back with maze_replay
+    if (!recordPath.empty()) {
+        EventLogWriter log;
+        if (!log.open(recordPath, Grid(MAZE_SIZE, MAZE_SIZE))) {
+            std::cerr << "Failed to open event log: " << recordPath << std::endl;
+            return 1;
+        }
+        Maze maze(MAZE_SIZE);
+        maze.record(&log);
+        maze.generateMaze(nullptr);
+        maze.solveMaze(nullptr);
+        log.close();
+        MAZE_TRACE_STOP();
+        std::cout << "Recorded generation and solve to " << recordPath << std::endl;
+        return 0;
+    }
+
     SDL_Init(SDL_INIT_VIDEO);
     SDL_Window* window = SDL_CreateWindow("Maze Generator and Solver", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_SIZE, WINDOW_SIZE, SDL_WINDOW_SHOWN);
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
 
     Maze maze(MAZE_SIZE);
-    maze.draw(renderer);
-    SDL_Delay(2000);
-    maze.solveMaze(renderer);
-    maze.moveNavigator(renderer);
+    if (!maze.createTexture(renderer)) return -1;
+
+    // Generate on a worker thread and stream carve events into the cached texture,
+    // so the first frame is drawn immediately whatever the maze size
+    SpscQueue<CarveEvent> events(EVENT_QUEUE_SIZE);
+    std::atomic<bool> generated(false), cancelled(false);
+    std::thread generator([&] {
+        MAZE_TRACE_THREAD("generator");
+        maze.generateMaze(&events, &cancelled);
+        generated.store(true, std::memory_order_release);
+    });
 
-    SDL_Event e;
     bool quit = false;
     while (!quit) {
-        while (SDL_PollEvent(&e)) {
-            if (e.type == SDL_QUIT) quit = true;
-        }
+        MAZE_TRACE_SCOPE("frame");
+        quit = !pollEvents();
+        bool done = generated.load(std::memory_order_acquire);
+        maze.drainCarves(renderer, events);
+        maze.draw(renderer);
+        if (done && events.empty()) break;
+        SDL_Delay(16);
+    }
+    // Nothing pops the queue once the loop is left, so a generator still running must stop
+    cancelled.store(true, std::memory_order_relaxed);
+    generator.join();
+
+    if (!quit) {
+        SDL_Delay(2000);
+        maze.solveMaze(renderer);
+        quit = !maze.moveNavigator(renderer);
+    }
+
+    while (!quit) {
+        MAZE_TRACE_SCOPE("frame");
+        quit = !pollEvents();
+        maze.draw(renderer);
+        SDL_Delay(16);
     }
+    MAZE_PROFILE_DUMP("maze_profile.json");
+    MAZE_TRACE_STOP();
 
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
@@ -4,8 +4,12 @@
 #include <stack>
 #include <cstdlib>
 #include <ctime>
+#include <string>
 #include <algorithm> // Include for std::shuffle
 #include <random>    // Include for random number generator
+#include "maze_log.h"
+#include "maze_steps.h"
+#include "maze_trace.h"
 
 // Constants for window and maze dimensions
 const int WINDOW_WIDTH = 800;
@@ -18,6 +22,9 @@ const int MAZE_HEIGHT = WINDOW_HEIGHT / CELL_SIZE;
 const int DX[4] = {1, -1, 0, 0};
 const int DY[4] = {0, 0, 1, -1};
 
+// Direction of each DX/DY index in the shared grid layout, used when recording
+const Direction LOG_DIRS[4] = {EAST, WEST, SOUTH, NORTH};
+
 // Cell structure to represent each cell in the maze
 struct Cell {
     bool visited = false;
@@ -31,6 +38,9 @@ std::vector<std::vector<Cell>> maze(MAZE_WIDTH, std::vector<Cell>(MAZE_HEIGHT));
 SDL_Window* window = nullptr;
 SDL_Renderer* renderer = nullptr;
 
+// Optional event log of every step, written with --record
+EventLogWriter eventLog;
+
 // Function to initialize SDL
 bool initSDL() {
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
@@ -65,6 +75,8 @@ void SDL_RenderDrawCircle(SDL_Renderer* renderer, int x, int y, int radius) {
 
 // Function to draw the maze and the solver circle
 void drawMaze(int currentX = -1, int currentY = -1) {
+    if (!renderer) return; // Headless while recording
+    MAZE_TRACE_SCOPE("drawMaze");
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
@@ -102,6 +114,7 @@ void drawMaze(int currentX = -1, int currentY = -1) {
 
 // Function to generate the maze using a depth-first search algorithm
 void generateMaze() {
+    MAZE_TRACE_SCOPE("generate");
     std::srand(std::time(0));
     std::stack<std::pair<int, int>> stack;
     int x = 0, y = 0;
@@ -123,6 +136,7 @@ void generateMaze() {
             if (nx >= 0 && ny >= 0 && nx < MAZE_WIDTH && ny < MAZE_HEIGHT && !maze[nx][ny].visited) {
                 maze[cx][cy].walls[i] = false;
                 maze[nx][ny].walls[i ^ 1] = false;
+                eventLog.carve(cy * MAZE_WIDTH + cx, LOG_DIRS[i]);
                 maze[nx][ny].visited = true;
                 stack.push({nx, ny});
                 moved = true;
@@ -133,29 +147,53 @@ void generateMaze() {
     }
 }
 
-// Function to solve the maze visually
-bool solveMaze(int x, int y) {
-    if (x == MAZE_WIDTH - 1 && y == MAZE_HEIGHT - 1) {
-        maze[x][y].path = true;
-        return true;
-    }
-
-    maze[x][y].path = true;
+// Function to show one solver step and hold it on screen; skipped when running headless
+void showStep(int x, int y) {
+    if (!renderer) return;
     drawMaze(x, y);
+    MAZE_TRACE_SCOPE("delay");
     SDL_Delay(50); // Delay for visual effect
+}
 
-    for (int i = 0; i < 4; ++i) {
-        int nx = x + DX[i];
-        int ny = y + DY[i];
-        if (nx >= 0 && ny >= 0 && nx < MAZE_WIDTH && ny < MAZE_HEIGHT && !maze[nx][ny].path && !maze[x][y].walls[i]) {
-            if (solveMaze(nx, ny)) return true;
+// Function to solve the maze as a coroutine: depth-first with an explicit stack, marking
+// each cell it enters as path and unmarking the ones it backs out of. It yields a step for
+// each and leaves recording, drawing and pacing to the caller (maze_steps.h).
+StepGenerator solveSteps(StepArena&, int startX, int startY) {
+    struct Visit {
+        int x, y;
+        int next; // Next direction to try
+    };
+    std::vector<Visit> stack = {{startX, startY, 0}};
+    maze[startX][startY].path = true;
+    co_yield Step{LOG_PATH, NORTH, static_cast<uint32_t>(startY * MAZE_WIDTH + startX)};
+    while (!stack.empty()) {
+        int x = stack.back().x, y = stack.back().y;
+        if (x == MAZE_WIDTH - 1 && y == MAZE_HEIGHT - 1) co_return;
+
+        int found = -1;
+        while (found < 0 && stack.back().next < 4) {
+            int i = stack.back().next++;
+            int nx = x + DX[i];
+            int ny = y + DY[i];
+            if (nx >= 0 && ny >= 0 && nx < MAZE_WIDTH && ny < MAZE_HEIGHT && !maze[nx][ny].path && !maze[x][y].walls[i]) found = i;
+        }
+        if (found >= 0) {
+            int nx = x + DX[found], ny = y + DY[found];
+            maze[nx][ny].path = true;
+            stack.push_back({nx, ny, 0});
+            co_yield Step{LOG_PATH, LOG_DIRS[found], static_cast<uint32_t>(ny * MAZE_WIDTH + nx)};
+        } else {
+            maze[x][y].path = false;
+            stack.pop_back();
+            co_yield Step{LOG_CLEAR, NORTH, static_cast<uint32_t>(y * MAZE_WIDTH + x)};
         }
     }
+}
 
-    maze[x][y].path = false;
-    drawMaze(x, y);
-    SDL_Delay(50); // Delay for visual effect
-    return false;
+// Function to record one solver step; a no-op unless --record is on
+void recordStep(const Step& step) {
+    if (step.event == LOG_PATH) eventLog.path(step.cell);
+    else if (step.event == LOG_CLEAR) eventLog.clear(step.cell);
 }
 
 // Function to clean up SDL resources
@@ -165,16 +203,52 @@ void cleanUp() {
     SDL_Quit();
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    std::string recordPath;
+    std::string tracePath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) recordPath = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc) tracePath = argv[++i];
+    }
+
+#ifdef MAZE_TRACE
+    if (!tracePath.empty()) MAZE_TRACE_START(tracePath);
+    MAZE_TRACE_THREAD("main");
+#else
+    if (!tracePath.empty()) std::cerr << "Tracing is not compiled in; rebuild with -DMAZE_TRACE" << std::endl;
+#endif
+
+    // Recording runs headless at full speed; play the log back with maze_replay
+    if (!recordPath.empty()) {
+        if (!eventLog.open(recordPath, Grid(MAZE_WIDTH, MAZE_HEIGHT))) {
+            std::cerr << "Failed to open event log: " << recordPath << std::endl;
+            return 1;
+        }
+        generateMaze();
+        {
+            MAZE_TRACE_SCOPE("solve");
+            StepArena arena;
+            StepGenerator solver = solveSteps(arena, 0, 0);
+            while (solver.next()) {
+                for (const Step& step : solver) recordStep(step);
+            }
+        }
+        eventLog.close();
+        MAZE_TRACE_STOP();
+        std::cout << "Recorded generation and solve to " << recordPath << std::endl;
+        return 0;
+    }
+
     if (!initSDL()) return -1;
 
     generateMaze();
     drawMaze();
 
-    // Solve the maze visually
-    solveMaze(0, 0);
-
-    bool running = true;
+    // Solve the maze visually, one step per frame, still answering window events
+    StepArena arena;
+    StepGenerator solver = solveSteps(arena, 0, 0);
+    bool running = true, solving = true;
     SDL_Event event;
     while (running) {
         while (SDL_PollEvent(&event)) {
@@ -182,7 +256,15 @@ int main() {
                 running = false;
             }
         }
+        if (running && solving && (solving = solver.next())) {
+            MAZE_TRACE_SCOPE("solve");
+            for (const Step& step : solver) {
+                recordStep(step);
+                showStep(step.cell % MAZE_WIDTH, step.cell / MAZE_WIDTH);
+            }
+        }
     }
+    MAZE_TRACE_STOP();
 
     cleanUp();
     return 0;
@@ -0,0 +1,199 @@
+#ifndef MAZE_ALT_H
+#define MAZE_ALT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "maze_grid.h"
+#include "maze_solvers.h"
+#include "radix_heap.h"
+
+// ALT (A*, landmarks, triangle inequality) for repeated queries on one maze.
+//
+// Preprocessing picks k landmarks by farthest-point selection: each one is the cell
+// farthest from every landmark chosen so far, so they end up spread around the edges of
+// the maze. The exact distance from every landmark to every cell is kept. Then for any
+// landmark L, d(L, goal) - d(L, cell) and d(cell, L) - d(goal, L) are lower bounds on
+// d(cell, goal). The largest bound over the landmarks is a consistent heuristic, and on a
+// tree-like maze it is far tighter than the Manhattan distance.
+//
+// Tables are cell-major (the k distances of one cell are adjacent), so evaluating the
+// heuristic touches one cache line. They use 16 bits per entry when every distance fits
+// and 32 bits otherwise. Each query uses only the few landmarks that give the best bound
+// for its endpoints. Terrain costs (Grid::cost) are honoured, and the grid must not change
+// after the index is built.
+class LandmarkIndex {
+public:
+    static constexpr uint32_t UNREACHED = UINT32_MAX;
+    static constexpr int ACTIVE_LANDMARKS = 4;
+
+    LandmarkIndex(const Grid& grid, int landmarks) : grid(grid), count(std::max(1, landmarks)) {
+        std::vector<uint32_t> distance, nearest(grid.size(), UNREACHED);
+        std::vector<std::vector<uint32_t>> tables;
+        uint32_t next = farthest(computeDistances(0, distance), distance);
+        uint32_t largest = 0;
+        for (int i = 0; i < count; ++i) {
+            chosen.push_back(next);
+            computeDistances(next, distance);
+            for (uint32_t cell = 0; cell < grid.size(); ++cell) {
+                nearest[cell] = std::min(nearest[cell], distance[cell]);
+                if (distance[cell] != UNREACHED) largest = std::max(largest, distance[cell]);
+            }
+            tables.push_back(distance);
+            next = farthest(next, nearest);
+        }
+
+        // Interleave per cell, narrowing to 16 bits when possible (all ones stays unreachable)
+        wide = largest >= UINT16_MAX;
+        size_t entries = static_cast<size_t>(grid.size()) * count;
+        if (wide) table32.resize(entries);
+        else table16.resize(entries);
+        for (uint32_t cell = 0; cell < grid.size(); ++cell) {
+            for (int i = 0; i < count; ++i) {
+                uint32_t d = tables[i][cell];
+                if (wide) table32[static_cast<size_t>(cell) * count + i] = d;
+                else table16[static_cast<size_t>(cell) * count + i] = static_cast<uint16_t>(d == UNREACHED ? UINT16_MAX : d);
+            }
+        }
+        minimumCost = cheapestCost(grid);
+    }
+
+    const std::vector<uint32_t>& landmarks() const { return chosen; }
+    size_t bytesPerLandmark() const { return static_cast<size_t>(grid.size()) * (wide ? 4 : 2); }
+    size_t memoryBytes() const { return bytesPerLandmark() * count; }
+
+    // Distance from landmark i to cell, UNREACHED if there is no path
+    uint32_t landmarkDistance(uint32_t cell, int i) const {
+        size_t at = static_cast<size_t>(cell) * count + i;
+        if (wide) return table32[at];
+        return table16[at] == UINT16_MAX ? UNREACHED : table16[at];
+    }
+
+    // A* from start to goal with the landmark bound (and the Manhattan bound, whichever is
+    // larger) on a radix heap; same contract as the solvers in maze_solvers.h
+    bool findPath(uint32_t start, uint32_t goal, SolveResult& result) const {
+        // The landmarks giving the best bound between the endpoints do most of the work
+        std::vector<std::pair<uint32_t, int>> ranked;
+        for (int i = 0; i < count; ++i) ranked.push_back({bound(start, goal, i), i});
+        std::sort(ranked.rbegin(), ranked.rend());
+        int active = std::min(count, ACTIVE_LANDMARKS);
+        uint32_t goalDistance[ACTIVE_LANDMARKS];
+        int activeIndex[ACTIVE_LANDMARKS];
+        for (int a = 0; a < active; ++a) {
+            activeIndex[a] = ranked[a].second;
+            goalDistance[a] = landmarkDistance(goal, activeIndex[a]);
+        }
+        // Terrain costs are paid on entering a cell, so d(cell, L) = d(L, cell) - cost(cell) + cost(L)
+        int64_t goalCost = grid.cost(goal);
+        auto heuristic = [&](uint32_t cell) {
+            int64_t h = manhattan(grid, cell, goal) * minimumCost;
+            int64_t cellCost = grid.cost(cell);
+            for (int a = 0; a < active; ++a) {
+                uint32_t d = landmarkDistance(cell, activeIndex[a]);
+                if (d == UNREACHED || goalDistance[a] == UNREACHED) continue;
+                int64_t forward = static_cast<int64_t>(goalDistance[a]) - d;   // d(L, goal) <= d(L, cell) + d(cell, goal)
+                int64_t backward = static_cast<int64_t>(d) - goalDistance[a] - cellCost + goalCost; // via d(cell, L)
+                h = std::max(h, std::max(forward, backward));
+            }
+            return static_cast<uint32_t>(h);
+        };
+
+        const uint32_t INF = UINT32_MAX;
+        std::vector<uint32_t> gScore(grid.size(), INF);
+        std::vector<uint8_t> parent(grid.size(), 0);
+        RadixHeap<uint32_t> open;
+        size_t peakQueue = 0;
+        gScore[start] = 0;
+        open.push(heuristic(start), start);
+        bool found = false;
+        while (!open.empty()) {
+            auto [key, cell] = open.pop();
+            uint32_t g = gScore[cell];
+            if (key != g + heuristic(cell)) continue; // Stale entry
+            ++result.expanded;
+            if (cell == goal) {
+                found = true;
+                break;
+            }
+            for (Direction dir : DIRECTIONS) {
+                uint32_t next = 0;
+                if (!grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, next)) continue;
+                uint32_t cost = g + grid.cost(next);
+                if (cost < gScore[next]) {
+                    gScore[next] = cost;
+                    parent[next] = opposite(dir);
+                    open.push(cost + heuristic(next), next);
+                }
+            }
+            if ((result.expanded & 1023) == 0) peakQueue = std::max(peakQueue, open.memoryBytes());
+        }
+        result.peakBytes = bufferBytes(gScore) + bufferBytes(parent) + std::max(peakQueue, open.memoryBytes());
+        if (found) tracePath(grid, parent, start, goal, result.path);
+        return found;
+    }
+
+private:
+    const Grid& grid;
+    int count;
+    bool wide = false;
+    uint32_t minimumCost = 1;
+    std::vector<uint32_t> chosen;
+    std::vector<uint16_t> table16;
+    std::vector<uint32_t> table32;
+
+    uint32_t bound(uint32_t a, uint32_t b, int i) const {
+        uint32_t da = landmarkDistance(a, i), db = landmarkDistance(b, i);
+        if (da == UNREACHED || db == UNREACHED) return 0;
+        return da > db ? da - db : db - da;
+    }
+
+    // Reachable cell with the largest distance (fallback when nothing is reachable)
+    uint32_t farthest(uint32_t fallback, const std::vector<uint32_t>& distance) const {
+        uint32_t best = fallback, bestDistance = 0;
+        for (uint32_t cell = 0; cell < grid.size(); ++cell) {
+            if (distance[cell] != UNREACHED && distance[cell] > bestDistance) {
+                best = cell;
+                bestDistance = distance[cell];
+            }
+        }
+        return best;
+    }
+
+    // Distances from source to every cell: breadth-first without terrain, Dijkstra on a
+    // radix heap with it. Returns source for chaining.
+    uint32_t computeDistances(uint32_t source, std::vector<uint32_t>& distance) const {
+        distance.assign(grid.size(), UNREACHED);
+        distance[source] = 0;
+        if (grid.costs.empty()) {
+            std::vector<uint32_t> queue = {source};
+            queue.reserve(grid.size());
+            for (size_t head = 0; head < queue.size(); ++head) {
+                uint32_t cell = queue[head];
+                for (Direction dir : DIRECTIONS) {
+                    uint32_t next = 0;
+                    if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next) && distance[next] == UNREACHED) {
+                        distance[next] = distance[cell] + 1;
+                        queue.push_back(next);
+                    }
+                }
+            }
+            return source;
+        }
+        RadixHeap<uint32_t> open;
+        open.push(0, source);
+        while (!open.empty()) {
+            auto [d, cell] = open.pop();
+            if (d != distance[cell]) continue;
+            for (Direction dir : DIRECTIONS) {
+                uint32_t next = 0;
+                if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next) && d + grid.cost(next) < distance[next]) {
+                    distance[next] = d + grid.cost(next);
+                    open.push(distance[next], next);
+                }
+            }
+        }
+        return source;
+    }
+};
+
+#endif
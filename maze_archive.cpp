@@ -0,0 +1,154 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include "maze_archive.h"
+#include "maze_io.h"
+#include "maze_solvers.h"
+#include "maze_trace.h"
+
+// Tile-compressed maze archives (maze_archive.h):
+//   maze_archive pack <in.maze> <out.mza> [--tile n] [--threads n]
+//   maze_archive unpack <in.mza> <out.maze> [--threads n] [--bits 2|4]
+//   maze_archive info <in.mza>
+//   maze_archive solve <in.mza> <x> <y> <w> <h> [--threads n]
+// Every command also takes --trace file (build with -DMAZE_TRACE) to record the tile workers.
+// solve decodes only the tiles under the region and finds the shortest path between its
+// top-left and bottom-right cells inside the region.
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int pack(const std::string& in, const std::string& out, int tileSize, int threads) {
+    MazeFileReader reader;
+    if (!reader.open(in)) {
+        std::cerr << "Cannot read maze file: " << in << std::endl;
+        return 1;
+    }
+    ArchiveWriter writer;
+    if (!writer.open(out, reader.width(), reader.height(), tileSize, threads)) {
+        std::cerr << "Cannot write archive: " << out << std::endl;
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> row;
+    bool ok = true;
+    for (int y = 0; ok && y < reader.height(); ++y) ok = reader.readRow(row) && writer.addRow(row.data());
+    uint64_t bytes = writer.compressedBytes();
+    ok = writer.close() && ok;
+    double seconds = secondsSince(start);
+    double cells = static_cast<double>(reader.cellCount());
+    double bitsPerCell = 8.0 * bytes / cells;
+    std::cout << reader.width() << "x" << reader.height() << " in " << tileSize << "-cell tiles: " << bytes << " bytes, " << bitsPerCell
+              << " bits per cell (" << bitsPerCell / 2 * 100 << "% of packed), " << seconds << " s, " << cells / seconds / 1e6 << " Mcells/s"
+              << (ok ? "" : ", FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
+
+int unpack(const std::string& in, const std::string& out, int threads, int bits) {
+    ArchiveReader archive;
+    if (!archive.open(in)) {
+        std::cerr << "Cannot read archive: " << in << std::endl;
+        return 1;
+    }
+    MazeFileWriter writer;
+    if (!writer.open(out, archive.width(), archive.height(), bits)) {
+        std::cerr << "Cannot write maze file: " << out << std::endl;
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    int width = archive.width(), tile = archive.tileSize();
+    std::vector<std::shared_ptr<const ArchiveReader::Tile>> band(archive.tilesAcross());
+    std::vector<uint8_t> row(width), south(width, 0);
+    bool ok = true;
+    for (int ty = 0; ok && ty < archive.tilesDown(); ++ty) {
+        forEachParallel(band.size(), threads, [&](size_t tx) { band[tx] = archive.tile(static_cast<int>(tx), ty); });
+        for (const auto& decoded : band) ok = ok && decoded;
+        int rows = std::min(tile, archive.height() - ty * tile);
+        for (int r = 0; ok && r < rows; ++r) {
+            uint8_t westOpen = 0;
+            for (int x = 0; x < width; ++x) {
+                int tx = x / tile, tileWidth = std::min(tile, width - tx * tile);
+                uint8_t bits = (*band[tx])[static_cast<size_t>(r) * tileWidth + (x - tx * tile)];
+                row[x] = (south[x] ? NORTH : 0) | westOpen | ((bits & 1) ? EAST : 0) | ((bits & 2) ? SOUTH : 0);
+                westOpen = (bits & 1) ? WEST : 0;
+                south[x] = bits & 2;
+            }
+            ok = writer.writeRow(row.data());
+        }
+    }
+    ok = writer.close() && ok;
+    double seconds = secondsSince(start);
+    std::cout << "unpacked " << archive.width() << "x" << archive.height() << " in " << seconds << " s, "
+              << static_cast<double>(archive.width()) * archive.height() / seconds / 1e6 << " Mcells/s" << (ok ? "" : ", FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
+
+int info(const std::string& in) {
+    ArchiveReader archive;
+    if (!archive.open(in)) {
+        std::cerr << "Cannot read archive: " << in << std::endl;
+        return 1;
+    }
+    std::cout << archive.width() << "x" << archive.height() << ", " << archive.tileSize() << "-cell tiles (" << archive.tilesAcross() << "x"
+              << archive.tilesDown() << "), " << archive.fileBytes() << " bytes, " << archive.bitsPerCell() << " bits per cell" << std::endl;
+    return 0;
+}
+
+int solve(const std::string& in, int x, int y, int w, int h, int threads) {
+    ArchiveReader archive;
+    if (!archive.open(in)) {
+        std::cerr << "Cannot read archive: " << in << std::endl;
+        return 1;
+    }
+    Grid grid;
+    auto start = std::chrono::steady_clock::now();
+    if (!archive.readRegion(x, y, w, h, grid, threads)) {
+        std::cerr << "Cannot read region " << x << "," << y << " " << w << "x" << h << std::endl;
+        return 1;
+    }
+    double readSeconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    SolveResult result;
+    bool found = solveBfs(grid, 0, grid.size() - 1, result);
+    double solveSeconds = secondsSince(start);
+    auto stats = archive.cacheStats();
+    std::cout << "region " << grid.width << "x" << grid.height << " at " << x << "," << y << ": " << stats.misses << " tiles decoded in " << readSeconds
+              << " s; ";
+    if (found) std::cout << "path of " << result.path.size() - 1 << " steps in " << solveSeconds << " s" << std::endl;
+    else std::cout << "corners not connected inside the region" << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    startTraceFromArgs(argc, argv);
+    std::string command = argc > 1 ? argv[1] : "";
+    std::vector<std::string> positional;
+    int tileSize = DEFAULT_TILE_SIZE, bits = 2;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--tile" && i + 1 < argc) tileSize = std::atoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) threads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--bits" && i + 1 < argc) bits = std::atoi(argv[++i]);
+        else positional.push_back(arg);
+    }
+    int status = 2;
+    if (command == "pack" && positional.size() == 2) status = pack(positional[0], positional[1], tileSize, threads);
+    else if (command == "unpack" && positional.size() == 2) status = unpack(positional[0], positional[1], threads, bits);
+    else if (command == "info" && positional.size() == 1) status = info(positional[0]);
+    else if (command == "solve" && positional.size() == 5) {
+        status = solve(positional[0], std::atoi(positional[1].c_str()), std::atoi(positional[2].c_str()), std::atoi(positional[3].c_str()),
+                       std::atoi(positional[4].c_str()), threads);
+    } else {
+        std::cerr << "Usage: maze_archive pack <in.maze> <out.mza> [--tile n] [--threads n]\n"
+                  << "       maze_archive unpack <in.mza> <out.maze> [--threads n] [--bits 2|4]\n"
+                  << "       maze_archive info <in.mza>\n"
+                  << "       maze_archive solve <in.mza> <x> <y> <w> <h> [--threads n]\n"
+                  << "       (any command also takes --trace file)" << std::endl;
+    }
+    MAZE_TRACE_STOP();
+    return status;
+}
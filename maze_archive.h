@@ -0,0 +1,412 @@
+#ifndef MAZE_ARCHIVE_H
+#define MAZE_ARCHIVE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "maze_grid.h"
+#include "lru_cache.h"
+#include "maze_log.h"
+#include "maze_trace.h"
+
+// Archive format for very large mazes: the grid is cut into square tiles and every tile is
+// compressed on its own, so any region can be decoded by reading only the tiles under it.
+//
+// Layout (little-endian):
+//   "MZAR" version:u8 codec:u8 tileSize:u16 width:u32 height:u32 indexOffset:u64
+//   tile payloads, row-major by tile
+//   index at indexOffset: tileCount + 1 absolute offsets (u64); tile i is [index[i], index[i+1])
+//
+// Codec 1 stores each cell's east and south bits with an adaptive binary range coder (the
+// LZMA flavour: 11-bit probabilities, shift-5 adaptation). Each bit is coded in a context
+// made of the passages already known around it (west, north and north-east neighbours,
+// with a separate value on the tile edge), which captures most of the structure of a
+// perfect maze: a cell that is already entered from two sides rarely opens a third. The
+// coder state restarts at every tile.
+const int ARCHIVE_VERSION = 1;
+const int ARCHIVE_CODEC_RANGE = 1;
+const size_t ARCHIVE_HEADER = 24;
+const int DEFAULT_TILE_SIZE = 256;
+const size_t ARCHIVE_CACHE_BYTES = 64 << 20; // Decoded tiles kept by a reader
+
+// Binary adaptive range coder
+const int PROBABILITY_BITS = 11;
+const int ADAPT_SHIFT = 5;
+const uint32_t RANGE_TOP = 1u << 24;
+
+class RangeEncoder {
+public:
+    explicit RangeEncoder(std::vector<uint8_t>& out) : out(out) {}
+
+    void encode(uint16_t& probability, int bit) {
+        uint32_t bound = (range >> PROBABILITY_BITS) * probability;
+        if (!bit) {
+            range = bound;
+            probability += ((1 << PROBABILITY_BITS) - probability) >> ADAPT_SHIFT;
+        } else {
+            low += bound;
+            range -= bound;
+            probability -= probability >> ADAPT_SHIFT;
+        }
+        while (range < RANGE_TOP) {
+            range <<= 8;
+            shiftLow();
+        }
+    }
+
+    void flush() {
+        for (int i = 0; i < 5; ++i) shiftLow();
+    }
+
+private:
+    std::vector<uint8_t>& out;
+    uint64_t low = 0;
+    uint32_t range = 0xFFFFFFFFu;
+    uint8_t cache = 0;
+    uint64_t cacheSize = 1;
+
+    // Bytes wait in cache until a carry out of low can no longer change them
+    void shiftLow() {
+        if (static_cast<uint32_t>(low) < 0xFF000000u || (low >> 32) != 0) {
+            uint8_t carry = static_cast<uint8_t>(low >> 32);
+            uint8_t pending = cache;
+            do {
+                out.push_back(static_cast<uint8_t>(pending + carry));
+                pending = 0xFF;
+            } while (--cacheSize != 0);
+            cache = static_cast<uint8_t>(low >> 24);
+        }
+        ++cacheSize;
+        low = (low & 0x00FFFFFFu) << 8;
+    }
+};
+
+class RangeDecoder {
+public:
+    RangeDecoder(const uint8_t* data, size_t size) : data(data), size(size) {
+        for (int i = 0; i < 5; ++i) code = (code << 8) | next();
+    }
+
+    int decode(uint16_t& probability) {
+        uint32_t bound = (range >> PROBABILITY_BITS) * probability;
+        int bit;
+        if (code < bound) {
+            range = bound;
+            probability += ((1 << PROBABILITY_BITS) - probability) >> ADAPT_SHIFT;
+            bit = 0;
+        } else {
+            code -= bound;
+            range -= bound;
+            probability -= probability >> ADAPT_SHIFT;
+            bit = 1;
+        }
+        while (range < RANGE_TOP) {
+            range <<= 8;
+            code = (code << 8) | next();
+        }
+        return bit;
+    }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t at = 0;
+    uint32_t code = 0;
+    uint32_t range = 0xFFFFFFFFu;
+
+    uint8_t next() { return at < size ? data[at++] : 0; }
+};
+
+// Tile codec. A tile is width x height bytes, row-major, each holding bit 0 (east open)
+// and bit 1 (south open) of one cell.
+class TileCodec {
+public:
+    static constexpr int EDGE = 2; // Neighbour outside the tile
+    static constexpr int CONTEXTS = 3 * 3 * 3 * 3;
+
+    static void encode(const uint8_t* cells, int width, int height, std::vector<uint8_t>& out) {
+        Model model;
+        RangeEncoder encoder(out);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                const uint8_t* cell = cells + static_cast<size_t>(y) * width + x;
+                int context = contextOf(cell, x, y, width);
+                encoder.encode(model.east[context], *cell & 1);
+                encoder.encode(model.south[context * 2 + (*cell & 1)], (*cell >> 1) & 1);
+            }
+        }
+        encoder.flush();
+    }
+
+    static void decode(const uint8_t* data, size_t size, int width, int height, uint8_t* cells) {
+        Model model;
+        RangeDecoder decoder(data, size);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                uint8_t* cell = cells + static_cast<size_t>(y) * width + x;
+                int context = contextOf(cell, x, y, width);
+                int east = decoder.decode(model.east[context]);
+                int south = decoder.decode(model.south[context * 2 + east]);
+                *cell = static_cast<uint8_t>(east | (south << 1));
+            }
+        }
+    }
+
+private:
+    struct Model {
+        uint16_t east[CONTEXTS];
+        uint16_t south[CONTEXTS * 2];
+
+        Model() {
+            std::fill(std::begin(east), std::end(east), 1 << (PROBABILITY_BITS - 1));
+            std::fill(std::begin(south), std::end(south), 1 << (PROBABILITY_BITS - 1));
+        }
+    };
+
+    // Passages into this cell from the west and from the north, the east passage of the
+    // cell above, and the passage into the next cell from the north
+    static int contextOf(const uint8_t* cell, int x, int y, int width) {
+        int west = x > 0 ? cell[-1] & 1 : EDGE;
+        int north = y > 0 ? (cell[-width] >> 1) & 1 : EDGE;
+        int aboveEast = y > 0 ? cell[-width] & 1 : EDGE;
+        int nextNorth = y > 0 && x + 1 < width ? (cell[1 - width] >> 1) & 1 : EDGE;
+        return ((west * 3 + north) * 3 + aboveEast) * 3 + nextNorth;
+    }
+};
+
+// Runs work(i) for i in [0, count) on up to threads threads
+template <typename Work>
+void forEachParallel(size_t count, int threads, Work&& work) {
+    std::atomic<size_t> next{0};
+    auto run = [&] {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            MAZE_TRACE_SCOPE("archive tile");
+            work(i);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < std::min<int>(threads, static_cast<int>(count)); ++t) workers.emplace_back(run);
+    run();
+    for (auto& worker : workers) worker.join();
+}
+
+// Takes rows top to bottom; every tileSize rows the band's tiles are compressed in
+// parallel and appended in order. Memory is one band of one byte per cell.
+class ArchiveWriter {
+public:
+    ~ArchiveWriter() {
+        if (file) std::fclose(file);
+    }
+
+    bool open(const std::string& path, int width, int height, int tileSize = DEFAULT_TILE_SIZE, int threads = 1) {
+        if (width < 1 || height < 1 || tileSize < 1 || tileSize > UINT16_MAX) return false;
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        this->width = width;
+        this->height = height;
+        this->tileSize = tileSize;
+        this->threads = std::max(1, threads);
+        band.assign(static_cast<size_t>(width) * tileSize, 0);
+        offsets.assign(1, ARCHIVE_HEADER);
+        uint8_t header[ARCHIVE_HEADER] = {};
+        return std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+    }
+
+    // One row of per-cell passage bits (only east and south are stored)
+    bool addRow(const uint8_t* cells) {
+        uint8_t* out = band.data() + static_cast<size_t>(bandRows) * width;
+        for (int x = 0; x < width; ++x) out[x] = ((cells[x] & EAST) ? 1 : 0) | ((cells[x] & SOUTH) ? 2 : 0);
+        ++rowsAdded;
+        if (++bandRows == tileSize || rowsAdded == static_cast<uint64_t>(height)) return flushBand();
+        return true;
+    }
+
+    bool addGrid(const Grid& grid) {
+        for (int y = 0; y < grid.height; ++y) {
+            if (!addRow(grid.cells.data() + grid.index(0, y))) return false;
+        }
+        return true;
+    }
+
+    // Writes the index and the header; false if the rows did not add up to the height
+    bool close() {
+        if (!file) return false;
+        bool ok = rowsAdded == static_cast<uint64_t>(height);
+        std::vector<uint8_t> index(offsets.size() * 8);
+        for (size_t i = 0; i < offsets.size(); ++i) putFixed(index.data() + i * 8, offsets[i], 8);
+        ok = ok && std::fwrite(index.data(), 1, index.size(), file) == index.size();
+        uint8_t header[ARCHIVE_HEADER] = {'M', 'Z', 'A', 'R', ARCHIVE_VERSION, ARCHIVE_CODEC_RANGE};
+        putFixed(header + 6, tileSize, 2);
+        putFixed(header + 8, width, 4);
+        putFixed(header + 12, height, 4);
+        putFixed(header + 16, offsets.back(), 8);
+        ok = ok && std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+        ok = std::fclose(file) == 0 && ok;
+        file = nullptr;
+        return ok;
+    }
+
+    uint64_t compressedBytes() const { return offsets.back(); }
+
+private:
+    std::FILE* file = nullptr;
+    int width = 0, height = 0, tileSize = DEFAULT_TILE_SIZE, threads = 1;
+    int bandRows = 0;
+    uint64_t rowsAdded = 0;
+    std::vector<uint8_t> band;
+    std::vector<uint64_t> offsets;
+
+    bool flushBand() {
+        int tilesAcross = (width + tileSize - 1) / tileSize;
+        std::vector<std::vector<uint8_t>> payloads(tilesAcross);
+        forEachParallel(tilesAcross, threads, [&](size_t t) {
+            int x0 = static_cast<int>(t) * tileSize, tileWidth = std::min(tileSize, width - x0);
+            std::vector<uint8_t> tile(static_cast<size_t>(tileWidth) * bandRows);
+            for (int y = 0; y < bandRows; ++y) {
+                std::copy_n(band.data() + static_cast<size_t>(y) * width + x0, tileWidth, tile.data() + static_cast<size_t>(y) * tileWidth);
+            }
+            TileCodec::encode(tile.data(), tileWidth, bandRows, payloads[t]);
+        });
+        bandRows = 0;
+        for (const auto& payload : payloads) {
+            if (std::fwrite(payload.data(), 1, payload.size(), file) != payload.size()) return false;
+            offsets.push_back(offsets.back() + payload.size());
+        }
+        return true;
+    }
+};
+
+// Random access to an archive. Decoded tiles are cached, and a region decodes the tiles it
+// needs in parallel. Safe to use from several threads.
+class ArchiveReader {
+public:
+    typedef std::vector<uint8_t> Tile; // tileWidth x tileHeight bytes, bit 0 east, bit 1 south
+
+    // cacheBytes bounds the decoded tiles kept; 0 keeps none, for callers that hold their own
+    explicit ArchiveReader(size_t cacheBytes = ARCHIVE_CACHE_BYTES) : cache(cacheBytes) {}
+
+    ~ArchiveReader() {
+        if (file) std::fclose(file);
+    }
+
+    // False, with nothing left open, unless the header and the whole tile index check out
+    bool open(const std::string& path) {
+        if (file) std::fclose(file);
+        file = std::fopen(path.c_str(), "rb");
+        if (file && readIndex()) return true;
+        if (file) std::fclose(file);
+        file = nullptr;
+        offsets.clear();
+        return false;
+    }
+
+    int width() const { return columns; }
+    int height() const { return rows; }
+    int tileSize() const { return tiles; }
+    int tilesAcross() const { return (columns + tiles - 1) / tiles; }
+    int tilesDown() const { return (rows + tiles - 1) / tiles; }
+    uint64_t fileBytes() const { return offsets.back() + offsets.size() * 8; }
+    double bitsPerCell() const { return 8.0 * fileBytes() / (static_cast<double>(columns) * rows); }
+    uint64_t tileBytes(int tx, int ty) const {
+        size_t key = static_cast<size_t>(ty) * tilesAcross() + tx;
+        return offsets[key + 1] - offsets[key];
+    }
+    LruCache<uint64_t, Tile>::Stats cacheStats() { return cache.stats(); }
+
+    // Decoded tile (tx, ty); nullptr if it cannot be read
+    std::shared_ptr<const Tile> tile(int tx, int ty) {
+        uint64_t key = static_cast<uint64_t>(ty) * tilesAcross() + tx;
+        if (auto cached = cache.get(key)) return cached;
+        std::vector<uint8_t> payload(offsets[key + 1] - offsets[key]);
+        {
+            std::lock_guard<std::mutex> lock(fileMutex);
+            if (fseeko(file, static_cast<off_t>(offsets[key]), SEEK_SET) != 0 || std::fread(payload.data(), 1, payload.size(), file) != payload.size()) {
+                return nullptr;
+            }
+        }
+        int tileWidth = std::min(tiles, columns - tx * tiles), tileHeight = std::min(tiles, rows - ty * tiles);
+        auto decoded = std::make_shared<Tile>(static_cast<size_t>(tileWidth) * tileHeight);
+        TileCodec::decode(payload.data(), payload.size(), tileWidth, tileHeight, decoded->data());
+        cache.put(key, decoded, decoded->size());
+        return decoded;
+    }
+
+    // The w x h region at (x, y) as a grid with its border closed, so solvers and the
+    // verifier can use it directly. Tiles are decoded on up to threads threads.
+    bool readRegion(int x, int y, int w, int h, Grid& out, int threads = 1) {
+        x = std::max(0, x);
+        y = std::max(0, y);
+        w = std::min(w, columns - x);
+        h = std::min(h, rows - y);
+        if (w < 1 || h < 1) return false;
+        out = Grid(w, h);
+        int tx0 = x / tiles, ty0 = y / tiles, tx1 = (x + w - 1) / tiles, ty1 = (y + h - 1) / tiles;
+        size_t across = tx1 - tx0 + 1, count = across * (ty1 - ty0 + 1);
+        std::vector<std::shared_ptr<const Tile>> decoded(count);
+        forEachParallel(count, threads, [&](size_t i) { decoded[i] = tile(tx0 + static_cast<int>(i % across), ty0 + static_cast<int>(i / across)); });
+        for (size_t i = 0; i < count; ++i) {
+            if (!decoded[i]) return false;
+            int tx = tx0 + static_cast<int>(i % across), ty = ty0 + static_cast<int>(i / across);
+            int tileWidth = std::min(tiles, columns - tx * tiles);
+            int left = std::max(x, tx * tiles), right = std::min(x + w, tx * tiles + tileWidth);
+            int top = std::max(y, ty * tiles), bottom = std::min(y + h, (ty + 1) * tiles);
+            for (int cy = top; cy < bottom; ++cy) {
+                const uint8_t* source = decoded[i]->data() + static_cast<size_t>(cy - ty * tiles) * tileWidth;
+                for (int cx = left; cx < right; ++cx) {
+                    uint8_t bits = source[cx - tx * tiles];
+                    uint32_t cell = out.index(cx - x, cy - y);
+                    if ((bits & 1) && cx + 1 < x + w) out.carve(cell, EAST);
+                    if ((bits & 2) && cy + 1 < y + h) out.carve(cell, SOUTH);
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    std::FILE* file = nullptr;
+    std::mutex fileMutex;
+    int columns = 0, rows = 0, tiles = DEFAULT_TILE_SIZE;
+    std::vector<uint64_t> offsets;
+    LruCache<uint64_t, Tile> cache;
+
+    // The index must end the file, and the tiles must run in order from the end of the
+    // header to the start of the index, so every tile read stays inside the file
+    bool readIndex() {
+        uint8_t header[ARCHIVE_HEADER];
+        if (std::fread(header, 1, sizeof(header), file) != sizeof(header)) return false;
+        if (header[0] != 'M' || header[1] != 'Z' || header[2] != 'A' || header[3] != 'R' || header[4] != ARCHIVE_VERSION) return false;
+        if (header[5] != ARCHIVE_CODEC_RANGE) return false;
+        uint64_t tileSize = getFixed(header + 6, 2), width = getFixed(header + 8, 4), height = getFixed(header + 12, 4);
+        uint64_t indexOffset = getFixed(header + 16, 8);
+        if (tileSize < 1 || width < 1 || height < 1 || width > INT32_MAX - tileSize || height > INT32_MAX - tileSize) return false;
+        tiles = static_cast<int>(tileSize);
+        columns = static_cast<int>(width);
+        rows = static_cast<int>(height);
+
+        if (fseeko(file, 0, SEEK_END) != 0) return false;
+        off_t end = ftello(file);
+        if (end < 0) return false;
+        uint64_t fileSize = static_cast<uint64_t>(end);
+        uint64_t count = static_cast<uint64_t>(tilesAcross()) * tilesDown() + 1;
+        if (indexOffset < ARCHIVE_HEADER || indexOffset > fileSize || count != (fileSize - indexOffset) / 8 || (fileSize - indexOffset) % 8 != 0) return false;
+
+        std::vector<uint8_t> index(count * 8);
+        if (fseeko(file, static_cast<off_t>(indexOffset), SEEK_SET) != 0 || std::fread(index.data(), 1, index.size(), file) != index.size()) return false;
+        offsets.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            offsets[i] = getFixed(index.data() + i * 8, 8);
+            if (i == 0 ? offsets[i] != ARCHIVE_HEADER : offsets[i] < offsets[i - 1]) return false;
+        }
+        return offsets.back() == indexOffset;
+    }
+};
+
+#endif
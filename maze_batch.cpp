@@ -0,0 +1,241 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include "maze_grid.h"
+#include "maze_generators.h"
+#include "maze_log.h"
+#include "maze_path.h"
+#include "work_stealing_pool.h"
+
+// Batch dataset generation: millions of small mazes with their solutions in one file.
+//
+// Job i gets its own seed, mixBits(seed ^ mixBits(i)), which fixes its algorithm, size,
+// maze and path whatever thread runs it. Jobs are grouped into chunks; chunks run on a
+// work-stealing pool and a single writer thread appends them to the file in order, so the
+// output is byte-identical for any thread count. At most --window chunks are in flight,
+// which bounds memory when the disk is slower than the generators.
+//
+// File layout (little-endian):
+//   "MZBA" version:u8 count:u64 seed:u64
+//   algorithms:u8, per algorithm: nameLength:u8 name (the GENERATORS names, in order)
+//   per chunk: records:u32 bytes:u64 then the records
+//   per record: algorithm:u8 width:u16 height:u16 seed:u64 pathSteps:u32
+//               packed maze (maze_grid.h 2-bit rows) packed path (2 bits per move,
+//               0 north, 1 south, 2 east, 3 west) from (0, 0) to (width-1, height-1)
+// A record's algorithm indexes the file's own table of names, so records stay readable
+// when GENERATORS changes. Version 1 had no table and a u32 chunk size.
+const int BATCH_VERSION = 2;
+const int CHUNK_HEADER_BYTES = 12;
+const int DEFAULT_CHUNK_JOBS = 256;
+const int DEFAULT_WINDOW = 64;
+
+struct BatchOptions {
+    std::string output;
+    uint64_t count = 1000000;
+    uint64_t seed = 1;
+    int minSize = 16;
+    int maxSize = 128;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int chunkJobs = DEFAULT_CHUNK_JOBS;
+    int window = DEFAULT_WINDOW;
+    int algorithm = -1; // Index into GENERATORS, -1 picks one per job
+};
+
+// Scratch buffers reused by every job on one worker, so steady state does no allocation
+// beyond what the generators themselves need
+struct Arena {
+    Grid grid;
+    std::vector<uint32_t> queue;
+    std::vector<uint8_t> parent;
+    PackedPath path;
+};
+
+// Breadth-first search from the top-left corner; moves receives the path to the bottom-right
+void solve(Arena& arena) {
+    const Grid& grid = arena.grid;
+    arena.parent.assign(grid.size(), 0);
+    arena.queue.clear();
+    arena.queue.push_back(0);
+    arena.parent[0] = 0xFF; // Root marker
+    uint32_t goal = grid.size() - 1;
+    for (size_t head = 0; head < arena.queue.size(); ++head) {
+        uint32_t cell = arena.queue[head];
+        if (cell == goal) break;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next) && !arena.parent[next]) {
+                arena.parent[next] = opposite(dir);
+                arena.queue.push_back(next);
+            }
+        }
+    }
+
+    // Count the steps back from the goal, then fill the moves from the last one
+    size_t steps = 0;
+    for (uint32_t cell = goal; cell != 0; grid.neighbor(cell, static_cast<Direction>(arena.parent[cell]), cell)) ++steps;
+    arena.path.reset({0, 0}, steps);
+    for (uint32_t cell = goal; cell != 0;) {
+        Direction up = static_cast<Direction>(arena.parent[cell]);
+        arena.path.setMove(--steps, opposite(up));
+        grid.neighbor(cell, up, cell);
+    }
+    arena.path.setEnd(grid.point(goal));
+}
+
+void runJob(const BatchOptions& options, uint64_t index, Arena& arena, std::vector<uint8_t>& out) {
+    uint64_t jobSeed = mixBits(options.seed ^ mixBits(index));
+    int range = options.maxSize - options.minSize + 1;
+    int width = options.minSize + static_cast<int>(mixBits(jobSeed + 1) % range);
+    int height = options.minSize + static_cast<int>(mixBits(jobSeed + 2) % range);
+    int algorithm = options.algorithm >= 0 ? options.algorithm : static_cast<int>(mixBits(jobSeed + 3) % std::size(GENERATORS));
+
+    // Same seeding as buildMaze, so any record can be regenerated on its own
+    arena.grid.width = width;
+    arena.grid.height = height;
+    arena.grid.cells.assign(static_cast<size_t>(width) * height, 0);
+    std::seed_seq sequence = {static_cast<uint32_t>(jobSeed), static_cast<uint32_t>(jobSeed >> 32)};
+    std::mt19937 rng(sequence);
+    GENERATORS[algorithm].generate(arena.grid, rng);
+    solve(arena);
+
+    putFixed(out, static_cast<uint64_t>(algorithm), 1);
+    putFixed(out, static_cast<uint64_t>(width), 2);
+    putFixed(out, static_cast<uint64_t>(height), 2);
+    putFixed(out, jobSeed, 8);
+    putFixed(out, arena.path.steps(), 4);
+    size_t rowBytes = packedRowBytes(width);
+    size_t at = out.size();
+    out.resize(at + rowBytes * height, 0);
+    for (int y = 0; y < height; ++y) packRow(arena.grid, y, out.data() + at + y * rowBytes);
+    out.insert(out.end(), arena.path.bytes().begin(), arena.path.bytes().end());
+}
+
+// Finished chunks waiting for the writer, indexed by chunk number modulo the window
+class ChunkSlots {
+public:
+    explicit ChunkSlots(int window) : slots(window), ready(window, 0) {}
+
+    // Producer side: block until chunk is inside the window
+    void waitForRoom(uint64_t chunk) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return chunk < written + slots.size(); });
+    }
+
+    void finish(uint64_t chunk, std::vector<uint8_t>&& data) {
+        std::lock_guard<std::mutex> lock(mutex);
+        slots[chunk % slots.size()] = std::move(data);
+        ready[chunk % slots.size()] = 1;
+        changed.notify_all();
+    }
+
+    // Writer side: block until the next chunk in order is done, then hand it over
+    std::vector<uint8_t> next() {
+        std::unique_lock<std::mutex> lock(mutex);
+        size_t slot = written % slots.size();
+        changed.wait(lock, [&] { return ready[slot] != 0; });
+        ready[slot] = 0;
+        ++written;
+        changed.notify_all();
+        return std::move(slots[slot]);
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::vector<uint8_t>> slots;
+    std::vector<uint8_t> ready;
+    uint64_t written = 0;
+};
+
+int main(int argc, char* argv[]) {
+    BatchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) options.output = argv[++i];
+        else if (arg == "--count" && i + 1 < argc) options.count = std::stoull(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) options.seed = std::stoull(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) options.threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--chunk" && i + 1 < argc) options.chunkJobs = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--window" && i + 1 < argc) options.window = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--size" && i + 2 < argc) {
+            options.minSize = std::stoi(argv[++i]);
+            options.maxSize = std::stoi(argv[++i]);
+        } else if (arg == "--algorithm" && i + 1 < argc) {
+            std::string name = argv[++i];
+            const GeneratorInfo* generator = findGenerator(name);
+            if (!generator && name != "all") {
+                std::cerr << "Unknown algorithm: " << name << std::endl;
+                return 1;
+            }
+            options.algorithm = generator ? static_cast<int>(generator - GENERATORS) : -1;
+        } else {
+            options.output.clear();
+            break;
+        }
+    }
+    if (options.output.empty() || options.minSize < 2 || options.maxSize < options.minSize || options.maxSize > 0xFFFF) {
+        std::cerr << "Usage: maze_batch --out file [--count n] [--seed n] [--size min max] [--algorithm name|all]\n"
+                  << "                  [--threads n] [--chunk jobs] [--window chunks]" << std::endl;
+        return 1;
+    }
+
+    std::ofstream file(options.output, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open output: " << options.output << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> header = {'M', 'Z', 'B', 'A', BATCH_VERSION};
+    putFixed(header, options.count, 8);
+    putFixed(header, options.seed, 8);
+    putFixed(header, std::size(GENERATORS), 1);
+    for (const GeneratorInfo& generator : GENERATORS) {
+        std::string name = generator.name;
+        putFixed(header, name.size(), 1);
+        header.insert(header.end(), name.begin(), name.end());
+    }
+    file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t chunks = (options.count + options.chunkJobs - 1) / options.chunkJobs;
+    ChunkSlots slots(options.window);
+    uint64_t bytes = header.size();
+    std::thread writer([&] {
+        for (uint64_t c = 0; c < chunks; ++c) {
+            std::vector<uint8_t> data = slots.next();
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            bytes += data.size();
+        }
+    });
+
+    {
+        WorkStealingPool pool(options.threads);
+        for (uint64_t c = 0; c < chunks; ++c) {
+            slots.waitForRoom(c); // Backpressure: never more than a window of chunks in memory
+            pool.submit([&options, &slots, c] {
+                thread_local Arena arena;
+                uint64_t first = c * options.chunkJobs;
+                uint64_t last = std::min<uint64_t>(first + options.chunkJobs, options.count);
+                std::vector<uint8_t> data(CHUNK_HEADER_BYTES, 0); // Filled in below
+                for (uint64_t job = first; job < last; ++job) runJob(options, job, arena, data);
+                for (int i = 0; i < 4; ++i) data[i] = static_cast<uint8_t>((last - first) >> (8 * i));
+                for (int i = 0; i < 8; ++i) data[4 + i] = static_cast<uint8_t>((data.size() - CHUNK_HEADER_BYTES) >> (8 * i));
+                slots.finish(c, std::move(data));
+            });
+        }
+    }
+    writer.join();
+    file.close();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << options.count << " mazes (" << options.minSize << ".." << options.maxSize << ") on " << options.threads << " threads: "
+              << seconds << " s, " << static_cast<uint64_t>(options.count / seconds) << " mazes/s, " << bytes / (1024.0 * 1024.0) / seconds
+              << " MB/s, " << bytes << " bytes" << std::endl;
+    return file ? 0 : 1;
+}
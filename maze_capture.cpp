@@ -0,0 +1,211 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <optional>
+#include <cstdio>
+#include "maze_steps.h"
+#include "frame_capture.h"
+
+// Captures a generator and then a solver from maze_steps.h as raw video, with no window
+// and no frame delay (frame_capture.h). Each frame pulls --rate steps and paints only what
+// they changed: the opened wall, the marked cell and the cursor. Those changes are handed
+// to the writer thread, which encodes and writes the frame while the next one is computed.
+//   maze_capture [generator] [solver] [--size n] [--rate steps-per-frame] [--seed n]
+//                [--video WxH] [--fps n] [--frames max] [--ppm] [--out file|prefix]
+// Y4M by default (--out - writes to stdout, e.g. | ffmpeg -i - maze.mp4); --ppm writes
+// numbered PPM files starting with the --out prefix. Stops after --frames frames or when
+// the solver is done.
+// Requires -std=c++20.
+const int DEFAULT_SIZE = 100;
+const int DEFAULT_WIDTH = 1920;
+const int DEFAULT_HEIGHT = 1080;
+const int DEFAULT_FPS = 60;
+
+enum CaptureColorIndex : uint8_t { COLOR_BACKGROUND, COLOR_WALL, COLOR_VISITED, COLOR_PATH, COLOR_CURSOR };
+
+// The colors animate_maze draws with
+const std::vector<CaptureColor> CAPTURE_PALETTE = {{0, 0, 0}, {255, 255, 255}, {40, 40, 120}, {0, 255, 0}, {255, 0, 0}};
+
+class CaptureAnimation {
+public:
+    CaptureAnimation(int size, int rate, uint32_t seed, FrameCanvas& canvas)
+        : grid(size, size), marks(grid.size(), MARK_NONE), rng(seed), rate(rate), canvas(canvas) {
+        cellSize = std::min((canvas.width() - 1) / size, (canvas.height() - 1) / size);
+        originX = (canvas.width() - size * cellSize) / 2;
+        originY = (canvas.height() - size * cellSize) / 2;
+
+        // Every wall standing, as the generators start
+        for (int i = 0; i <= size; ++i) {
+            canvas.fill(originX, originY + i * cellSize, size * cellSize + 1, 1, COLOR_WALL);
+            canvas.fill(originX + i * cellSize, originY, 1, size * cellSize + 1, COLOR_WALL);
+        }
+    }
+
+    int cells() const { return cellSize; }
+
+    // Start the next algorithm; solvers get a fresh set of marks
+    bool begin(const StepAlgorithm& algorithm) {
+        if (!algorithm.generator) {
+            for (uint32_t cell = 0; cell < grid.size(); ++cell) {
+                if (marks[cell] == MARK_NONE) continue;
+                marks[cell] = MARK_NONE;
+                paintCell(cell);
+            }
+        }
+        steps.emplace(algorithm.start(arena, grid, rng));
+        if (!*steps) {
+            std::cerr << "No room in the step arena for " << algorithm.name << std::endl;
+            return false;
+        }
+        steps->setBatch(std::min(rate, StepGenerator::MAX_BATCH));
+        return true;
+    }
+
+    // Pull the steps of one frame and paint them; false once the algorithm is done
+    bool advance() {
+        uint32_t from = cursor;
+        bool more = true;
+        for (int pulled = 0; pulled < rate; pulled += steps->size()) {
+            if (!(more = steps->next())) break;
+            for (const Step& step : *steps) apply(step);
+        }
+        if (cursor != from) paintCell(from);
+        paintCursor();
+        return more;
+    }
+
+    uint64_t stepCount() const { return taken; }
+
+private:
+    Grid grid;
+    std::vector<uint8_t> marks;
+    std::mt19937 rng;
+    StepArena arena;
+    std::optional<StepGenerator> steps;
+    int rate;
+    FrameCanvas& canvas;
+    int cellSize = 0, originX = 0, originY = 0;
+    uint32_t cursor = 0;
+    uint64_t taken = 0;
+
+    // Generators have already changed the grid; the steps say which wall went
+    void apply(const Step& step) {
+        cursor = step.cell;
+        ++taken;
+        switch (step.event) {
+            case LOG_CARVE: eraseWall(step.cell, step.dir); break;
+            case LOG_VISIT: marks[step.cell] |= MARK_VISITED; break;
+            case LOG_PATH: marks[step.cell] |= MARK_PATH; break;
+            case LOG_CLEAR: marks[step.cell] = MARK_NONE; break;
+            default: break;
+        }
+        if (step.event != LOG_CARVE) paintCell(step.cell);
+    }
+
+    // Leave the corner pixels alone so neighbouring walls stay joined
+    void eraseWall(uint32_t cell, Direction dir) {
+        Point p = grid.point(cell);
+        int x1 = originX + p.x * cellSize, y1 = originY + p.y * cellSize;
+        switch (dir) {
+            case NORTH: canvas.fill(x1 + 1, y1, cellSize - 1, 1, COLOR_BACKGROUND); break;
+            case SOUTH: canvas.fill(x1 + 1, y1 + cellSize, cellSize - 1, 1, COLOR_BACKGROUND); break;
+            case EAST: canvas.fill(x1 + cellSize, y1 + 1, 1, cellSize - 1, COLOR_BACKGROUND); break;
+            case WEST: canvas.fill(x1, y1 + 1, 1, cellSize - 1, COLOR_BACKGROUND); break;
+        }
+    }
+
+    // The inside of a cell in the color of its mark
+    void paintCell(uint32_t cell) {
+        Point p = grid.point(cell);
+        uint8_t color = (marks[cell] & MARK_PATH) ? COLOR_PATH : (marks[cell] & MARK_VISITED) ? COLOR_VISITED : COLOR_BACKGROUND;
+        canvas.fill(originX + p.x * cellSize + 1, originY + p.y * cellSize + 1, cellSize - 1, cellSize - 1, color);
+    }
+
+    void paintCursor() {
+        Point p = grid.point(cursor);
+        int side = std::max(1, cellSize / 2);
+        canvas.fill(originX + p.x * cellSize + cellSize / 4, originY + p.y * cellSize + cellSize / 4, side, side, COLOR_CURSOR);
+    }
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    std::string generatorName = "backtracker", solverName = "astar-heap", out;
+    int size = DEFAULT_SIZE, rate = 1, width = DEFAULT_WIDTH, height = DEFAULT_HEIGHT, fps = DEFAULT_FPS;
+    uint64_t maxFrames = UINT64_MAX;
+    uint32_t seed = std::random_device{}();
+    CaptureFormat format = CAPTURE_Y4M;
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) size = std::max(2, std::stoi(argv[++i]));
+        else if (arg == "--rate" && i + 1 < argc) rate = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--seed" && i + 1 < argc) seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--video" && i + 1 < argc) std::sscanf(argv[++i], "%dx%d", &width, &height);
+        else if (arg == "--fps" && i + 1 < argc) fps = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--frames" && i + 1 < argc) maxFrames = std::stoull(argv[++i]);
+        else if (arg == "--out" && i + 1 < argc) out = argv[++i];
+        else if (arg == "--ppm") format = CAPTURE_PPM;
+        else if (positional++ == 0) generatorName = arg;
+        else solverName = arg;
+    }
+    const StepAlgorithm* generator = findStepAlgorithm(generatorName);
+    const StepAlgorithm* solver = findStepAlgorithm(solverName);
+    if (!generator || !generator->generator || !solver || solver->generator) {
+        std::cerr << "Usage: maze_capture [generator] [solver] [--size n] [--rate steps-per-frame] [--seed n]\n"
+                  << "                    [--video WxH] [--fps n] [--frames max] [--ppm] [--out file|prefix]" << std::endl;
+        return 1;
+    }
+    if (width < 2 || height < 2 || (format == CAPTURE_Y4M && (width % 2 || height % 2)) || std::min(width - 1, height - 1) / size < 2) {
+        std::cerr << "Bad video size " << width << "x" << height << " for a " << size << "x" << size << " maze (Y4M needs even sides, cells need 2 pixels)"
+                  << std::endl;
+        return 1;
+    }
+    if (out.empty()) out = format == CAPTURE_Y4M ? "maze.y4m" : "frame_";
+    std::ostream& report = out == "-" ? std::cerr : std::cout; // Keep stdout for the video
+
+    FrameCanvas canvas(width, height);
+    CaptureWriter writer;
+    if (!writer.open(out, format, width, height, fps, CAPTURE_PALETTE)) {
+        std::cerr << "Cannot write " << out << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    double renderSeconds = 0;
+    CaptureAnimation animation(size, rate, seed, canvas);
+    const StepAlgorithm* stages[] = {generator, solver};
+    int stage = 0;
+    if (!animation.begin(*stages[stage])) return 1;
+    uint64_t frames = 0;
+    for (bool running = true; running && frames < maxFrames; ++frames) {
+        auto frameStart = std::chrono::steady_clock::now();
+        if (!animation.advance()) {
+            if (stage == 0) running = animation.begin(*stages[++stage]);
+            else running = false;
+        }
+        renderSeconds += secondsSince(frameStart);
+        writer.submit(canvas);
+    }
+    bool ok = writer.close();
+    double seconds = secondsSince(start);
+    if (!ok) {
+        std::cerr << "Write error on " << out << std::endl;
+        return 1;
+    }
+
+    double megabytes = writer.bytesWritten() / 1048576.0;
+    report << generator->name << " + " << solver->name << ", " << size << "x" << size << " maze at " << animation.cells() << " px a cell, " << rate
+           << " steps/frame, " << animation.stepCount() << " steps" << std::endl;
+    report << frames << " frames of " << width << "x" << height << " (" << frames / static_cast<double>(fps) << " s at " << fps << " fps) in " << seconds
+           << " s: " << frames / seconds << " frames/s, " << megabytes << " MB at " << megabytes / seconds << " MB/s" << std::endl;
+    report << "  render " << 1000 * renderSeconds / frames << " ms/frame, encode " << 1000 * writer.encodeSeconds() / frames << " ms/frame ("
+           << 100.0 * writer.pixelsEncoded() / (static_cast<double>(frames) * width * height) << "% of pixels converted), write "
+           << 1000 * writer.writeSeconds() / frames << " ms/frame, renderer waited on the writer " << writer.stallSeconds() << " s" << std::endl;
+    return 0;
+}
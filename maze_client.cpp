@@ -0,0 +1,160 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <atomic>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "latency_histogram.h"
+
+// Client for maze_server: sends one request, or load-tests the service with --bench
+const char* DEFAULT_SOCKET = "/tmp/maze.sock";
+
+class Connection {
+public:
+    ~Connection() {
+        if (fd >= 0) close(fd);
+    }
+
+    bool open(const std::string& path) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (fd < 0 || path.size() >= sizeof(address.sun_path)) return false;
+        std::strcpy(address.sun_path, path.c_str());
+        return connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    }
+
+    // Send a request line and read the header plus the payload sizes it announces
+    bool request(const std::string& line, std::string& header, std::string& payload) {
+        std::string out = line + "\n";
+        for (size_t sent = 0; sent < out.size();) {
+            ssize_t n = send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            sent += static_cast<size_t>(n);
+        }
+
+        size_t newline;
+        while ((newline = buffer.find('\n')) == std::string::npos) {
+            if (!fill()) return false;
+        }
+        header = buffer.substr(0, newline);
+        buffer.erase(0, newline + 1);
+
+        size_t expected = 0;
+        if (header.compare(0, 3, "OK ") == 0 && line.compare(0, 3, "GEN") == 0) {
+            unsigned long long width, height, mazeBytes, steps, pathBytes;
+            if (std::sscanf(header.c_str(), "OK %llu %llu %llu %llu %llu", &width, &height, &mazeBytes, &steps, &pathBytes) == 5) {
+                expected = mazeBytes + pathBytes;
+            }
+        }
+        while (buffer.size() < expected) {
+            if (!fill()) return false;
+        }
+        payload = buffer.substr(0, expected);
+        buffer.erase(0, expected);
+        return true;
+    }
+
+private:
+    int fd = -1;
+    std::string buffer;
+
+    bool fill() {
+        char chunk[1 << 16];
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+};
+
+// Concurrent clients drawing seeds from a small pool, so repeats exercise the cache
+int bench(const std::string& socketPath, int clients, int requests, int seeds, const std::string& algorithm, int width, int height) {
+    LatencyHistogram latency;
+    std::vector<std::thread> threads;
+    std::atomic<int> failures(0);
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&, c] {
+            Connection connection;
+            if (!connection.open(socketPath)) {
+                ++failures;
+                return;
+            }
+            std::mt19937 rng(c);
+            std::string header, payload;
+            for (int i = 0; i < requests; ++i) {
+                std::string line = "GEN " + algorithm + " " + std::to_string(rng() % seeds) + " " + std::to_string(width) + " " +
+                                   std::to_string(height) + " 0 0 " + std::to_string(width - 1) + " " + std::to_string(height - 1);
+                auto begin = std::chrono::steady_clock::now();
+                if (!connection.request(line, header, payload) || header.compare(0, 2, "OK") != 0) {
+                    ++failures;
+                    return;
+                }
+                latency.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count());
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << clients << " clients, " << latency.count() << " requests in " << seconds << " s: "
+              << static_cast<uint64_t>(latency.count() / seconds) << " req/s, p50 " << latency.percentileUs(0.5) << " us, p95 "
+              << latency.percentileUs(0.95) << " us, p99 " << latency.percentileUs(0.99) << " us, failures " << failures << std::endl;
+
+    Connection connection;
+    std::string header, payload;
+    if (connection.open(socketPath) && connection.request("STATS", header, payload)) std::cout << "server: " << header << std::endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string socketPath = DEFAULT_SOCKET;
+    std::string output;
+    std::string request;
+    bool benchmark = false;
+    int clients = 8, requests = 1000, seeds = 64, width = 128, height = 128;
+    std::string algorithm = "backtracker";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) socketPath = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) output = argv[++i];
+        else if (arg == "--bench") benchmark = true;
+        else if (arg == "--clients" && i + 1 < argc) clients = std::stoi(argv[++i]);
+        else if (arg == "--requests" && i + 1 < argc) requests = std::stoi(argv[++i]);
+        else if (arg == "--seeds" && i + 1 < argc) seeds = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--algorithm" && i + 1 < argc) algorithm = argv[++i];
+        else if (arg == "--size" && i + 2 < argc) {
+            width = std::stoi(argv[++i]);
+            height = std::stoi(argv[++i]);
+        } else {
+            request += (request.empty() ? "" : " ") + arg;
+        }
+    }
+
+    if (benchmark) return bench(socketPath, clients, requests, seeds, algorithm, width, height);
+    if (request.empty()) {
+        std::cerr << "Usage: maze_client [--socket path] [--out file] GEN <algorithm> <seed> <width> <height> [fx fy tx ty]\n"
+                  << "       maze_client [--socket path] STATS\n"
+                  << "       maze_client [--socket path] --bench [--clients n] [--requests n] [--seeds n] [--algorithm a] [--size w h]"
+                  << std::endl;
+        return 1;
+    }
+
+    Connection connection;
+    std::string header, payload;
+    if (!connection.open(socketPath) || !connection.request(request, header, payload)) {
+        std::cerr << "Request failed: is maze_server running on " << socketPath << "?" << std::endl;
+        return 1;
+    }
+    std::cout << header << std::endl;
+    if (!output.empty()) std::ofstream(output, std::ios::binary).write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    return header.compare(0, 2, "OK") == 0 ? 0 : 1;
+}
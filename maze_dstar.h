@@ -0,0 +1,178 @@
+#ifndef MAZE_DSTAR_H
+#define MAZE_DSTAR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <queue>
+#include <vector>
+#include "maze_grid.h"
+#include "maze_path.h"
+
+// D* Lite: incremental shortest paths while walls open and close under a moving agent.
+//
+// The search runs backwards from the goal, so g[cell] is the distance from cell to the
+// goal and the agent just steps to the neighbour with the smallest g. When a wall flips,
+// only the two cells beside it get new right-hand-side values, and the next replan
+// expands just the cells whose distance actually changed. km carries the heuristic
+// offset as the start moves, so queued keys never need to be rebuilt.
+class DStarLite {
+public:
+    static constexpr uint32_t INF = UINT32_MAX;
+
+    DStarLite(Grid& grid, uint32_t start, uint32_t goal)
+        : grid(grid), start(start), last(start), goal(goal), g(grid.size(), INF), rhs(grid.size(), INF) {
+        rhs[goal] = 0;
+        open.push({key(goal), goal});
+    }
+
+    // Open or close the passage on one side of a cell and mark both ends for repair
+    void setPassage(uint32_t cell, Direction dir, bool isOpen) {
+        uint32_t next = 0;
+        if (!grid.neighbor(cell, dir, next) || grid.isOpen(cell, dir) == isOpen) return;
+        if (isOpen) grid.carve(cell, dir);
+        else grid.fill(cell, dir);
+        updateVertex(cell);
+        updateVertex(next);
+    }
+
+    // The agent has moved; keys already queued stay valid thanks to km
+    void moveStart(uint32_t cell) {
+        km += manhattan(last, cell);
+        last = cell;
+        start = cell;
+    }
+
+    // Repair the search until the start is consistent; returns false if the goal is unreachable
+    bool computePath() {
+        expanded = 0;
+        while (!open.empty()) {
+            Entry top = open.top();
+            uint32_t u = top.second;
+            if (g[u] == rhs[u]) { // Stale entry, already settled
+                open.pop();
+                continue;
+            }
+            if (top.first >= key(start) && rhs[start] == g[start]) break;
+            open.pop();
+
+            uint64_t current = key(u);
+            if (top.first < current) {
+                open.push({current, u}); // The key grew since it was queued
+                continue;
+            }
+
+            ++expanded;
+            if (g[u] > rhs[u]) {
+                g[u] = rhs[u];
+                forEachNeighbor(u, [&](uint32_t s) {
+                    if (s != goal && g[u] + 1 < rhs[s]) {
+                        rhs[s] = g[u] + 1;
+                        queue(s);
+                    }
+                });
+            } else {
+                uint32_t old = g[u];
+                g[u] = INF;
+                forEachNeighbor(u, [&](uint32_t s) {
+                    if (s != goal && rhs[s] == old + 1) updateVertex(s);
+                });
+                updateVertex(u);
+            }
+        }
+        return g[start] != INF;
+    }
+
+    // Distance from the start to the goal after computePath, or INF
+    uint32_t distance() const { return g[start]; }
+
+    // Best next cell from cell, or cell itself when the goal is unreachable from it
+    uint32_t nextStep(uint32_t cell) const {
+        uint32_t best = cell, bestCost = INF;
+        forEachNeighbor(cell, [&](uint32_t s) {
+            if (g[s] != INF && g[s] < bestCost) {
+                bestCost = g[s];
+                best = s;
+            }
+        });
+        return best;
+    }
+
+    // Current route from the start to the goal (empty if unreachable)
+    std::vector<uint32_t> path() const {
+        std::vector<uint32_t> cells;
+        if (g[start] == INF) return cells;
+        cells.push_back(start);
+        for (uint32_t cell = start; cell != goal && cells.size() <= grid.size();) {
+            cell = nextStep(cell);
+            cells.push_back(cell);
+        }
+        return cells;
+    }
+
+    // The same route as 2-bit moves; cleared if unreachable
+    void path(PackedPath& out) const {
+        out.clear();
+        if (g[start] == INF) return;
+        out.reset(grid.point(start));
+        for (uint32_t cell = start; cell != goal && out.steps() < grid.size();) {
+            uint32_t next = nextStep(cell);
+            if (next == cell) break;
+            out.push(grid.point(next));
+            cell = next;
+        }
+    }
+
+    // Cells expanded by the last computePath
+    size_t cellsExpanded() const { return expanded; }
+
+    size_t memoryBytes() const { return (g.size() + rhs.size()) * sizeof(uint32_t) + open.size() * sizeof(Entry); }
+
+private:
+    typedef std::pair<uint64_t, uint32_t> Entry; // (packed key, cell)
+
+    Grid& grid;
+    uint32_t start, last, goal;
+    uint32_t km = 0;
+    std::vector<uint32_t> g, rhs;
+    // Lazy deletion: a cell may sit in the queue several times, stale entries are skipped
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    size_t expanded = 0;
+
+    uint32_t manhattan(uint32_t a, uint32_t b) const {
+        Point p = grid.point(a), q = grid.point(b);
+        return static_cast<uint32_t>(std::abs(p.x - q.x) + std::abs(p.y - q.y));
+    }
+
+    // (min(g, rhs) + h + km, min(g, rhs)) packed so that integer order is key order
+    uint64_t key(uint32_t cell) const {
+        uint64_t m = std::min(g[cell], rhs[cell]);
+        if (m == INF) return UINT64_MAX;
+        return ((m + manhattan(start, cell) + km) << 32) | m;
+    }
+
+    template<typename F>
+    void forEachNeighbor(uint32_t cell, F visit) const {
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next)) visit(next);
+        }
+    }
+
+    void queue(uint32_t cell) {
+        if (g[cell] != rhs[cell]) open.push({key(cell), cell});
+    }
+
+    void updateVertex(uint32_t cell) {
+        if (cell != goal) {
+            uint32_t best = INF;
+            forEachNeighbor(cell, [&](uint32_t s) {
+                if (g[s] != INF) best = std::min(best, g[s] + 1);
+            });
+            rhs[cell] = best;
+        }
+        queue(cell);
+    }
+};
+
+#endif
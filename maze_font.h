@@ -0,0 +1,48 @@
+#ifndef MAZE_FONT_H
+#define MAZE_FONT_H
+
+#include <SDL2/SDL.h>
+#include <cctype>
+#include <string>
+
+// Tiny 3x5 bitmap font for on-screen overlays, so no SDL_ttf dependency is needed.
+// Each glyph is 15 bits, top row in the highest three bits.
+struct Glyph {
+    char c;
+    unsigned short bits;
+};
+
+const Glyph FONT_GLYPHS[] = {
+    {'0', 0x7B6F}, {'1', 0x2C97}, {'2', 0x73E7}, {'3', 0x73CF}, {'4', 0x5BC9}, {'5', 0x79CF}, {'6', 0x79EF}, {'7', 0x7249},
+    {'8', 0x7BEF}, {'9', 0x7BCF}, {'A', 0x2BED}, {'B', 0x6BAE}, {'C', 0x3923}, {'D', 0x6B6E}, {'E', 0x79A7}, {'F', 0x79A4},
+    {'G', 0x396B}, {'H', 0x5BED}, {'I', 0x7497}, {'J', 0x126A}, {'K', 0x5BAD}, {'L', 0x4927}, {'M', 0x5FED}, {'N', 0x6B6D},
+    {'O', 0x2B6A}, {'P', 0x6BA4}, {'Q', 0x2B73}, {'R', 0x6BAD}, {'S', 0x388E}, {'T', 0x7492}, {'U', 0x5B6F}, {'V', 0x5B6A},
+    {'W', 0x5BFD}, {'X', 0x5AAD}, {'Y', 0x5A92}, {'Z', 0x72A7}, {'.', 0x0002}, {':', 0x0410}, {'%', 0x52A5}, {'/', 0x12A4},
+    {'-', 0x01C0},
+};
+
+inline unsigned short glyphBits(char c) {
+    c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    for (const Glyph& glyph : FONT_GLYPHS) {
+        if (glyph.c == c) return glyph.bits;
+    }
+    return 0; // Space and unknown characters draw nothing
+}
+
+// Draw text with the current draw colour; each font pixel is scale x scale screen pixels
+inline void drawText(SDL_Renderer* renderer, int x, int y, int scale, const std::string& text) {
+    for (char c : text) {
+        unsigned short bits = glyphBits(c);
+        for (int row = 0; row < 5; ++row) {
+            for (int col = 0; col < 3; ++col) {
+                if (bits & (1 << (14 - row * 3 - col))) {
+                    SDL_Rect rect = {x + col * scale, y + row * scale, scale, scale};
+                    SDL_RenderFillRect(renderer, &rect);
+                }
+            }
+        }
+        x += 4 * scale;
+    }
+}
+
+#endif
@@ -0,0 +1,351 @@
+#ifndef MAZE_GENERATORS_H
+#define MAZE_GENERATORS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "maze_grid.h"
+#include "maze_trace.h"
+#include "eller_stream.h"
+#include "packed_generators.h"
+#include "recursive_division.h"
+
+// Headless generators over the shared grid. Each one carves a perfect maze into an
+// all-walls grid, using only the given random number generator.
+
+// Union-find with path halving and union by size
+class UnionFind {
+public:
+    explicit UnionFind(uint32_t n) : parent(n), size(n, 1) {
+        for (uint32_t i = 0; i < n; ++i) parent[i] = i;
+    }
+
+    uint32_t find(uint32_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    // Returns false if a and b were already in the same set
+    bool unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (size[a] < size[b]) std::swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+        return true;
+    }
+
+private:
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> size;
+};
+
+// Randomized depth-first search (recursive backtracker) with an explicit stack
+inline void generateBacktracker(Grid& grid, std::mt19937& rng) {
+    std::vector<uint8_t> visited(grid.size(), 0);
+    std::vector<uint32_t> stack = {0};
+    visited[0] = 1;
+
+    while (!stack.empty()) {
+        uint32_t cell = stack.back();
+        Direction options[4];
+        uint32_t targets[4];
+        int count = 0;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.neighbor(cell, dir, next) && !visited[next]) {
+                options[count] = dir;
+                targets[count++] = next;
+            }
+        }
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+        int pick = static_cast<int>(rng() % count);
+        grid.carve(cell, options[pick]);
+        visited[targets[pick]] = 1;
+        stack.push_back(targets[pick]);
+    }
+}
+
+// Kruskal's algorithm: shuffle every interior wall, knock it down if it joins two sets.
+// Walls are encoded as cell * 2 + (0 = east, 1 = south).
+inline void generateKruskal(Grid& grid, std::mt19937& rng) {
+    std::vector<uint32_t> walls;
+    walls.reserve(static_cast<size_t>(grid.size()) * 2);
+    for (int y = 0; y < grid.height; ++y) {
+        for (int x = 0; x < grid.width; ++x) {
+            uint32_t cell = grid.index(x, y);
+            if (x + 1 < grid.width) walls.push_back(cell * 2);
+            if (y + 1 < grid.height) walls.push_back(cell * 2 + 1);
+        }
+    }
+    std::shuffle(walls.begin(), walls.end(), rng);
+
+    UnionFind sets(grid.size());
+    for (uint32_t wall : walls) {
+        uint32_t cell = wall / 2;
+        Direction dir = (wall & 1) ? SOUTH : EAST;
+        uint32_t next = (wall & 1) ? cell + grid.width : cell + 1;
+        if (sets.unite(cell, next)) grid.carve(cell, dir);
+    }
+}
+
+// Randomized Prim's algorithm: grow from one cell through a random frontier passage
+inline void generatePrim(Grid& grid, std::mt19937& rng) {
+    std::vector<uint8_t> visited(grid.size(), 0);
+    std::vector<std::pair<uint32_t, Direction>> frontier;
+
+    auto addFrontier = [&](uint32_t cell) {
+        visited[cell] = 1;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.neighbor(cell, dir, next) && !visited[next]) frontier.push_back({cell, dir});
+        }
+    };
+
+    addFrontier(0);
+    while (!frontier.empty()) {
+        size_t pick = rng() % frontier.size();
+        auto [cell, dir] = frontier[pick];
+        frontier[pick] = frontier.back();
+        frontier.pop_back();
+
+        uint32_t next = 0;
+        grid.neighbor(cell, dir, next);
+        if (visited[next]) continue;
+        grid.carve(cell, dir);
+        addFrontier(next);
+    }
+}
+
+// Random directions two bits at a time, sixteen per draw; random walks spend most of
+// their time here
+class RandomDirections {
+public:
+    explicit RandomDirections(std::mt19937& rng) : rng(rng) {}
+
+    Direction next() {
+        if (left == 0) {
+            bits = rng();
+            left = 16;
+        }
+        Direction dir = DIRECTIONS[bits & 3];
+        bits >>= 2;
+        --left;
+        return dir;
+    }
+
+private:
+    std::mt19937& rng;
+    uint32_t bits = 0;
+    int left = 0;
+};
+
+// Aldous-Broder: a random walk over the whole grid that carves a passage whenever it enters
+// a cell for the first time. Produces a uniform spanning tree (every perfect maze equally
+// likely), but has to cover the grid, and the last few cells take most of the time.
+// Stops once at most stopAt cells are left unvisited and returns the visited cells.
+inline std::vector<uint8_t> walkAldousBroder(Grid& grid, std::mt19937& rng, uint32_t stopAt) {
+    std::vector<uint8_t> visited(grid.size(), 0);
+    RandomDirections directions(rng);
+    uint32_t cell = rng() % grid.size();
+    visited[cell] = 1;
+    for (uint32_t remaining = grid.size() - 1; remaining > stopAt;) {
+        Direction dir = directions.next();
+        uint32_t next = 0;
+        if (!grid.neighbor(cell, dir, next)) continue;
+        if (!visited[next]) {
+            grid.carve(cell, dir);
+            visited[next] = 1;
+            --remaining;
+        }
+        cell = next;
+    }
+    return visited;
+}
+
+// Wilson's algorithm: from each cell outside the tree, random-walk until the tree is hit,
+// then add the loop-erased walk. Loops are erased for free by remembering only the last
+// exit taken from each cell. Uniform for any starting tree and any order of start cells.
+inline void finishWilson(Grid& grid, std::mt19937& rng, std::vector<uint8_t>& inTree) {
+    std::vector<uint8_t> exit(grid.size(), 0);
+    RandomDirections directions(rng);
+    for (uint32_t start = 0; start < grid.size(); ++start) {
+        uint32_t cell = start;
+        while (!inTree[cell]) {
+            Direction dir = directions.next();
+            uint32_t next = 0;
+            if (!grid.neighbor(cell, dir, next)) continue;
+            exit[cell] = dir;
+            cell = next;
+        }
+        for (cell = start; !inTree[cell];) {
+            Direction dir = static_cast<Direction>(exit[cell]);
+            inTree[cell] = 1;
+            grid.carve(cell, dir);
+            grid.neighbor(cell, dir, cell);
+        }
+    }
+}
+
+inline void generateAldousBroder(Grid& grid, std::mt19937& rng) {
+    walkAldousBroder(grid, rng, 0);
+}
+
+inline void generateWilson(Grid& grid, std::mt19937& rng) {
+    std::vector<uint8_t> inTree(grid.size(), 0);
+    inTree[rng() % grid.size()] = 1;
+    finishWilson(grid, rng, inTree);
+}
+
+// Aldous-Broder while it still finds new cells quickly, then Wilson's algorithm, whose
+// walks are short once the tree already covers part of the grid. Close to uniform but not
+// exact: the partial tree Aldous-Broder leaves behind is not distributed like that part of
+// a uniform tree, which shows up as a small bias on tiny grids (see ust_bench).
+const double HYBRID_COVERAGE = 0.3;
+
+inline void generateHybridUst(Grid& grid, std::mt19937& rng) {
+    std::vector<uint8_t> inTree = walkAldousBroder(grid, rng, static_cast<uint32_t>(grid.size() * (1 - HYBRID_COVERAGE)));
+    finishWilson(grid, rng, inTree);
+}
+
+// Several Aldous-Broder walkers on their own threads, all starting from one cell. A walker
+// claims an unvisited cell with a fetch_or on a shared bitmap, and the claimer alone
+// records the passage it came through, so every cell is joined exactly once and the result
+// is still one tree. Walkers are not independent of each other, so the tree is only close
+// to uniform, and thread timing makes it vary from run to run. Once coverage of the grid
+// is claimed, Wilson's algorithm finishes on one thread.
+inline void generateParallelAldousBroder(Grid& grid, std::mt19937& rng, int walkers, double coverage = HYBRID_COVERAGE) {
+    const int CHECK_EVERY = 1024;
+    uint32_t target = static_cast<uint32_t>(std::min<double>(grid.size(), grid.size() * coverage));
+    std::vector<std::atomic<uint64_t>> claimed((grid.size() + 63) / 64);
+    std::vector<uint8_t> entered(grid.size(), 0); // Direction back to the cell a walker came from
+    std::atomic<uint32_t> count{1};
+    uint32_t start = rng() % grid.size();
+    claimed[start >> 6].store(uint64_t(1) << (start & 63));
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < std::max(1, walkers); ++w) {
+        threads.emplace_back([&, seed = rng()] {
+            MAZE_TRACE_THREAD("walker");
+            MAZE_TRACE_SCOPE("walk");
+            std::mt19937 own(seed);
+            RandomDirections directions(own);
+            uint32_t cell = start, found = 0;
+            while (count.load(std::memory_order_relaxed) < target) {
+                for (int step = 0; step < CHECK_EVERY; ++step) {
+                    Direction dir = directions.next();
+                    uint32_t next = 0;
+                    if (!grid.neighbor(cell, dir, next)) continue;
+                    uint64_t bit = uint64_t(1) << (next & 63);
+                    std::atomic<uint64_t>& word = claimed[next >> 6];
+                    if (!(word.load(std::memory_order_relaxed) & bit) && !(word.fetch_or(bit, std::memory_order_relaxed) & bit)) {
+                        entered[next] = opposite(dir);
+                        ++found;
+                    }
+                    cell = next;
+                }
+                count.fetch_add(found, std::memory_order_relaxed);
+                found = 0;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    std::vector<uint8_t> inTree(grid.size(), 0);
+    for (uint32_t cell = 0; cell < grid.size(); ++cell) {
+        inTree[cell] = (claimed[cell >> 6].load(std::memory_order_relaxed) >> (cell & 63)) & 1;
+        if (entered[cell]) grid.carve(cell, static_cast<Direction>(entered[cell]));
+    }
+    finishWilson(grid, rng, inTree);
+}
+
+// Remove dead ends to add loops: each dead end, with the given probability, gets one more
+// passage knocked through to a random walled-off neighbour. 0 keeps the maze perfect.
+inline void braidMaze(Grid& grid, std::mt19937& rng, double probability) {
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    for (uint32_t cell = 0; cell < grid.size(); ++cell) {
+        uint8_t open = grid.cells[cell];
+        if ((open & (open - 1)) != 0 || chance(rng) >= probability) continue; // Not a dead end (or skipped)
+
+        Direction options[4];
+        int count = 0;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (!(open & dir) && grid.neighbor(cell, dir, next)) options[count++] = dir;
+        }
+        if (count > 0) grid.carve(cell, options[rng() % count]);
+    }
+}
+
+// Terrain costs in [minCost, maxCost]: square regions of REGION cells each get one random
+// terrain (mud, water, road, ...), and a few single cells get the cheapest cost as speed pads
+inline void generateTerrain(Grid& grid, std::mt19937& rng, int minCost, int maxCost) {
+    const int REGION = 16;
+    const int PAD_ONE_IN = 64;
+    std::uniform_int_distribution<int> anyCost(minCost, maxCost);
+    int regionsX = (grid.width + REGION - 1) / REGION, regionsY = (grid.height + REGION - 1) / REGION;
+    std::vector<uint8_t> regions(static_cast<size_t>(regionsX) * regionsY);
+    for (uint8_t& region : regions) region = static_cast<uint8_t>(anyCost(rng));
+
+    grid.costs.resize(grid.cells.size());
+    for (int y = 0; y < grid.height; ++y) {
+        for (int x = 0; x < grid.width; ++x) {
+            uint8_t cost = regions[static_cast<size_t>(y / REGION) * regionsX + x / REGION];
+            grid.costs[grid.index(x, y)] = rng() % PAD_ONE_IN == 0 ? static_cast<uint8_t>(minCost) : cost;
+        }
+    }
+}
+
+struct GeneratorInfo {
+    const char* name;
+    void (*generate)(Grid& grid, std::mt19937& rng);
+};
+
+const GeneratorInfo GENERATORS[] = {
+    {"backtracker", generateBacktracker},
+    {"kruskal", generateKruskal},
+    {"prim", generatePrim},
+    {"aldous-broder", generateAldousBroder},
+    {"wilson", generateWilson},
+    {"hybrid", generateHybridUst},
+    {"eller", generateEller},
+    {"binary-tree", generateBinaryTree},
+    {"sidewinder", generateSidewinder},
+    {"division", generateRecursiveDivision},
+};
+
+inline const GeneratorInfo* findGenerator(const std::string& name) {
+    for (const GeneratorInfo& info : GENERATORS) {
+        if (name == info.name) return &info;
+    }
+    return nullptr;
+}
+
+// Deterministic generation from a 64-bit seed into an existing grid, reusing its memory
+inline void buildMaze(const GeneratorInfo& generator, uint64_t seed, Grid& grid) {
+    std::fill(grid.cells.begin(), grid.cells.end(), 0);
+    grid.costs.clear();
+    std::seed_seq sequence = {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+    std::mt19937 rng(sequence);
+    generator.generate(grid, rng);
+}
+
+inline Grid buildMaze(const GeneratorInfo& generator, uint64_t seed, int width, int height) {
+    Grid grid(width, height);
+    buildMaze(generator, seed, grid);
+    return grid;
+}
+
+#endif
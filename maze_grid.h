@@ -0,0 +1,136 @@
+#ifndef MAZE_GRID_H
+#define MAZE_GRID_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Passage bits stored per cell: a set bit means the wall on that side is open
+enum Direction { NORTH = 1, SOUTH = 2, EAST = 4, WEST = 8 };
+
+const Direction DIRECTIONS[4] = {NORTH, SOUTH, EAST, WEST};
+
+struct Point {
+    int x, y;
+
+    // Operator to compare two Points
+    bool operator==(const Point& other) const {
+        return x == other.x && y == other.y;
+    }
+
+    bool operator<(const Point& other) const {
+        return x < other.x || (x == other.x && y < other.y);
+    }
+};
+
+inline Direction opposite(Direction dir) {
+    switch (dir) {
+        case NORTH: return SOUTH;
+        case SOUTH: return NORTH;
+        case EAST: return WEST;
+        case WEST: return EAST;
+    }
+    return NORTH; // Default return
+}
+
+// splitmix64 finalizer, used to derive independent seeds from (seed, index) style inputs
+inline uint64_t mixBits(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Width x height maze, one byte of passage bits per cell in row-major order
+struct Grid {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> cells;
+    std::vector<uint8_t> costs; // Optional terrain layer: cost (>= 1) of stepping into each cell; empty means 1 everywhere
+
+    Grid() = default;
+    Grid(int width, int height) : width(width), height(height), cells(static_cast<size_t>(width) * height, 0) {}
+
+    uint32_t size() const { return static_cast<uint32_t>(cells.size()); }
+    uint32_t index(int x, int y) const { return static_cast<uint32_t>(y) * width + x; }
+    Point point(uint32_t cell) const { return {static_cast<int>(cell % width), static_cast<int>(cell / width)}; }
+    bool isOpen(uint32_t cell, Direction dir) const { return cells[cell] & dir; }
+    uint32_t cost(uint32_t cell) const { return costs.empty() ? 1 : costs[cell]; }
+
+    // Index of the neighbouring cell in direction dir; false when that would leave the grid
+    bool neighbor(uint32_t cell, Direction dir, uint32_t& out) const {
+        uint32_t x = cell % width;
+        switch (dir) {
+            case NORTH: if (cell < static_cast<uint32_t>(width)) return false; out = cell - width; break;
+            case SOUTH: if (cell / width + 1 >= static_cast<uint32_t>(height)) return false; out = cell + width; break;
+            case EAST: if (x + 1 >= static_cast<uint32_t>(width)) return false; out = cell + 1; break;
+            case WEST: if (x == 0) return false; out = cell - 1; break;
+        }
+        return true;
+    }
+
+    // Open the passage between cell and its neighbour in direction dir (the neighbour must exist)
+    void carve(uint32_t cell, Direction dir) {
+        uint32_t next = 0;
+        neighbor(cell, dir, next);
+        cells[cell] |= dir;
+        cells[next] |= opposite(dir);
+    }
+
+    // Close the passage between cell and its neighbour in direction dir
+    void fill(uint32_t cell, Direction dir) {
+        uint32_t next = 0;
+        if (!neighbor(cell, dir, next)) return;
+        cells[cell] &= ~dir;
+        cells[next] &= ~opposite(dir);
+    }
+};
+
+// Packed form: 2 bits per cell (bit 0 east open, bit 1 south open), four cells per byte,
+// every row padded to a whole byte. North and west bits are implied by the neighbours.
+inline size_t packedRowBytes(int width) {
+    return (static_cast<size_t>(width) + 3) / 4;
+}
+
+inline void packRow(const Grid& grid, int y, uint8_t* out) {
+    size_t bytes = packedRowBytes(grid.width);
+    for (size_t i = 0; i < bytes; ++i) out[i] = 0;
+    uint32_t base = grid.index(0, y);
+    for (int x = 0; x < grid.width; ++x) {
+        uint8_t cell = grid.cells[base + x];
+        uint8_t bits = ((cell & EAST) ? 1 : 0) | ((cell & SOUTH) ? 2 : 0);
+        out[x >> 2] |= bits << ((x & 3) * 2);
+    }
+}
+
+// Rows must be unpacked top to bottom into a cleared grid
+inline void unpackRow(Grid& grid, int y, const uint8_t* in) {
+    uint32_t base = grid.index(0, y);
+    for (int x = 0; x < grid.width; ++x) {
+        uint8_t bits = (in[x >> 2] >> ((x & 3) * 2)) & 3;
+        if ((bits & 1) && x + 1 < grid.width) {
+            grid.cells[base + x] |= EAST;
+            grid.cells[base + x + 1] |= WEST;
+        }
+        if ((bits & 2) && y + 1 < grid.height) {
+            grid.cells[base + x] |= SOUTH;
+            grid.cells[base + x + grid.width] |= NORTH;
+        }
+    }
+}
+
+inline std::vector<uint8_t> packGrid(const Grid& grid) {
+    size_t rowBytes = packedRowBytes(grid.width);
+    std::vector<uint8_t> packed(rowBytes * grid.height);
+    for (int y = 0; y < grid.height; ++y) packRow(grid, y, packed.data() + y * rowBytes);
+    return packed;
+}
+
+inline void unpackGrid(Grid& grid, const uint8_t* packed) {
+    size_t rowBytes = packedRowBytes(grid.width);
+    std::fill(grid.cells.begin(), grid.cells.end(), 0);
+    for (int y = 0; y < grid.height; ++y) unpackRow(grid, y, packed + y * rowBytes);
+}
+
+#endif
@@ -0,0 +1,354 @@
+#ifndef MAZE_HPA_H
+#define MAZE_HPA_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "maze_grid.h"
+#include "maze_trace.h"
+
+// Hierarchical pathfinding (HPA*) for mazes with loops.
+//
+// The grid is cut into square clusters. A cell with an open passage across its cluster's
+// border is an entrance. For each cluster we store its entrances and the shortest
+// in-cluster distances between them. A query connects start and goal to the
+// entrances of their own clusters, runs A* over entrances only, then refines each
+// abstract hop with a BFS confined to one cluster.
+//
+// Abstract node ids are cluster * maxEntrances + entrance slot, so rebuilding one cluster
+// never renumbers another; toggling a wall only marks the clusters on either side dirty.
+class HierarchicalSolver {
+public:
+    static constexpr uint16_t UNREACHABLE = 0xFFFF;
+
+    // clusterSize is at most 255 so in-cluster distances fit in 16 bits
+    HierarchicalSolver(Grid& grid, int clusterSize = 32)
+        : grid(grid), clusterSize(std::clamp(clusterSize, 2, 255)), clustersX((grid.width + this->clusterSize - 1) / this->clusterSize),
+          clustersY((grid.height + this->clusterSize - 1) / this->clusterSize), maxEntrances(4 * this->clusterSize),
+          clusters(static_cast<size_t>(clustersX) * clustersY), dirty(clusters.size(), 1) {}
+
+    // Build (or rebuild) every dirty cluster, spread across threads
+    void update(int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))) {
+        std::vector<uint32_t> work;
+        for (uint32_t c = 0; c < clusters.size(); ++c) {
+            if (dirty[c]) work.push_back(c);
+        }
+        lastRebuilt = work.size();
+        threads = std::max(1, std::min<int>(threads, static_cast<int>(work.size() / 8 + 1)));
+
+        auto build = [&](int t) {
+            if (t > 0) MAZE_TRACE_THREAD("hpa builder");
+            MAZE_TRACE_SCOPE("build clusters");
+            std::vector<uint16_t> dist;
+            std::vector<uint16_t> queue;
+            for (size_t i = t; i < work.size(); i += threads) buildCluster(work[i], dist, queue);
+        };
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; ++t) pool.emplace_back(build, t);
+        build(0);
+        for (auto& thread : pool) thread.join();
+        for (uint32_t c : work) dirty[c] = 0;
+    }
+
+    // Open or close one passage; the clusters holding its two cells must be rebuilt
+    void setPassage(uint32_t cell, Direction dir, bool open) {
+        uint32_t next = 0;
+        if (!grid.neighbor(cell, dir, next)) return;
+        if (open) grid.carve(cell, dir);
+        else grid.fill(cell, dir);
+        dirty[clusterOf(cell)] = 1;
+        dirty[clusterOf(next)] = 1;
+    }
+
+    size_t clustersRebuilt() const { return lastRebuilt; }
+    size_t abstractNodesExpanded() const { return expanded; }
+
+    size_t memoryBytes() const {
+        size_t bytes = clusters.size() * sizeof(Cluster);
+        for (const Cluster& cluster : clusters) {
+            bytes += cluster.entrances.capacity() * 4 + cluster.positions.capacity() * sizeof(Point) + cluster.firstEdge.capacity() * 4 +
+                     cluster.edges.capacity() * sizeof(Edge);
+        }
+        return bytes;
+    }
+
+    // Shortest path through the abstract graph, refined to cells; empty if unreachable
+    std::vector<uint32_t> findPath(uint32_t start, uint32_t goal) {
+        std::vector<uint32_t> hops;
+        if (!abstractPath(start, goal, hops)) return {};
+
+        std::vector<uint32_t> path = {start};
+        for (size_t i = 1; i < hops.size(); ++i) {
+            uint32_t from = hops[i - 1], to = hops[i];
+            if (from == to) continue;
+            if (clusterOf(from) != clusterOf(to)) {
+                path.push_back(to); // Border crossing, one step
+            } else {
+                localPath(from, to, path);
+            }
+        }
+        return path;
+    }
+
+    // Length of the abstract route only (no refinement), or -1 if unreachable
+    long long pathLength(uint32_t start, uint32_t goal) {
+        std::vector<uint32_t> hops;
+        return abstractPath(start, goal, hops) ? static_cast<long long>(bestCost) : -1;
+    }
+
+private:
+    struct Edge {
+        uint16_t to;   // Entrance slot in the same cluster
+        uint16_t dist; // Shortest in-cluster distance
+    };
+
+    struct Cluster {
+        std::vector<uint32_t> entrances; // Sorted cell ids
+        std::vector<Point> positions;    // Coordinates of each entrance, for the heuristic
+        std::vector<uint32_t> firstEdge; // Per entrance, offset into edges (k + 1 entries)
+        std::vector<Edge> edges;
+    };
+
+    struct Bounds {
+        int x0, y0, x1, y1; // Half-open
+    };
+
+    Grid& grid;
+    int clusterSize;
+    int clustersX, clustersY;
+    uint32_t maxEntrances;
+    std::vector<Cluster> clusters;
+    std::vector<uint8_t> dirty;
+    size_t lastRebuilt = 0;
+    size_t expanded = 0;
+    uint32_t bestCost = 0;
+
+    // Per-query search state over abstract node ids, reset lazily with a stamp
+    std::vector<uint32_t> gScore, cameFrom, stamp;
+    uint32_t currentStamp = 0;
+
+    uint32_t clusterOf(uint32_t cell) const {
+        Point p = grid.point(cell);
+        return static_cast<uint32_t>(p.y / clusterSize) * clustersX + p.x / clusterSize;
+    }
+
+    Bounds boundsOf(uint32_t c) const {
+        int x0 = static_cast<int>(c % clustersX) * clusterSize, y0 = static_cast<int>(c / clustersX) * clusterSize;
+        return {x0, y0, std::min(x0 + clusterSize, grid.width), std::min(y0 + clusterSize, grid.height)};
+    }
+
+    bool inside(const Bounds& b, Point p) const {
+        return p.x >= b.x0 && p.x < b.x1 && p.y >= b.y0 && p.y < b.y1;
+    }
+
+    // BFS over one cluster from a cell; dist is indexed by local cell (row-major in bounds)
+    void localBfs(const Bounds& b, uint32_t source, std::vector<uint16_t>& dist, std::vector<uint16_t>& queue) const {
+        int w = b.x1 - b.x0;
+        dist.assign(static_cast<size_t>(w) * (b.y1 - b.y0), UNREACHABLE);
+        queue.clear();
+        Point s = grid.point(source);
+        uint16_t local = static_cast<uint16_t>((s.y - b.y0) * w + (s.x - b.x0));
+        dist[local] = 0;
+        queue.push_back(local);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            uint16_t at = queue[head];
+            Point p = {b.x0 + at % w, b.y0 + at / w};
+            uint32_t cell = grid.index(p.x, p.y);
+            for (Direction dir : DIRECTIONS) {
+                uint32_t next = 0;
+                if (!grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, next)) continue;
+                Point q = grid.point(next);
+                if (!inside(b, q)) continue;
+                uint16_t nl = static_cast<uint16_t>((q.y - b.y0) * w + (q.x - b.x0));
+                if (dist[nl] != UNREACHABLE) continue;
+                dist[nl] = dist[at] + 1;
+                queue.push_back(nl);
+            }
+        }
+    }
+
+    // Find the entrances of one cluster and connect them. An edge i-j is dropped when some
+    // entrance m lies on a shortest i-j path, since i-m-j then gives the same distance; in
+    // a maze most routes pass other border cells, so this removes most of the k*k edges.
+    void buildCluster(uint32_t c, std::vector<uint16_t>& dist, std::vector<uint16_t>& queue) {
+        Bounds b = boundsOf(c);
+        Cluster& cluster = clusters[c];
+        cluster.entrances.clear();
+        for (int y = b.y0; y < b.y1; ++y) {
+            for (int x = b.x0; x < b.x1; ++x) {
+                if (x != b.x0 && x != b.x1 - 1 && y != b.y0 && y != b.y1 - 1) continue; // Border cells only
+                uint32_t cell = grid.index(x, y);
+                for (Direction dir : DIRECTIONS) {
+                    uint32_t next = 0;
+                    if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next) && !inside(b, grid.point(next))) {
+                        cluster.entrances.push_back(cell);
+                        break;
+                    }
+                }
+            }
+        }
+        std::sort(cluster.entrances.begin(), cluster.entrances.end());
+        cluster.positions.clear();
+        for (uint32_t cell : cluster.entrances) cluster.positions.push_back(grid.point(cell));
+
+        size_t k = cluster.entrances.size();
+        int w = b.x1 - b.x0;
+        std::vector<uint16_t> matrix(k * k, UNREACHABLE);
+        for (size_t i = 0; i < k; ++i) {
+            localBfs(b, cluster.entrances[i], dist, queue);
+            for (size_t j = 0; j < k; ++j) {
+                Point q = grid.point(cluster.entrances[j]);
+                matrix[i * k + j] = dist[(q.y - b.y0) * w + (q.x - b.x0)];
+            }
+        }
+
+        cluster.firstEdge.assign(k + 1, 0);
+        cluster.edges.clear();
+        for (size_t i = 0; i < k; ++i) {
+            cluster.firstEdge[i] = static_cast<uint32_t>(cluster.edges.size());
+            for (size_t j = 0; j < k; ++j) {
+                uint16_t d = matrix[i * k + j];
+                if (i == j || d == UNREACHABLE) continue;
+                bool through = false;
+                for (size_t m = 0; m < k && !through; ++m) {
+                    through = m != i && m != j && matrix[i * k + m] != UNREACHABLE && matrix[i * k + m] + matrix[m * k + j] == d;
+                }
+                if (!through) cluster.edges.push_back({static_cast<uint16_t>(j), d});
+            }
+        }
+        cluster.firstEdge[k] = static_cast<uint32_t>(cluster.edges.size());
+    }
+
+    int slotOf(uint32_t c, uint32_t cell) const {
+        const std::vector<uint32_t>& entrances = clusters[c].entrances;
+        auto it = std::lower_bound(entrances.begin(), entrances.end(), cell);
+        return (it != entrances.end() && *it == cell) ? static_cast<int>(it - entrances.begin()) : -1;
+    }
+
+    static uint32_t manhattan(Point p, Point q) {
+        return static_cast<uint32_t>(std::abs(p.x - q.x) + std::abs(p.y - q.y));
+    }
+
+    // A* over entrances; hops receives start, the entrances visited, and goal
+    bool abstractPath(uint32_t start, uint32_t goal, std::vector<uint32_t>& hops) {
+        expanded = 0;
+        uint32_t startCluster = clusterOf(start), goalCluster = clusterOf(goal);
+        Bounds sb = boundsOf(startCluster), gb = boundsOf(goalCluster);
+        std::vector<uint16_t> startDist, goalDist, queue;
+        localBfs(sb, start, startDist, queue);
+        localBfs(gb, goal, goalDist, queue);
+        int sw = sb.x1 - sb.x0, gw = gb.x1 - gb.x0;
+
+        const uint32_t INF = UINT32_MAX;
+        bestCost = INF;
+        uint32_t bestNode = INF; // Last entrance before the goal, INF for a direct in-cluster path
+        if (startCluster == goalCluster) {
+            Point g = grid.point(goal);
+            uint16_t d = startDist[(g.y - sb.y0) * sw + (g.x - sb.x0)];
+            if (d != UNREACHABLE) bestCost = d;
+        }
+
+        size_t nodes = clusters.size() * maxEntrances;
+        if (gScore.size() != nodes) {
+            gScore.assign(nodes, INF);
+            cameFrom.assign(nodes, INF);
+            stamp.assign(nodes, 0);
+            currentStamp = 0;
+        }
+        if (++currentStamp == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            currentStamp = 1;
+        }
+
+        typedef std::pair<uint32_t, uint32_t> Entry; // (f, node)
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        Point target = grid.point(goal);
+        auto relax = [&](uint32_t node, Point at, uint32_t g, uint32_t from) {
+            if (stamp[node] == currentStamp && gScore[node] <= g) return;
+            stamp[node] = currentStamp;
+            gScore[node] = g;
+            cameFrom[node] = from;
+            open.push({g + manhattan(at, target), node});
+        };
+
+        const Cluster& first = clusters[startCluster];
+        for (size_t i = 0; i < first.entrances.size(); ++i) {
+            Point e = first.positions[i];
+            uint16_t d = startDist[(e.y - sb.y0) * sw + (e.x - sb.x0)];
+            if (d != UNREACHABLE) relax(startCluster * maxEntrances + static_cast<uint32_t>(i), e, d, INF);
+        }
+
+        while (!open.empty()) {
+            auto [f, node] = open.top();
+            open.pop();
+            if (f >= bestCost) break;
+            uint32_t c = node / maxEntrances, slot = node % maxEntrances;
+            const Cluster& cluster = clusters[c];
+            uint32_t cell = cluster.entrances[slot];
+            Point p = cluster.positions[slot];
+            uint32_t g = gScore[node];
+            if (f != g + manhattan(p, target)) continue; // Stale entry
+            ++expanded;
+
+            if (c == goalCluster) {
+                uint16_t d = goalDist[(p.y - gb.y0) * gw + (p.x - gb.x0)];
+                if (d != UNREACHABLE && g + d < bestCost) {
+                    bestCost = g + d;
+                    bestNode = node;
+                }
+            }
+
+            for (uint32_t e = cluster.firstEdge[slot]; e < cluster.firstEdge[slot + 1]; ++e) {
+                const Edge& edge = cluster.edges[e];
+                relax(c * maxEntrances + edge.to, cluster.positions[edge.to], g + edge.dist, node);
+            }
+            for (Direction dir : DIRECTIONS) {
+                uint32_t next = 0;
+                if (!grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, next)) continue;
+                uint32_t nc = clusterOf(next);
+                if (nc == c) continue;
+                int nslot = slotOf(nc, next);
+                if (nslot >= 0) relax(nc * maxEntrances + static_cast<uint32_t>(nslot), grid.point(next), g + 1, node);
+            }
+        }
+
+        if (bestCost == INF) return false;
+        hops.clear();
+        hops.push_back(goal);
+        for (uint32_t node = bestNode; node != INF; node = cameFrom[node]) {
+            hops.push_back(clusters[node / maxEntrances].entrances[node % maxEntrances]);
+        }
+        hops.push_back(start);
+        std::reverse(hops.begin(), hops.end());
+        return true;
+    }
+
+    // Append the cells after from up to and including to, both inside one cluster
+    void localPath(uint32_t from, uint32_t to, std::vector<uint32_t>& path) const {
+        Bounds b = boundsOf(clusterOf(from));
+        int w = b.x1 - b.x0;
+        std::vector<uint16_t> dist, queue;
+        localBfs(b, to, dist, queue); // Distances to the target: walk downhill from the source
+        uint32_t cell = from;
+        Point p = grid.point(cell);
+        uint16_t d = dist[(p.y - b.y0) * w + (p.x - b.x0)];
+        while (d > 0) {
+            for (Direction dir : DIRECTIONS) {
+                uint32_t next = 0;
+                if (!grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, next)) continue;
+                Point q = grid.point(next);
+                if (inside(b, q) && dist[(q.y - b.y0) * w + (q.x - b.x0)] == d - 1) {
+                    cell = next;
+                    --d;
+                    path.push_back(cell);
+                    break;
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef MAZE_IO_H
+#define MAZE_IO_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "maze_grid.h"
+
+// Maze files, written and read one row at a time so neither side needs the whole maze.
+//
+// Header (little-endian): "MAZE" version:u8 bitsPerCell:u8 width:u32 height:u32, then the
+// rows top to bottom, each padded to a whole byte.
+//   2 bits per cell: the packed format from maze_grid.h (east and south bits only), the
+//                    compact form; north and west are implied by the neighbours.
+//   4 bits per cell: every passage bit (N=1 S=2 E=4 W=8), two cells per byte, low nibble
+//                    first; redundant, but lets a verifier catch asymmetric wall bits.
+const int MAZE_FILE_VERSION = 1;
+const size_t MAZE_FILE_HEADER = 14;
+const size_t MAZE_IO_BUFFER = 1 << 22;
+
+inline size_t mazeRowBytes(int width, int bitsPerCell) {
+    return bitsPerCell == 4 ? (static_cast<size_t>(width) + 1) / 2 : packedRowBytes(width);
+}
+
+class MazeFileWriter {
+public:
+    ~MazeFileWriter() { close(); }
+
+    // A path of "-" writes to standard output, for piping
+    bool open(const std::string& path, int width, int height, int bitsPerCell) {
+        if (bitsPerCell != 2 && bitsPerCell != 4) return false;
+        file = path == "-" ? stdout : std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        std::setvbuf(file, nullptr, _IOFBF, MAZE_IO_BUFFER);
+        this->width = width;
+        this->bits = bitsPerCell;
+        uint8_t header[MAZE_FILE_HEADER] = {'M', 'A', 'Z', 'E', MAZE_FILE_VERSION, static_cast<uint8_t>(bitsPerCell)};
+        for (int i = 0; i < 4; ++i) {
+            header[6 + i] = static_cast<uint8_t>(static_cast<uint32_t>(width) >> (8 * i));
+            header[10 + i] = static_cast<uint8_t>(static_cast<uint32_t>(height) >> (8 * i));
+        }
+        row.assign(mazeRowBytes(width, bitsPerCell), 0);
+        return std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+    }
+
+    // One row of per-cell passage bits
+    bool writeRow(const uint8_t* cells) {
+        std::fill(row.begin(), row.end(), 0);
+        for (int x = 0; x < width; ++x) {
+            if (bits == 4) row[x >> 1] |= static_cast<uint8_t>((cells[x] & 15) << ((x & 1) * 4));
+            else row[x >> 2] |= static_cast<uint8_t>((((cells[x] & EAST) ? 1 : 0) | ((cells[x] & SOUTH) ? 2 : 0)) << ((x & 3) * 2));
+        }
+        return std::fwrite(row.data(), 1, row.size(), file) == row.size();
+    }
+
+    // One row already in the packed 2-bit form (2-bit files only)
+    bool writePackedRow(const uint8_t* packed) {
+        if (bits != 2) return false;
+        return std::fwrite(packed, 1, row.size(), file) == row.size();
+    }
+
+    bool writeGrid(const Grid& grid) {
+        for (int y = 0; y < grid.height; ++y) {
+            if (!writeRow(grid.cells.data() + grid.index(0, y))) return false;
+        }
+        return true;
+    }
+
+    bool close() {
+        bool ok = true;
+        if (file == stdout) ok = std::fflush(file) == 0;
+        else if (file) ok = std::fclose(file) == 0;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    std::FILE* file = nullptr;
+    int width = 0;
+    int bits = 2;
+    std::vector<uint8_t> row;
+};
+
+class MazeFileReader {
+public:
+    ~MazeFileReader() {
+        if (file) std::fclose(file);
+    }
+
+    bool open(const std::string& path) {
+        file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+        std::setvbuf(file, nullptr, _IOFBF, MAZE_IO_BUFFER);
+        uint8_t header[MAZE_FILE_HEADER];
+        if (std::fread(header, 1, sizeof(header), file) != sizeof(header)) return false;
+        if (header[0] != 'M' || header[1] != 'A' || header[2] != 'Z' || header[3] != 'E' || header[4] != MAZE_FILE_VERSION) return false;
+        bits = header[5];
+        columns = rows = 0;
+        for (int i = 0; i < 4; ++i) {
+            columns |= static_cast<uint32_t>(header[6 + i]) << (8 * i);
+            rows |= static_cast<uint32_t>(header[10 + i]) << (8 * i);
+        }
+        if ((bits != 2 && bits != 4) || columns == 0 || rows == 0) return false;
+        row.resize(mazeRowBytes(columns, bits));
+        south.assign(columns, 0);
+        return true;
+    }
+
+    // Position the reader so the next readRow returns row y. The 2-bit format needs the
+    // row above for its north bits, so that row is read and dropped.
+    bool seekRow(int y) {
+        size_t rowBytes = row.size();
+        std::fill(south.begin(), south.end(), 0);
+        uint64_t at = MAZE_FILE_HEADER + static_cast<uint64_t>(y > 0 && bits == 2 ? y - 1 : y) * rowBytes;
+        if (fseeko(file, static_cast<off_t>(at), SEEK_SET) != 0) return false;
+        if (y > 0 && bits == 2) {
+            std::vector<uint8_t> skipped;
+            return readRow(skipped);
+        }
+        return true;
+    }
+
+    int width() const { return static_cast<int>(columns); }
+    int height() const { return static_cast<int>(rows); }
+    int bitsPerCell() const { return bits; }
+    uint64_t cellCount() const { return static_cast<uint64_t>(columns) * rows; }
+
+    // Next row as per-cell passage bits. In the 2-bit format north and west are filled in
+    // from the row above and the cell to the left, so they are always symmetric.
+    bool readRow(std::vector<uint8_t>& cells) {
+        if (std::fread(row.data(), 1, row.size(), file) != row.size()) return false;
+        cells.resize(columns);
+        if (bits == 4) {
+            for (uint32_t x = 0; x < columns; ++x) cells[x] = (row[x >> 1] >> ((x & 1) * 4)) & 15;
+            return true;
+        }
+        uint8_t westOpen = 0;
+        for (uint32_t x = 0; x < columns; ++x) {
+            uint8_t packed = (row[x >> 2] >> ((x & 3) * 2)) & 3;
+            uint8_t cell = (south[x] ? NORTH : 0) | westOpen;
+            if (packed & 1) cell |= EAST;
+            if (packed & 2) cell |= SOUTH;
+            westOpen = (packed & 1) ? WEST : 0;
+            south[x] = packed & 2;
+            cells[x] = cell;
+        }
+        return true;
+    }
+
+private:
+    std::FILE* file = nullptr;
+    uint32_t columns = 0, rows = 0;
+    int bits = 2;
+    std::vector<uint8_t> row;
+    std::vector<uint8_t> south; // South bits of the previous row (2-bit format)
+};
+
+#endif
@@ -0,0 +1,330 @@
+#ifndef MAZE_LOG_H
+#define MAZE_LOG_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "maze_grid.h"
+
+// Binary log of generation and solving steps, replayable without re-running the algorithm.
+//
+// Layout:
+//   header    "MZLG", u8 version, u32 width, u32 height, u32 keyframe interval
+//   records   one tag byte, then a zigzag varint of the cell delta from the previous record
+//   index     per keyframe: u64 step, u64 file offset
+//   footer    u64 keyframe count, u64 index offset, "MZIX"
+//
+// A keyframe record holds varint step, the packed grid and the packed marks. The cell delta
+// restarts from zero after every keyframe, so decoding can begin at any keyframe.
+
+enum LogEvent : uint8_t {
+    LOG_CARVE = 0,    // Open a passage; direction in the high nibble of the tag
+    LOG_VISIT = 1,    // Solver expanded a cell
+    LOG_PATH = 2,     // Cell is on the current path
+    LOG_CLEAR = 3,    // Solver backtracked out of a cell
+    LOG_KEYFRAME = 4
+};
+
+// Per-cell marks kept alongside the grid, two bits per cell in keyframes
+enum LogMark : uint8_t { MARK_NONE = 0, MARK_VISITED = 1, MARK_PATH = 2 };
+
+const uint8_t LOG_VERSION = 1;
+const uint32_t DEFAULT_KEYFRAME_INTERVAL = 4096;
+
+inline void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+inline uint64_t getVarint(const uint8_t*& in) {
+    uint64_t value = 0;
+    int shift = 0;
+    while (*in & 0x80) {
+        value |= static_cast<uint64_t>(*in++ & 0x7f) << shift;
+        shift += 7;
+    }
+    value |= static_cast<uint64_t>(*in++) << shift;
+    return value;
+}
+
+// Bounded form for untrusted input: false if the varint runs past end or over 64 bits
+inline bool getVarint(const uint8_t*& in, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; in < end && shift < 64; shift += 7) {
+        uint8_t byte = *in++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+inline void putFixed(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+// In place, for fixed-size headers
+inline void putFixed(uint8_t* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+inline uint64_t getFixed(const uint8_t* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+inline size_t packedMarkBytes(uint32_t cells) {
+    return (static_cast<size_t>(cells) + 3) / 4;
+}
+
+class EventLogWriter {
+public:
+    ~EventLogWriter() { close(); }
+
+    // Start a log; the initial keyframe records the grid as it is now (e.g. a pre-generated maze)
+    bool open(const std::string& path, const Grid& initial, uint32_t interval = DEFAULT_KEYFRAME_INTERVAL) {
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        grid = initial;
+        marks.assign(grid.size(), MARK_NONE);
+        keyframeInterval = interval;
+        step = 0;
+        offset = 0;
+        index.clear();
+
+        buffer.assign({'M', 'Z', 'L', 'G', LOG_VERSION});
+        putFixed(buffer, grid.width, 4);
+        putFixed(buffer, grid.height, 4);
+        putFixed(buffer, keyframeInterval, 4);
+        writeKeyframe();
+        return true;
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    void carve(uint32_t cell, Direction dir) {
+        if (!file) return;
+        grid.carve(cell, dir);
+        record(static_cast<uint8_t>(LOG_CARVE | (dir << 4)), cell);
+    }
+
+    void visit(uint32_t cell) {
+        if (!file) return;
+        marks[cell] |= MARK_VISITED;
+        record(LOG_VISIT, cell);
+    }
+
+    void path(uint32_t cell) {
+        if (!file) return;
+        marks[cell] = MARK_PATH;
+        record(LOG_PATH, cell);
+    }
+
+    void clear(uint32_t cell) {
+        if (!file) return;
+        marks[cell] = MARK_NONE;
+        record(LOG_CLEAR, cell);
+    }
+
+    void close() {
+        if (!file) return;
+        uint64_t indexOffset = offset + buffer.size();
+        for (const auto& entry : index) {
+            putFixed(buffer, entry.first, 8);
+            putFixed(buffer, entry.second, 8);
+        }
+        putFixed(buffer, index.size(), 8);
+        putFixed(buffer, indexOffset, 8);
+        buffer.insert(buffer.end(), {'M', 'Z', 'I', 'X'});
+        flush();
+        std::fclose(file);
+        file = nullptr;
+    }
+
+private:
+    std::FILE* file = nullptr;
+    Grid grid;                  // Shadow copy of the state, needed for keyframes
+    std::vector<uint8_t> marks;
+    std::vector<uint8_t> buffer;
+    std::vector<std::pair<uint64_t, uint64_t>> index; // (step, offset) per keyframe
+    uint32_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL;
+    uint32_t lastCell = 0;
+    uint64_t step = 0;
+    uint64_t offset = 0; // File offset of buffer[0]
+
+    void record(uint8_t tag, uint32_t cell) {
+        int64_t delta = static_cast<int64_t>(cell) - static_cast<int64_t>(lastCell);
+        buffer.push_back(tag);
+        putVarint(buffer, (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+        lastCell = cell;
+        if (++step % keyframeInterval == 0) writeKeyframe();
+        if (buffer.size() >= (1 << 16)) flush();
+    }
+
+    void writeKeyframe() {
+        index.push_back({step, offset + buffer.size()});
+        buffer.push_back(LOG_KEYFRAME);
+        putVarint(buffer, step);
+
+        std::vector<uint8_t> packed = packGrid(grid);
+        buffer.insert(buffer.end(), packed.begin(), packed.end());
+        size_t start = buffer.size();
+        buffer.resize(start + packedMarkBytes(grid.size()), 0);
+        for (uint32_t i = 0; i < grid.size(); ++i) buffer[start + i / 4] |= marks[i] << ((i & 3) * 2);
+        lastCell = 0;
+    }
+
+    void flush() {
+        std::fwrite(buffer.data(), 1, buffer.size(), file);
+        offset += buffer.size();
+        buffer.clear();
+    }
+};
+
+class EventLogReader {
+public:
+    bool open(const std::string& path) {
+        std::FILE* in = std::fopen(path.c_str(), "rb");
+        if (!in) return false;
+        std::fseek(in, 0, SEEK_END);
+        data.resize(static_cast<size_t>(std::ftell(in)));
+        std::fseek(in, 0, SEEK_SET);
+        bool ok = std::fread(data.data(), 1, data.size(), in) == data.size();
+        std::fclose(in);
+        if (!ok || data.size() < 17 + 20 || std::memcmp(data.data(), "MZLG", 4) != 0 || data[4] != LOG_VERSION) return false;
+        if (std::memcmp(data.data() + data.size() - 4, "MZIX", 4) != 0) return false;
+
+        // Every keyframe holds the whole grid, so a grid bigger than the file is corrupt
+        uint64_t width = getFixed(&data[5], 4), height = getFixed(&data[9], 4);
+        if (width == 0 || height == 0 || width > INT32_MAX || height > INT32_MAX || width * height > data.size() * 4) return false;
+        grid = Grid(static_cast<int>(width), static_cast<int>(height));
+        marks.assign(grid.size(), MARK_NONE);
+
+        // The index needs at least the keyframe at step 0, and its entries in step order,
+        // each pointing at a whole keyframe of that step inside the event stream
+        uint64_t count = getFixed(&data[data.size() - 20], 8);
+        uint64_t indexOffset = getFixed(&data[data.size() - 12], 8);
+        if (count == 0 || indexOffset < 17 || indexOffset > data.size() - 20 || count > (data.size() - 20 - indexOffset) / 16) return false;
+        endOffset = indexOffset;
+        index.clear();
+        for (uint64_t i = 0; i < count; ++i) {
+            const uint8_t* entry = &data[indexOffset + i * 16];
+            uint64_t keyStep = getFixed(entry, 8), offset = getFixed(entry + 8, 8);
+            if ((i == 0 ? keyStep != 0 : keyStep < index.back().first) || offset >= endOffset || data[offset] != LOG_KEYFRAME) return false;
+            const uint8_t* in = &data[offset + 1];
+            uint64_t stored = 0;
+            if (!getVarint(in, data.data() + endOffset, stored) || stored != keyStep) return false;
+            if (keyframeBytes() > endOffset - static_cast<size_t>(in - data.data())) return false;
+            index.push_back({keyStep, offset});
+        }
+        if (!countSteps()) return false;
+        seek(0);
+        return true;
+    }
+
+    uint64_t stepCount() const { return totalSteps; }
+    uint64_t position() const { return step; }
+    const Grid& state() const { return grid; }
+    const std::vector<uint8_t>& cellMarks() const { return marks; }
+    uint32_t cursor() const { return lastCell; }
+
+    // Jump to any step: load the nearest keyframe at or before it, then decode forward
+    void seek(uint64_t target) {
+        if (target > totalSteps) target = totalSteps;
+        auto keyframe = std::upper_bound(index.begin(), index.end(), std::make_pair(target, UINT64_MAX)) - 1;
+        loadKeyframe(keyframe->second);
+        while (step < target && advance()) {}
+    }
+
+    // Apply the next event; false at the end of the log or at a record that does not decode
+    // (the state is left as it was before that record)
+    bool advance() {
+        while (cursorOffset < endOffset && data[cursorOffset] == LOG_KEYFRAME) {
+            if (!skipKeyframe()) return false; // Keyframes only matter when seeking
+        }
+        if (cursorOffset >= endOffset) return false;
+
+        const uint8_t* in = &data[cursorOffset];
+        uint8_t tag = *in++;
+        uint64_t zigzag = 0;
+        if (!getVarint(in, data.data() + endOffset, zigzag)) return false;
+        int64_t delta = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+        if (delta < -static_cast<int64_t>(lastCell) || delta >= static_cast<int64_t>(grid.size()) - lastCell) return false;
+        uint32_t cell = static_cast<uint32_t>(static_cast<int64_t>(lastCell) + delta);
+
+        uint8_t event = tag & 0x0f;
+        Direction dir = static_cast<Direction>(tag >> 4);
+        uint32_t next = 0;
+        if (event == LOG_CARVE) {
+            if ((dir != NORTH && dir != SOUTH && dir != EAST && dir != WEST) || !grid.neighbor(cell, dir, next)) return false;
+        } else if (event > LOG_CLEAR || tag != event) {
+            return false;
+        }
+
+        switch (event) {
+            case LOG_CARVE: grid.carve(cell, dir); break;
+            case LOG_VISIT: marks[cell] |= MARK_VISITED; break;
+            case LOG_PATH: marks[cell] = MARK_PATH; break;
+            case LOG_CLEAR: marks[cell] = MARK_NONE; break;
+        }
+        lastCell = cell;
+        cursorOffset = static_cast<size_t>(in - data.data());
+        ++step;
+        return true;
+    }
+
+private:
+    std::vector<uint8_t> data;
+    std::vector<std::pair<uint64_t, uint64_t>> index;
+    Grid grid;
+    std::vector<uint8_t> marks;
+    size_t cursorOffset = 0;
+    size_t endOffset = 0;
+    uint32_t lastCell = 0;
+    uint64_t step = 0;
+    uint64_t totalSteps = 0;
+
+    void loadKeyframe(size_t at) {
+        const uint8_t* in = &data[at + 1];
+        step = getVarint(in);
+        unpackGrid(grid, in);
+        in += packedRowBytes(grid.width) * grid.height;
+        for (uint32_t i = 0; i < grid.size(); ++i) marks[i] = (in[i / 4] >> ((i & 3) * 2)) & 3;
+        in += packedMarkBytes(grid.size());
+        cursorOffset = static_cast<size_t>(in - data.data());
+        lastCell = 0;
+    }
+
+    size_t keyframeBytes() const {
+        return packedRowBytes(grid.width) * grid.height + packedMarkBytes(grid.size());
+    }
+
+    // A keyframe met while decoding must be whole and record the step reached so far
+    bool skipKeyframe() {
+        const uint8_t* in = &data[cursorOffset + 1];
+        uint64_t keyStep = 0;
+        if (!getVarint(in, data.data() + endOffset, keyStep) || keyStep != step) return false;
+        if (keyframeBytes() > endOffset - static_cast<size_t>(in - data.data())) return false;
+        in += keyframeBytes();
+        cursorOffset = static_cast<size_t>(in - data.data());
+        lastCell = 0;
+        return true;
+    }
+
+    // Decode the whole stream once on open: steps after the last keyframe are not indexed,
+    // and a record that does not decode rejects the log here rather than during playback
+    bool countSteps() {
+        loadKeyframe(index.front().second);
+        while (advance()) {}
+        totalSteps = step;
+        return cursorOffset == endOffset;
+    }
+};
+
+#endif
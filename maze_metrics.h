@@ -0,0 +1,168 @@
+#ifndef MAZE_METRICS_H
+#define MAZE_METRICS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "maze_grid.h"
+
+// Difficulty measures of a maze, checked against ranges with early exits:
+//   dead ends:  cells with a single open side
+//   corridor:   the longest chain of cells with exactly two open sides (turns included)
+//   length:     steps of the shortest path from the top-left to the bottom-right cell
+// Stages run cheapest first, and each stops as soon as its answer is settled: the dead-end
+// scan when the count is over the maximum or can no longer reach the minimum, the corridor
+// scan at the first corridor over the maximum, the BFS once it is deeper than the longest
+// allowed path. A stage with no bounds is skipped unless every measure is asked for.
+enum MetricStage { STAGE_DEAD_ENDS, STAGE_CORRIDOR, STAGE_LENGTH, STAGE_PASSED };
+
+const char* const METRIC_STAGE_NAMES[] = {"dead ends", "corridor", "length", "passed"};
+
+struct MetricRange {
+    uint64_t min = 0;
+    uint64_t max = UINT64_MAX;
+
+    bool bounded() const { return min > 0 || max < UINT64_MAX; }
+    bool contains(uint64_t value) const { return value >= min && value <= max; }
+};
+
+struct MazeConstraints {
+    MetricRange deadEnds, corridor, length;
+};
+
+struct MazeMetrics {
+    uint64_t deadEnds = 0;
+    uint64_t corridor = 0;
+    uint64_t length = UINT64_MAX; // UINT64_MAX when the corners are not connected
+};
+
+// Scratch buffers for one thread; reusing an evaluator makes evaluation allocation-free
+class MetricEvaluator {
+public:
+    // STAGE_PASSED if grid meets every bound, otherwise the stage that rejected it. With all
+    // set, every measure is computed in full (for reporting a match); otherwise metrics
+    // only holds what the stages needed.
+    MetricStage evaluate(const Grid& grid, const MazeConstraints& constraints, MazeMetrics& metrics, bool all = false) {
+        metrics = MazeMetrics();
+        if (seen.size() != grid.cells.size()) {
+            seen.assign(grid.cells.size(), 0);
+            epoch = 0;
+        }
+        if ((all || constraints.deadEnds.bounded()) && !countDeadEnds(grid, all ? MetricRange() : constraints.deadEnds, metrics)) return STAGE_DEAD_ENDS;
+        if ((all || constraints.corridor.bounded()) && !longestCorridor(grid, all ? MetricRange() : constraints.corridor, metrics)) return STAGE_CORRIDOR;
+        if ((all || constraints.length.bounded()) && !solutionLength(grid, all ? MetricRange() : constraints.length, metrics)) return STAGE_LENGTH;
+        if (all && !(constraints.deadEnds.contains(metrics.deadEnds) && constraints.corridor.contains(metrics.corridor) && constraints.length.contains(metrics.length))) {
+            return !constraints.deadEnds.contains(metrics.deadEnds) ? STAGE_DEAD_ENDS : !constraints.corridor.contains(metrics.corridor) ? STAGE_CORRIDOR : STAGE_LENGTH;
+        }
+        return STAGE_PASSED;
+    }
+
+    // Cells looked at by evaluate calls so far, for measuring how early they stop
+    uint64_t cellsExamined() const { return examined; }
+
+private:
+    std::vector<uint32_t> seen; // Stamped with the epoch of the stage that reached a cell
+    uint32_t epoch = 0;
+    std::vector<uint32_t> frontier, next;
+    uint64_t examined = 0;
+
+    static int degree(uint8_t cell) {
+        return ((cell & NORTH) ? 1 : 0) + ((cell & SOUTH) ? 1 : 0) + ((cell & EAST) ? 1 : 0) + ((cell & WEST) ? 1 : 0);
+    }
+
+    void nextEpoch() {
+        if (++epoch == 0) {
+            std::fill(seen.begin(), seen.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    bool countDeadEnds(const Grid& grid, const MetricRange& range, MazeMetrics& metrics) {
+        uint64_t count = 0, cells = grid.cells.size();
+        for (uint64_t i = 0; i < cells; ++i) {
+            count += degree(grid.cells[i]) == 1;
+            if (count > range.max || count + (cells - i - 1) < range.min) {
+                examined += i + 1;
+                metrics.deadEnds = count;
+                return false;
+            }
+            if (range.bounded() && range.max == UINT64_MAX && count >= range.min) {
+                examined += i + 1;
+                metrics.deadEnds = count; // At least this many; enough to pass
+                return true;
+            }
+        }
+        examined += cells;
+        metrics.deadEnds = count;
+        return true;
+    }
+
+    // Follows the chain through cell from the side it was entered; returns its length
+    uint64_t walkChain(const Grid& grid, uint32_t cell, Direction from) {
+        uint64_t length = 0;
+        while (seen[cell] != epoch && degree(grid.cells[cell]) == 2) {
+            seen[cell] = epoch;
+            ++length;
+            Direction out = from;
+            for (Direction dir : DIRECTIONS) {
+                if (dir != from && grid.isOpen(cell, dir)) out = dir;
+            }
+            if (out == from || !grid.neighbor(cell, out, cell)) break;
+            from = opposite(out);
+        }
+        return length;
+    }
+
+    bool longestCorridor(const Grid& grid, const MetricRange& range, MazeMetrics& metrics) {
+        nextEpoch();
+        uint64_t longest = 0;
+        for (uint32_t cell = 0; cell < grid.size(); ++cell) {
+            if (seen[cell] == epoch || degree(grid.cells[cell]) != 2) continue;
+            // Both ways out of a middle cell, each chain counted once
+            seen[cell] = epoch;
+            uint64_t length = 1;
+            for (Direction dir : DIRECTIONS) {
+                uint32_t neighbor = 0;
+                if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, neighbor)) length += walkChain(grid, neighbor, opposite(dir));
+            }
+            longest = std::max(longest, length);
+            if (longest > range.max || (range.bounded() && range.max == UINT64_MAX && longest >= range.min)) {
+                examined += cell + 1;
+                metrics.corridor = longest;
+                return longest <= range.max;
+            }
+        }
+        examined += grid.size();
+        metrics.corridor = longest;
+        return longest >= range.min;
+    }
+
+    // Level-synchronous BFS, abandoned once it is deeper than range.max
+    bool solutionLength(const Grid& grid, const MetricRange& range, MazeMetrics& metrics) {
+        nextEpoch();
+        uint32_t goal = grid.size() - 1;
+        frontier.assign(1, 0);
+        seen[0] = epoch;
+        for (uint64_t depth = 0; !frontier.empty() && depth <= range.max; ++depth) {
+            next.clear();
+            for (uint32_t cell : frontier) {
+                ++examined;
+                if (cell == goal) {
+                    metrics.length = depth;
+                    return range.contains(depth);
+                }
+                for (Direction dir : DIRECTIONS) {
+                    uint32_t neighbor = 0;
+                    if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, neighbor) && seen[neighbor] != epoch) {
+                        seen[neighbor] = epoch;
+                        next.push_back(neighbor);
+                    }
+                }
+            }
+            frontier.swap(next);
+        }
+        return false; // Too deep, or not connected
+    }
+};
+
+#endif
@@ -0,0 +1,275 @@
+#ifndef MAZE_PATH_H
+#define MAZE_PATH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "maze_grid.h"
+#include "maze_log.h"
+
+// Paths stored as a start cell and one 2-bit move per step, four moves to a byte with the
+// first move in the low bits (the layout maze_batch records and maze_server sends). A
+// step costs a quarter of a byte instead of the 8 of a Point, and the cells are decoded
+// on the fly by a forward iterator, one move per increment.
+//
+// Solvers find a path from the goal backwards. Once the length is known the path can be
+// sized up front and filled from its last move to its first (setMove), so there is no
+// reversal and no temporary list of cells. PathFileWriter does the same straight to disk,
+// a chunk at a time, for paths too long to keep.
+//
+// File layout (little-endian): "MZPT" version:u8 0 0 0 startX:u32 startY:u32 steps:u64,
+// then the packed moves.
+const int PATH_FILE_VERSION = 1;
+const size_t PATH_FILE_HEADER = 24;
+const size_t PATH_FILE_CHUNK = 1 << 16; // Bytes of moves buffered by the file reader and writer
+
+// Move codes: 0 north, 1 south, 2 east, 3 west
+inline uint8_t moveCode(Direction dir) {
+    switch (dir) {
+        case NORTH: return 0;
+        case SOUTH: return 1;
+        case EAST: return 2;
+        case WEST: return 3;
+    }
+    return 0;
+}
+
+const Direction MOVE_DIRECTIONS[4] = {NORTH, SOUTH, EAST, WEST};
+
+inline Point stepPoint(Point p, Direction dir) {
+    switch (dir) {
+        case NORTH: return {p.x, p.y - 1};
+        case SOUTH: return {p.x, p.y + 1};
+        case EAST: return {p.x + 1, p.y};
+        case WEST: return {p.x - 1, p.y};
+    }
+    return p;
+}
+
+// Direction of the step from one cell to an adjacent one
+inline Direction directionTo(Point from, Point to) {
+    if (to.x > from.x) return EAST;
+    if (to.x < from.x) return WEST;
+    return to.y > from.y ? SOUTH : NORTH;
+}
+
+class PackedPath {
+public:
+    // Walks the cells of a path; incrementing applies one move
+    class Iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Point value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Point* pointer;
+        typedef const Point& reference;
+
+        Iterator() = default;
+        Iterator(const PackedPath* path, size_t index, Point at) : path(path), index(index), at(at) {}
+
+        const Point& operator*() const { return at; }
+        const Point* operator->() const { return &at; }
+
+        Iterator& operator++() {
+            if (index < path->steps()) at = stepPoint(at, path->move(index));
+            ++index;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator before = *this;
+            ++*this;
+            return before;
+        }
+
+        bool operator==(const Iterator& other) const { return index == other.index; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+
+        // Cells walked so far (0 at the start)
+        size_t step() const { return index; }
+
+    private:
+        const PackedPath* path = nullptr;
+        size_t index = 0;
+        Point at = {0, 0};
+    };
+
+    PackedPath() = default;
+    explicit PackedPath(Point start, size_t steps = 0) { reset(start, steps); }
+
+    // A path from start of steps moves, all north until they are set
+    void reset(Point start, size_t steps = 0) {
+        first = last = start;
+        count = steps;
+        started = true;
+        moves.assign((steps + 3) / 4, 0);
+    }
+
+    void clear() {
+        count = 0;
+        started = false;
+        moves.clear();
+    }
+
+    void push(Direction dir) {
+        if (count % 4 == 0) moves.push_back(0);
+        moves[count / 4] |= static_cast<uint8_t>(moveCode(dir) << ((count & 3) * 2));
+        ++count;
+        last = stepPoint(last, dir);
+    }
+
+    // Appends the step to an adjacent cell
+    void push(Point next) { push(directionTo(last, next)); }
+
+    // Sets move i of a path sized by reset; the end cell is only right once every move is set
+    void setMove(size_t i, Direction dir) {
+        uint8_t& byte = moves[i / 4];
+        int shift = static_cast<int>(i & 3) * 2;
+        byte = static_cast<uint8_t>((byte & ~(3 << shift)) | (moveCode(dir) << shift));
+    }
+
+    // For paths filled with setMove: the cell after the last move
+    void setEnd(Point end) { last = end; }
+
+    Direction move(size_t i) const { return MOVE_DIRECTIONS[(moves[i / 4] >> ((i & 3) * 2)) & 3]; }
+
+    bool empty() const { return !started; }
+    size_t steps() const { return count; }
+    size_t size() const { return started ? count + 1 : 0; } // Cells, start and end included
+    Point startPoint() const { return first; }
+    Point endPoint() const { return last; }
+    const std::vector<uint8_t>& bytes() const { return moves; }
+    size_t memoryBytes() const { return moves.capacity(); }
+
+    Iterator begin() const { return Iterator(this, 0, first); }
+    Iterator end() const { return Iterator(this, size(), last); }
+
+private:
+    Point first = {0, 0}, last = {0, 0};
+    size_t count = 0;
+    bool started = false;
+    std::vector<uint8_t> moves;
+};
+
+// Streams a path of known length to a file. Moves can be given first to last (push) or
+// last to first (pushBackward, for a walk back from the goal); either way only one chunk
+// of moves is in memory.
+class PathFileWriter {
+public:
+    ~PathFileWriter() {
+        if (file) std::fclose(file);
+    }
+
+    bool open(const std::string& path, Point start, uint64_t steps) {
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        total = steps;
+        written = 0;
+        chunkBegin = NO_CHUNK;
+        chunk.assign(PATH_FILE_CHUNK, 0);
+        uint8_t header[PATH_FILE_HEADER] = {'M', 'Z', 'P', 'T', PATH_FILE_VERSION};
+        putFixed(header + 8, static_cast<uint32_t>(start.x), 4);
+        putFixed(header + 12, static_cast<uint32_t>(start.y), 4);
+        putFixed(header + 16, steps, 8);
+        ok = std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+        return ok;
+    }
+
+    void push(Direction dir) { put(written++, dir); }
+    void pushBackward(Direction dir) { put(total - ++written, dir); }
+
+    // False if a write failed or not every move was given
+    bool close() {
+        if (!file) return false;
+        flush();
+        ok = ok && written == total;
+        ok = std::fclose(file) == 0 && ok;
+        file = nullptr;
+        return ok;
+    }
+
+    uint64_t fileBytes() const { return PATH_FILE_HEADER + (total + 3) / 4; }
+
+private:
+    static const uint64_t NO_CHUNK = ~uint64_t(0);
+
+    std::FILE* file = nullptr;
+    uint64_t total = 0, written = 0, chunkBegin = NO_CHUNK;
+    std::vector<uint8_t> chunk;
+    bool ok = false;
+
+    void put(uint64_t i, Direction dir) {
+        if (i >= total) {
+            ok = false;
+            return;
+        }
+        uint64_t byte = i / 4;
+        if (chunkBegin == NO_CHUNK || byte < chunkBegin || byte >= chunkBegin + chunk.size()) {
+            flush();
+            chunkBegin = byte / chunk.size() * chunk.size();
+            std::fill(chunk.begin(), chunk.end(), 0);
+        }
+        chunk[byte - chunkBegin] |= static_cast<uint8_t>(moveCode(dir) << ((i & 3) * 2));
+    }
+
+    void flush() {
+        if (chunkBegin == NO_CHUNK) return;
+        size_t bytes = static_cast<size_t>(std::min<uint64_t>(chunk.size(), (total + 3) / 4 - chunkBegin));
+        ok = ok && fseeko(file, static_cast<off_t>(PATH_FILE_HEADER + chunkBegin), SEEK_SET) == 0 && std::fwrite(chunk.data(), 1, bytes, file) == bytes;
+        chunkBegin = NO_CHUNK;
+    }
+};
+
+// Reads a path file back a cell at a time, a chunk of moves at a time
+class PathFileReader {
+public:
+    ~PathFileReader() {
+        if (file) std::fclose(file);
+    }
+
+    bool open(const std::string& path) {
+        file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+        uint8_t header[PATH_FILE_HEADER];
+        if (std::fread(header, 1, sizeof(header), file) != sizeof(header)) return false;
+        if (header[0] != 'M' || header[1] != 'Z' || header[2] != 'P' || header[3] != 'T' || header[4] != PATH_FILE_VERSION) return false;
+        at = {static_cast<int>(getFixed(header + 8, 4)), static_cast<int>(getFixed(header + 12, 4))};
+        begin = at;
+        total = getFixed(header + 16, 8);
+        index = 0;
+        return true;
+    }
+
+    Point start() const { return begin; }
+    uint64_t steps() const { return total; }
+
+    // The next cell of the path, start first; false after the last cell or on a read error
+    bool next(Point& cell) {
+        if (index > total) return false;
+        if (index > 0) {
+            uint64_t i = index - 1;
+            if (i % (4 * PATH_FILE_CHUNK) == 0) {
+                size_t bytes = static_cast<size_t>(std::min<uint64_t>(PATH_FILE_CHUNK, (total + 3) / 4 - i / 4));
+                chunk.resize(bytes);
+                if (std::fread(chunk.data(), 1, bytes, file) != bytes) return false;
+            }
+            size_t offset = static_cast<size_t>(i % (4 * PATH_FILE_CHUNK));
+            at = stepPoint(at, MOVE_DIRECTIONS[(chunk[offset / 4] >> ((offset & 3) * 2)) & 3]);
+        }
+        ++index;
+        cell = at;
+        return true;
+    }
+
+private:
+    std::FILE* file = nullptr;
+    Point at = {0, 0}, begin = {0, 0};
+    uint64_t total = 0, index = 0;
+    std::vector<uint8_t> chunk;
+};
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef MAZE_PROFILE_H
+#define MAZE_PROFILE_H
+
+// Built-in phase timers, counters and a frame-time histogram.
+//
+// Compile with -DMAZE_PROFILE to enable. Without it every MAZE_PROFILE_* macro expands
+// to nothing, so instrumented code costs exactly what it did before.
+//
+//   MAZE_PROFILE_SCOPE(PHASE_SOLVE);                  time the rest of the enclosing scope
+//   MAZE_PROFILE_COUNT(COUNTER_NODES_EXPANDED, 1);    bump a counter
+//   MAZE_PROFILE_FRAME();                             mark the end of a frame
+//   MAZE_PROFILE_KEY(event);                          F1 toggles the overlay
+//   MAZE_PROFILE_HUD(renderer);                       draw the overlay if it is visible
+//   MAZE_PROFILE_DUMP("maze_profile.json");           write everything as JSON
+
+enum ProfilePhase { PHASE_GENERATE, PHASE_SOLVE, PHASE_DRAW, PHASE_PRESENT, PHASE_EVENTS, PHASE_COUNT };
+enum ProfileCounter { COUNTER_CELLS_CARVED, COUNTER_NODES_EXPANDED, COUNTER_DRAW_CALLS, COUNTER_COUNT };
+
+#ifdef MAZE_PROFILE
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "maze_font.h"
+
+const char* const PHASE_NAMES[PHASE_COUNT] = {"generate", "solve", "draw", "present", "events"};
+const char* const COUNTER_NAMES[COUNTER_COUNT] = {"cells_carved", "nodes_expanded", "draw_calls"};
+
+// Frame times in 0.1 ms buckets up to 100 ms; slower frames land in the last bucket
+class FrameHistogram {
+public:
+    static const int BUCKETS = 1001;
+    static constexpr double BUCKET_MS = 0.1;
+
+    void record(uint64_t ns) {
+        uint64_t bucket = ns / 100000;
+        ++counts[bucket < BUCKETS ? bucket : BUCKETS - 1];
+        ++frames;
+        if (ns > maxNs) maxNs = ns;
+    }
+
+    // Upper edge of the bucket holding the given fraction of frames, in milliseconds
+    double percentile(double p) const {
+        if (frames == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(p * (frames - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= target) return (i + 1) * BUCKET_MS;
+        }
+        return BUCKETS * BUCKET_MS;
+    }
+
+    uint64_t count() const { return frames; }
+    uint64_t bucket(int i) const { return counts[i]; }
+    double maxMs() const { return maxNs / 1e6; }
+
+private:
+    uint64_t counts[BUCKETS] = {};
+    uint64_t frames = 0;
+    uint64_t maxNs = 0;
+};
+
+class Profiler {
+public:
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    // Phases may run on worker threads, so totals are relaxed atomics
+    void addPhase(ProfilePhase phase, uint64_t ns) {
+        phaseNs[phase].fetch_add(ns, std::memory_order_relaxed);
+        phaseCalls[phase].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void count(ProfileCounter counter, uint64_t n) {
+        counters[counter].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Called from the render thread once per presented frame
+    void frame() {
+        auto now = std::chrono::steady_clock::now();
+        if (haveLastFrame) histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastFrame).count());
+        lastFrame = now;
+        haveLastFrame = true;
+    }
+
+    void handleKey(const SDL_Event& e) {
+        if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F1) hudVisible = !hudVisible;
+    }
+
+    void drawHud(SDL_Renderer* renderer) {
+        if (!hudVisible) return;
+        const int scale = 2;
+        const int line = 7 * scale;
+
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 200);
+        SDL_Rect panel = {4, 4, 280, line * (PHASE_COUNT + COUNTER_COUNT + 2) + 60};
+        SDL_RenderFillRect(renderer, &panel);
+
+        SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
+        int y = 8;
+        for (int i = 0; i < PHASE_COUNT; ++i) {
+            uint64_t calls = phaseCalls[i].load(std::memory_order_relaxed);
+            double total = phaseNs[i].load(std::memory_order_relaxed) / 1e6;
+            drawText(renderer, 8, y, scale, std::string(PHASE_NAMES[i]) + " " + format(total) + "MS/" + std::to_string(calls));
+            y += line;
+        }
+        for (int i = 0; i < COUNTER_COUNT; ++i) {
+            drawText(renderer, 8, y, scale, std::string(COUNTER_NAMES[i]) + " " + std::to_string(counters[i].load(std::memory_order_relaxed)));
+            y += line;
+        }
+        drawText(renderer, 8, y, scale, "P50 " + format(histogram.percentile(0.5)) + " P99 " + format(histogram.percentile(0.99)) + " MS");
+        y += line + 4;
+
+        // Histogram of the first 50 ms, one 2-pixel bar per millisecond
+        uint64_t peak = 1;
+        uint64_t bars[50] = {};
+        for (int i = 0; i < 500; ++i) bars[i / 10] += histogram.bucket(i);
+        for (uint64_t bar : bars) if (bar > peak) peak = bar;
+        SDL_SetRenderDrawColor(renderer, 0, 200, 255, 255);
+        for (int i = 0; i < 50; ++i) {
+            int h = static_cast<int>(40 * bars[i] / peak);
+            SDL_Rect rect = {8 + i * 5, y + 40 - h, 4, h};
+            SDL_RenderFillRect(renderer, &rect);
+        }
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    }
+
+    bool dump(const std::string& path) const {
+        std::FILE* out = std::fopen(path.c_str(), "w");
+        if (!out) return false;
+        std::fprintf(out, "{\n  \"phases\": {\n");
+        for (int i = 0; i < PHASE_COUNT; ++i) {
+            uint64_t calls = phaseCalls[i].load();
+            double total = phaseNs[i].load() / 1e6;
+            std::fprintf(out, "    \"%s\": {\"calls\": %llu, \"total_ms\": %.3f, \"avg_ms\": %.3f}%s\n", PHASE_NAMES[i],
+                         static_cast<unsigned long long>(calls), total, calls ? total / calls : 0.0, i + 1 < PHASE_COUNT ? "," : "");
+        }
+        std::fprintf(out, "  },\n  \"counters\": {\n");
+        for (int i = 0; i < COUNTER_COUNT; ++i) {
+            std::fprintf(out, "    \"%s\": %llu%s\n", COUNTER_NAMES[i], static_cast<unsigned long long>(counters[i].load()),
+                         i + 1 < COUNTER_COUNT ? "," : "");
+        }
+        std::fprintf(out, "  },\n  \"frames\": {\"count\": %llu, \"p50_ms\": %.1f, \"p99_ms\": %.1f, \"max_ms\": %.3f}\n}\n",
+                     static_cast<unsigned long long>(histogram.count()), histogram.percentile(0.5), histogram.percentile(0.99),
+                     histogram.maxMs());
+        std::fclose(out);
+        return true;
+    }
+
+private:
+    std::atomic<uint64_t> phaseNs[PHASE_COUNT] = {};
+    std::atomic<uint64_t> phaseCalls[PHASE_COUNT] = {};
+    std::atomic<uint64_t> counters[COUNTER_COUNT] = {};
+    FrameHistogram histogram;
+    std::chrono::steady_clock::time_point lastFrame;
+    bool haveLastFrame = false;
+    bool hudVisible = false;
+
+    static std::string format(double value) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.1f", value);
+        return text;
+    }
+};
+
+// Adds the time from construction to destruction to a phase
+class ScopedTimer {
+public:
+    explicit ScopedTimer(ProfilePhase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        Profiler::instance().addPhase(phase, static_cast<uint64_t>(ns));
+    }
+
+private:
+    ProfilePhase phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define MAZE_PROFILE_CONCAT_(a, b) a##b
+#define MAZE_PROFILE_CONCAT(a, b) MAZE_PROFILE_CONCAT_(a, b)
+#define MAZE_PROFILE_SCOPE(phase) ScopedTimer MAZE_PROFILE_CONCAT(profileTimer, __LINE__)(phase)
+#define MAZE_PROFILE_COUNT(counter, n) Profiler::instance().count(counter, n)
+#define MAZE_PROFILE_FRAME() Profiler::instance().frame()
+#define MAZE_PROFILE_KEY(event) Profiler::instance().handleKey(event)
+#define MAZE_PROFILE_HUD(renderer) Profiler::instance().drawHud(renderer)
+#define MAZE_PROFILE_DUMP(path) Profiler::instance().dump(path)
+
+#else
+
+#define MAZE_PROFILE_SCOPE(phase) ((void)0)
+#define MAZE_PROFILE_COUNT(counter, n) ((void)0)
+#define MAZE_PROFILE_FRAME() ((void)0)
+#define MAZE_PROFILE_KEY(event) ((void)0)
+#define MAZE_PROFILE_HUD(renderer) ((void)0)
+#define MAZE_PROFILE_DUMP(path) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,150 @@
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include "maze_log.h"
+
+// Replays an event log written with --record, at any speed and from any step
+const int WINDOW_SIZE = 800;
+const double MIN_RATE = 1.0 / 16;   // Steps per frame when slowed all the way down
+const double MAX_RATE = 1 << 20;    // Steps per frame when sped all the way up
+
+class Replay {
+public:
+    Replay(EventLogReader& reader, double rate) : reader(reader), rate(rate) {
+        const Grid& grid = reader.state();
+        cellSize = std::max(1, WINDOW_SIZE / std::max(grid.width, grid.height));
+    }
+
+    void handleKey(SDL_Keycode key) {
+        uint64_t total = reader.stepCount();
+        uint64_t jump = std::max<uint64_t>(1, total / 100);
+        switch (key) {
+            case SDLK_SPACE: paused = !paused; break;
+            case SDLK_UP: case SDLK_EQUALS: case SDLK_PLUS: rate = std::min(MAX_RATE, rate * 2); break;
+            case SDLK_DOWN: case SDLK_MINUS: rate = std::max(MIN_RATE, rate / 2); break;
+            case SDLK_RIGHT: reader.seek(reader.position() + jump); break;
+            case SDLK_LEFT: reader.seek(reader.position() > jump ? reader.position() - jump : 0); break;
+            case SDLK_PAGEUP: reader.seek(reader.position() + jump * 10); break;
+            case SDLK_PAGEDOWN: reader.seek(reader.position() > jump * 10 ? reader.position() - jump * 10 : 0); break;
+            case SDLK_HOME: reader.seek(0); break;
+            case SDLK_END: reader.seek(total); break;
+        }
+        pending = 0;
+    }
+
+    // Advance by the current rate; fractional rates accumulate across frames
+    void update() {
+        if (paused) return;
+        pending += rate;
+        while (pending >= 1) {
+            if (!reader.advance()) {
+                pending = 0;
+                break;
+            }
+            pending -= 1;
+        }
+    }
+
+    void draw(SDL_Renderer* renderer) {
+        const Grid& grid = reader.state();
+        const std::vector<uint8_t>& marks = reader.cellMarks();
+
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+
+        for (int y = 0; y < grid.height; ++y) {
+            for (int x = 0; x < grid.width; ++x) {
+                uint32_t cell = grid.index(x, y);
+                int x1 = x * cellSize;
+                int y1 = y * cellSize;
+
+                if (marks[cell] != MARK_NONE) {
+                    if (marks[cell] & MARK_PATH) SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
+                    else SDL_SetRenderDrawColor(renderer, 40, 40, 120, 255);
+                    SDL_Rect rect = {x1, y1, cellSize, cellSize};
+                    SDL_RenderFillRect(renderer, &rect);
+                }
+
+                SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+                if (!grid.isOpen(cell, NORTH)) SDL_RenderDrawLine(renderer, x1, y1, x1 + cellSize, y1);
+                if (!grid.isOpen(cell, WEST)) SDL_RenderDrawLine(renderer, x1, y1, x1, y1 + cellSize);
+                if (x == grid.width - 1) SDL_RenderDrawLine(renderer, x1 + cellSize, y1, x1 + cellSize, y1 + cellSize);
+                if (y == grid.height - 1) SDL_RenderDrawLine(renderer, x1, y1 + cellSize, x1 + cellSize, y1 + cellSize);
+            }
+        }
+
+        // Highlight the cell touched by the last event
+        Point cursor = grid.point(reader.cursor());
+        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+        SDL_Rect rect = {cursor.x * cellSize + cellSize / 4, cursor.y * cellSize + cellSize / 4, std::max(1, cellSize / 2), std::max(1, cellSize / 2)};
+        SDL_RenderFillRect(renderer, &rect);
+
+        SDL_RenderPresent(renderer);
+    }
+
+    std::string status() const {
+        return "Maze Replay - step " + std::to_string(reader.position()) + " / " + std::to_string(reader.stepCount()) +
+               " - " + std::to_string(rate) + " steps/frame" + (paused ? " (paused)" : "");
+    }
+
+private:
+    EventLogReader& reader;
+    double rate;
+    double pending = 0;
+    bool paused = false;
+    int cellSize;
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: maze_replay <log> [--rate steps-per-frame] [--step start]" << std::endl;
+        return 1;
+    }
+
+    std::string path = argv[1];
+    double rate = 1;
+    uint64_t start = 0;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--rate" && i + 1 < argc) rate = std::clamp(std::stod(argv[++i]), MIN_RATE, MAX_RATE);
+        else if (arg == "--step" && i + 1 < argc) start = std::stoull(argv[++i]);
+    }
+
+    EventLogReader reader;
+    if (!reader.open(path)) {
+        std::cerr << "Failed to read event log: " << path << std::endl;
+        return 1;
+    }
+    reader.seek(start);
+
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    SDL_Window* window = SDL_CreateWindow("Maze Replay", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_SIZE, WINDOW_SIZE, SDL_WINDOW_SHOWN);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    if (!window || !renderer) {
+        std::cerr << "SDL Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    Replay replay(reader, rate);
+    bool quit = false;
+    SDL_Event e;
+    while (!quit) {
+        while (SDL_PollEvent(&e) != 0) {
+            if (e.type == SDL_QUIT) quit = true;
+            else if (e.type == SDL_KEYDOWN) replay.handleKey(e.key.keysym.sym);
+        }
+
+        replay.update();
+        replay.draw(renderer);
+        SDL_SetWindowTitle(window, replay.status().c_str());
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
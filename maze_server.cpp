@@ -0,0 +1,473 @@
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <unordered_map>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "maze_grid.h"
+#include "maze_generators.h"
+#include "maze_path.h"
+#include "lru_cache.h"
+#include "latency_histogram.h"
+
+// Long-running maze service on a Unix domain socket.
+//
+// The main thread polls every connection and hands each complete request line to the
+// worker pool, so a worker is only busy while a request is being answered; idle or
+// persistent clients cost nothing but a poll entry. A connection has at most one request
+// in the pool at a time, so its responses come back in order. Concurrent misses on the
+// same maze or solver index wait for the one build already running instead of repeating it.
+//
+// Requests are text lines; responses are a text header line followed by a binary payload:
+//   GEN <algorithm> <seed> <width> <height> [<fromX> <fromY> <toX> <toY>]
+//     -> OK <width> <height> <mazeBytes> <pathSteps> <pathBytes>\n <packed maze> <packed path>
+//   STATS
+//     -> OK <key=value ...>\n
+// The maze uses the 2-bit packed row format from maze_grid.h. The path is packed four moves
+// per byte, lowest bits first: 0 north, 1 south, 2 east, 3 west (maze_path.h).
+const char* DEFAULT_SOCKET = "/tmp/maze.sock";
+const size_t DEFAULT_CACHE_MB = 256;
+const int MAX_DIMENSION = 1 << 15;
+const size_t BYTES_PER_CELL = 2;        // Cached grid, its packed copy and a solver index
+const size_t MAX_CACHE_SHARE = 8;       // One maze may use at most this fraction of the maze cache
+const size_t MAX_LINE = 4096;           // Longest request line before the client is dropped
+const int SEND_TIMEOUT_SECONDS = 5;     // A client that stops reading loses its connection
+
+struct CachedMaze {
+    Grid grid;
+    std::vector<uint8_t> packed;
+};
+
+// BFS tree rooted at one cell: for every reached cell, the direction of its parent
+struct SolverIndex {
+    std::vector<uint8_t> parent;
+};
+
+std::atomic<bool> running(true);
+int wakePipe[2] = {-1, -1}; // Written to wake the poll loop
+
+void onSignal(int) {
+    running = false;
+    if (wakePipe[1] >= 0) (void)!write(wakePipe[1], "x", 1);
+}
+
+// Builds each missing key once: requests that miss while a build of the same key is running
+// wait for its result
+template <typename Value>
+class SingleFlight {
+public:
+    // build(bytes) returns the value and sets its cache size
+    template <typename Build>
+    std::shared_ptr<const Value> get(LruCache<std::string, Value>& cache, const std::string& key, Build build) {
+        std::shared_ptr<Call> call;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (auto hit = cache.get(key)) return hit;
+            auto it = calls.find(key);
+            if (it != calls.end()) {
+                call = it->second;
+                ++waited;
+                finished.wait(lock, [&] { return call->ready; });
+                return call->value;
+            }
+            call = std::make_shared<Call>();
+            calls[key] = call;
+        }
+        size_t bytes = 0;
+        std::shared_ptr<const Value> value = build(bytes);
+        cache.put(key, value, bytes); // Before the call is dropped, so later lookups hit
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            call->value = value;
+            call->ready = true;
+            calls.erase(key);
+        }
+        finished.notify_all();
+        return value;
+    }
+
+    // Requests that waited for another request's build
+    uint64_t shared() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return waited;
+    }
+
+private:
+    struct Call {
+        bool ready = false;
+        std::shared_ptr<const Value> value;
+    };
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::unordered_map<std::string, std::shared_ptr<Call>> calls;
+    uint64_t waited = 0;
+};
+
+class MazeService {
+public:
+    explicit MazeService(size_t cacheBytes)
+        : mazes(cacheBytes / 4 * 3), indices(cacheBytes / 4), maxCells(cacheBytes / 4 * 3 / MAX_CACHE_SHARE / BYTES_PER_CELL),
+          started(std::chrono::steady_clock::now()) {}
+
+    // Handle one request line; fills header and payload of the response
+    void handle(const std::string& line, std::string& header, std::string& payload) {
+        auto begin = std::chrono::steady_clock::now();
+        std::istringstream in(line);
+        std::string command;
+        in >> command;
+        payload.clear();
+
+        if (command == "GEN") {
+            generate(in, header, payload);
+        } else if (command == "STATS") {
+            header = "OK " + stats() + "\n";
+            return; // Not counted as a request
+        } else {
+            header = "ERR unknown command\n";
+        }
+
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+        latency.record(static_cast<uint64_t>(us));
+    }
+
+private:
+    LruCache<std::string, CachedMaze> mazes;
+    LruCache<std::string, SolverIndex> indices;
+    SingleFlight<CachedMaze> mazeBuilds;
+    SingleFlight<SolverIndex> indexBuilds;
+    uint64_t maxCells; // Largest maze a request may ask for
+    LatencyHistogram latency;
+    std::chrono::steady_clock::time_point started;
+
+    void generate(std::istringstream& in, std::string& header, std::string& payload) {
+        std::string algorithm;
+        uint64_t seed = 0;
+        int width = 0, height = 0;
+        if (!(in >> algorithm >> seed >> width >> height)) {
+            header = "ERR expected: GEN <algorithm> <seed> <width> <height> [<fromX> <fromY> <toX> <toY>]\n";
+            return;
+        }
+        const GeneratorInfo* generator = findGenerator(algorithm);
+        if (!generator) {
+            header = "ERR unknown algorithm\n";
+            return;
+        }
+        if (width < 1 || height < 1 || width > MAX_DIMENSION || height > MAX_DIMENSION) {
+            header = "ERR bad size\n";
+            return;
+        }
+        if (static_cast<uint64_t>(width) * height > maxCells) {
+            header = "ERR maze too large for the cache (at most " + std::to_string(maxCells) + " cells)\n";
+            return;
+        }
+        Point from, to;
+        bool solve = static_cast<bool>(in >> from.x >> from.y >> to.x >> to.y);
+        if (solve && !(inside(from, width, height) && inside(to, width, height))) {
+            header = "ERR solve endpoints outside the maze\n";
+            return;
+        }
+
+        std::string key = algorithm + ":" + std::to_string(seed) + ":" + std::to_string(width) + "x" + std::to_string(height);
+        std::shared_ptr<const CachedMaze> maze = mazeBuilds.get(mazes, key, [&](size_t& bytes) {
+            auto fresh = std::make_shared<CachedMaze>();
+            fresh->grid = buildMaze(*generator, seed, width, height);
+            fresh->packed = packGrid(fresh->grid);
+            bytes = fresh->grid.cells.size() + fresh->packed.size();
+            return fresh;
+        });
+        payload.assign(maze->packed.begin(), maze->packed.end());
+
+        PackedPath path;
+        if (solve) {
+            uint32_t root = maze->grid.index(from.x, from.y);
+            std::string indexKey = key + "@" + std::to_string(root);
+            std::shared_ptr<const SolverIndex> index = indexBuilds.get(indices, indexKey, [&](size_t& bytes) {
+                auto fresh = std::make_shared<SolverIndex>(buildIndex(maze->grid, root));
+                bytes = fresh->parent.size();
+                return fresh;
+            });
+            if (!tracePath(maze->grid, *index, root, maze->grid.index(to.x, to.y), path)) {
+                header = "ERR no path\n";
+                payload.clear();
+                return;
+            }
+        }
+
+        payload.append(path.bytes().begin(), path.bytes().end());
+        header = "OK " + std::to_string(width) + " " + std::to_string(height) + " " + std::to_string(maze->packed.size()) + " " +
+                 std::to_string(path.steps()) + " " + std::to_string(path.bytes().size()) + "\n";
+    }
+
+    static bool inside(const Point& p, int width, int height) {
+        return p.x >= 0 && p.y >= 0 && p.x < width && p.y < height;
+    }
+
+    // Breadth-first search from root; any later query from the same cell is a walk up the tree
+    static SolverIndex buildIndex(const Grid& grid, uint32_t root) {
+        SolverIndex index;
+        index.parent.assign(grid.size(), 0);
+        std::vector<uint32_t> queue = {root};
+        std::vector<uint8_t> seen(grid.size(), 0);
+        seen[root] = 1;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            uint32_t cell = queue[head];
+            for (Direction dir : DIRECTIONS) {
+                uint32_t next = 0;
+                if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next) && !seen[next]) {
+                    seen[next] = 1;
+                    index.parent[next] = opposite(dir);
+                    queue.push_back(next);
+                }
+            }
+        }
+        return index;
+    }
+
+    // Walks up the tree from target to count the steps, then again to fill the moves from the last one
+    static bool tracePath(const Grid& grid, const SolverIndex& index, uint32_t root, uint32_t target, PackedPath& path) {
+        size_t steps = 0;
+        for (uint32_t cell = target; cell != root; ++steps) {
+            Direction up = static_cast<Direction>(index.parent[cell]);
+            if (!up) return false;
+            grid.neighbor(cell, up, cell);
+        }
+        path.reset(grid.point(root), steps);
+        for (uint32_t cell = target; cell != root;) {
+            Direction up = static_cast<Direction>(index.parent[cell]);
+            path.setMove(--steps, opposite(up)); // Step from the parent down to this cell
+            grid.neighbor(cell, up, cell);
+        }
+        path.setEnd(grid.point(target));
+        return true;
+    }
+
+    std::string stats() {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        auto mazeStats = mazes.stats();
+        auto indexStats = indices.stats();
+        std::ostringstream out;
+        out << "requests=" << latency.count() << " throughput_rps=" << static_cast<uint64_t>(latency.count() / seconds)
+            << " mean_us=" << static_cast<uint64_t>(latency.meanUs()) << " p50_us=" << latency.percentileUs(0.50)
+            << " p95_us=" << latency.percentileUs(0.95) << " p99_us=" << latency.percentileUs(0.99)
+            << " maze_hits=" << mazeStats.hits << " maze_misses=" << mazeStats.misses << " maze_entries=" << mazeStats.entries
+            << " maze_bytes=" << mazeStats.bytes << " index_hits=" << indexStats.hits << " index_misses=" << indexStats.misses
+            << " index_bytes=" << indexStats.bytes << " evictions=" << mazeStats.evictions + indexStats.evictions
+            << " shared_builds=" << mazeBuilds.shared() + indexBuilds.shared();
+        return out.str();
+    }
+};
+
+// One request line read off a connection, for the worker pool
+struct Request {
+    int fd;
+    std::string line;
+};
+
+// Blocking queue of requests, drained by the worker pool
+class RequestQueue {
+public:
+    void push(Request request) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests.push_back(std::move(request));
+        }
+        ready.notify_one();
+    }
+
+    // False once the queue is closed and empty
+    bool pop(Request& request) {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [&] { return !requests.empty() || closed; });
+        if (requests.empty()) return false;
+        request = std::move(requests.front());
+        requests.pop_front();
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        ready.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<Request> requests;
+    bool closed = false;
+};
+
+// Connections whose response has been sent (or failed), reported back to the poll loop
+class Completions {
+public:
+    void push(int fd, bool ok) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.push_back({fd, ok});
+        }
+        (void)!write(wakePipe[1], "x", 1);
+    }
+
+    void take(std::vector<std::pair<int, bool>>& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        out.swap(done);
+        done.clear();
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<std::pair<int, bool>> done;
+};
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// A client as the poll loop sees it: bytes read so far, and whether a request is in the pool
+struct Connection {
+    std::string buffer;
+    bool busy = false;
+};
+
+// Hand the next complete line of an idle connection to the pool; false if the line is too long
+bool dispatch(int fd, Connection& connection, RequestQueue& requests) {
+    if (connection.busy) return true;
+    size_t newline = connection.buffer.find('\n');
+    if (newline == std::string::npos) return connection.buffer.size() <= MAX_LINE;
+    connection.busy = true;
+    requests.push({fd, connection.buffer.substr(0, newline)});
+    connection.buffer.erase(0, newline + 1);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string socketPath = DEFAULT_SOCKET;
+    size_t cacheMb = DEFAULT_CACHE_MB;
+    int workers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) socketPath = argv[++i];
+        else if (arg == "--cache-mb" && i + 1 < argc) cacheMb = std::stoul(argv[++i]);
+        else if (arg == "--workers" && i + 1 < argc) workers = std::max(1, std::stoi(argv[++i]));
+        else {
+            std::cerr << "Usage: maze_server [--socket path] [--cache-mb n] [--workers n]" << std::endl;
+            return 1;
+        }
+    }
+
+    int listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (listenSocket < 0 || socketPath.size() >= sizeof(address.sun_path) || pipe(wakePipe) != 0) {
+        std::cerr << "Failed to create socket" << std::endl;
+        return 1;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+    unlink(socketPath.c_str());
+    if (bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenSocket, 128) != 0) {
+        std::cerr << "Failed to listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    MazeService service(cacheMb << 20);
+    RequestQueue requests;
+    Completions completions;
+    std::vector<std::thread> pool;
+    for (int i = 0; i < workers; ++i) {
+        pool.emplace_back([&] {
+            std::string header, payload;
+            for (Request request; requests.pop(request);) {
+                service.handle(request.line, header, payload);
+                completions.push(request.fd, sendAll(request.fd, header) && sendAll(request.fd, payload));
+            }
+        });
+    }
+    std::cout << "Maze service listening on " << socketPath << " with " << workers << " workers and a " << cacheMb
+              << " MB cache" << std::endl;
+
+    std::unordered_map<int, Connection> connections;
+    std::vector<pollfd> polled;
+    std::vector<std::pair<int, bool>> done;
+    auto disconnect = [&](int fd) {
+        close(fd);
+        connections.erase(fd);
+    };
+    while (running) {
+        // Connections with a request in the pool are not read until it is answered
+        polled.assign({{listenSocket, POLLIN, 0}, {wakePipe[0], POLLIN, 0}});
+        for (const auto& [fd, connection] : connections) {
+            if (!connection.busy) polled.push_back({fd, POLLIN, 0});
+        }
+        if (poll(polled.data(), polled.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (polled[1].revents) {
+            char drain[64];
+            (void)!read(wakePipe[0], drain, sizeof(drain));
+            completions.take(done);
+            for (auto [fd, ok] : done) {
+                Connection& connection = connections[fd];
+                connection.busy = false;
+                if (!ok || !dispatch(fd, connection, requests)) disconnect(fd);
+            }
+        }
+        if (polled[0].revents & POLLIN) {
+            int fd = accept(listenSocket, nullptr, nullptr);
+            if (fd >= 0) {
+                timeval timeout = {SEND_TIMEOUT_SECONDS, 0};
+                setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                connections[fd];
+            }
+        }
+        for (size_t i = 2; i < polled.size(); ++i) {
+            if (!polled[i].revents) continue;
+            int fd = polled[i].fd;
+            char chunk[4096];
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                disconnect(fd);
+                continue;
+            }
+            Connection& connection = connections[fd];
+            connection.buffer.append(chunk, static_cast<size_t>(n));
+            if (!dispatch(fd, connection, requests)) disconnect(fd);
+        }
+    }
+
+    running = false;
+    requests.close();
+    for (auto& worker : pool) worker.join();
+    for (const auto& [fd, connection] : connections) close(fd);
+    close(listenSocket);
+    unlink(socketPath.c_str());
+    std::string header, payload;
+    service.handle("STATS", header, payload);
+    std::cout << "Shutting down: " << header;
+    return 0;
+}
@@ -0,0 +1,477 @@
+#ifndef MAZE_SOLVERS_H
+#define MAZE_SOLVERS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+#include "maze_grid.h"
+#include "radix_heap.h"
+
+// Headless solvers over the shared grid. Each one finds a path of cells from start to goal
+// and reports how much work and memory that took, so they can be compared on equal terms.
+
+struct SolveResult {
+    std::vector<uint32_t> path; // start .. goal, empty when there is no path
+    uint64_t expanded = 0;      // Cells expanded (searches) or moves made (walkers)
+    size_t peakBytes = 0;       // Largest working set of the solver's own buffers
+};
+
+template <typename T>
+size_t bufferBytes(const std::vector<T>& buffer) {
+    return buffer.capacity() * sizeof(T);
+}
+
+inline int directionIndex(Direction dir) {
+    switch (dir) {
+        case NORTH: return 0;
+        case SOUTH: return 1;
+        case EAST: return 2;
+        case WEST: return 3;
+    }
+    return 0;
+}
+
+inline uint32_t manhattan(const Grid& grid, uint32_t a, uint32_t b) {
+    Point p = grid.point(a), q = grid.point(b);
+    return static_cast<uint32_t>(std::abs(p.x - q.x) + std::abs(p.y - q.y));
+}
+
+// Follow parent directions (the step back towards the root) from goal to root
+inline void tracePath(const Grid& grid, const std::vector<uint8_t>& parent, uint32_t root, uint32_t goal, std::vector<uint32_t>& path) {
+    path.clear();
+    for (uint32_t cell = goal; cell != root;) {
+        path.push_back(cell);
+        grid.neighbor(cell, static_cast<Direction>(parent[cell]), cell);
+    }
+    path.push_back(root);
+    std::reverse(path.begin(), path.end());
+}
+
+// Breadth-first search; parent holds the direction back towards start (0 = unvisited)
+inline bool solveBfs(const Grid& grid, uint32_t start, uint32_t goal, SolveResult& result) {
+    std::vector<uint8_t> parent(grid.size(), 0);
+    std::vector<uint32_t> queue = {start};
+    parent[start] = 0xFF;
+    bool found = false;
+    for (size_t head = 0; head < queue.size() && !found; ++head) {
+        uint32_t cell = queue[head];
+        ++result.expanded;
+        if (cell == goal) found = true;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next) && !parent[next]) {
+                parent[next] = opposite(dir);
+                queue.push_back(next);
+            }
+        }
+    }
+    result.peakBytes = bufferBytes(parent) + bufferBytes(queue);
+    if (found) tracePath(grid, parent, start, goal, result.path);
+    return found;
+}
+
+// Breadth-first search from both ends, one whole level at a time from the smaller frontier.
+// The best meeting point over a level gives the shortest path.
+inline bool solveBidirectionalBfs(const Grid& grid, uint32_t start, uint32_t goal, SolveResult& result) {
+    if (start == goal) {
+        result.path = {start};
+        return true;
+    }
+    std::vector<uint8_t> side(grid.size(), 0);   // 1 reached from start, 2 from goal
+    std::vector<uint8_t> parent(grid.size(), 0); // Direction back towards that side's root
+    std::vector<uint32_t> depth(grid.size(), 0);
+    std::vector<uint32_t> frontier[2] = {{start}, {goal}}, next;
+    side[start] = 1;
+    side[goal] = 2;
+
+    uint32_t best = UINT32_MAX, meetA = 0, meetB = 0; // meetA on the start side, meetB on the goal side
+    size_t peakFrontier = 0;
+    while (best == UINT32_MAX && !frontier[0].empty() && !frontier[1].empty()) {
+        int s = frontier[0].size() <= frontier[1].size() ? 0 : 1;
+        uint8_t mine = static_cast<uint8_t>(s + 1);
+        next.clear();
+        for (uint32_t cell : frontier[s]) {
+            ++result.expanded;
+            for (Direction dir : DIRECTIONS) {
+                uint32_t to = 0;
+                if (!grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, to)) continue;
+                if (!side[to]) {
+                    side[to] = mine;
+                    parent[to] = opposite(dir);
+                    depth[to] = depth[cell] + 1;
+                    next.push_back(to);
+                } else if (side[to] != mine && depth[cell] + 1 + depth[to] < best) {
+                    best = depth[cell] + 1 + depth[to];
+                    meetA = s == 0 ? cell : to;
+                    meetB = s == 0 ? to : cell;
+                }
+            }
+        }
+        std::swap(frontier[s], next);
+        peakFrontier = std::max(peakFrontier, bufferBytes(frontier[0]) + bufferBytes(frontier[1]) + bufferBytes(next));
+    }
+    result.peakBytes = bufferBytes(side) + bufferBytes(parent) + bufferBytes(depth) + peakFrontier;
+    if (best == UINT32_MAX) return false;
+
+    tracePath(grid, parent, start, meetA, result.path);
+    for (uint32_t cell = meetB;;) {
+        result.path.push_back(cell);
+        if (cell == goal) break;
+        grid.neighbor(cell, static_cast<Direction>(parent[cell]), cell);
+    }
+    return true;
+}
+
+// A* with the Manhattan heuristic and a binary heap of (f << 32 | cell) keys; stale
+// entries are skipped when popped
+inline bool solveAStarHeap(const Grid& grid, uint32_t start, uint32_t goal, SolveResult& result) {
+    const uint32_t INF = UINT32_MAX;
+    std::vector<uint32_t> gScore(grid.size(), INF);
+    std::vector<uint8_t> parent(grid.size(), 0);
+    std::vector<uint64_t> open;
+    auto push = [&](uint32_t cell) {
+        open.push_back((static_cast<uint64_t>(gScore[cell] + manhattan(grid, cell, goal)) << 32) | cell);
+        std::push_heap(open.begin(), open.end(), std::greater<uint64_t>());
+    };
+
+    gScore[start] = 0;
+    push(start);
+    bool found = false;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), std::greater<uint64_t>());
+        uint64_t top = open.back();
+        open.pop_back();
+        uint32_t cell = static_cast<uint32_t>(top);
+        if ((top >> 32) != gScore[cell] + manhattan(grid, cell, goal)) continue;
+        ++result.expanded;
+        if (cell == goal) {
+            found = true;
+            break;
+        }
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (!grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, next)) continue;
+            if (gScore[cell] + 1 < gScore[next]) {
+                gScore[next] = gScore[cell] + 1;
+                parent[next] = opposite(dir);
+                push(next);
+            }
+        }
+    }
+    result.peakBytes = bufferBytes(gScore) + bufferBytes(parent) + bufferBytes(open);
+    if (found) tracePath(grid, parent, start, goal, result.path);
+    return found;
+}
+
+// A* with a bucket queue indexed by f. With unit steps and a consistent heuristic f never
+// decreases, so one cursor sweeps the buckets upwards; each bucket is a LIFO stack, which
+// breaks ties towards the deepest cell.
+inline bool solveAStarBuckets(const Grid& grid, uint32_t start, uint32_t goal, SolveResult& result) {
+    const uint32_t INF = UINT32_MAX;
+    std::vector<uint32_t> gScore(grid.size(), INF);
+    std::vector<uint8_t> parent(grid.size(), 0);
+    std::vector<std::vector<uint32_t>> buckets;
+    auto push = [&](uint32_t cell, uint32_t f) {
+        if (f >= buckets.size()) buckets.resize(f + 1);
+        buckets[f].push_back(cell);
+    };
+
+    gScore[start] = 0;
+    uint32_t f = manhattan(grid, start, goal);
+    push(start, f);
+    bool found = false;
+    for (; f < buckets.size() && !found; ++f) {
+        while (!buckets[f].empty()) {
+            uint32_t cell = buckets[f].back();
+            buckets[f].pop_back();
+            if (gScore[cell] + manhattan(grid, cell, goal) != f) continue;
+            ++result.expanded;
+            if (cell == goal) {
+                found = true;
+                break;
+            }
+            for (Direction dir : DIRECTIONS) {
+                uint32_t next = 0;
+                if (!grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, next)) continue;
+                if (gScore[cell] + 1 < gScore[next]) {
+                    gScore[next] = gScore[cell] + 1;
+                    parent[next] = opposite(dir);
+                    push(next, gScore[next] + manhattan(grid, next, goal));
+                }
+            }
+        }
+    }
+    result.peakBytes = bufferBytes(gScore) + bufferBytes(parent) + bufferBytes(buckets);
+    for (const auto& bucket : buckets) result.peakBytes += bufferBytes(bucket);
+    if (found) tracePath(grid, parent, start, goal, result.path);
+    return found;
+}
+
+// Push cell onto a walker's route, or pop when it steps back onto the previous cell, so
+// the route never holds a detour that was walked out and back again
+inline void walkRoute(std::vector<uint32_t>& route, uint32_t cell) {
+    if (route.size() >= 2 && route[route.size() - 2] == cell) route.pop_back();
+    else route.push_back(cell);
+}
+
+// Right-hand wall follower: keep a hand on the wall to the right. Reaches the goal in any
+// perfect maze; with loops it can circle an island forever, so it gives up after four
+// moves per cell.
+inline bool solveWallFollower(const Grid& grid, uint32_t start, uint32_t goal, SolveResult& result) {
+    // Clockwise order, so turning right is +1, left +3 and back +2
+    const Direction CLOCKWISE[4] = {NORTH, EAST, SOUTH, WEST};
+    std::vector<uint32_t> route = {start};
+    uint64_t limit = static_cast<uint64_t>(grid.size()) * 4 + 4;
+    uint32_t cell = start;
+    // Start with the right hand on the outer wall if there is one, so that with loops the
+    // walk still reaches a goal on the border; otherwise on any wall
+    int facing = -1;
+    uint32_t outside = 0;
+    for (int f = 0; f < 4 && facing < 0; ++f) {
+        if (!grid.neighbor(start, CLOCKWISE[(f + 1) % 4], outside)) facing = f;
+    }
+    for (int f = 0; f < 4 && facing < 0; ++f) {
+        if (!grid.isOpen(start, CLOCKWISE[(f + 1) % 4])) facing = f;
+    }
+    facing = std::max(facing, 0);
+    size_t peakRoute = 0;
+    while (cell != goal && result.expanded < limit) {
+        int turn = 1;
+        for (; turn < 5; ++turn) { // Right, straight, left, back
+            int heading = (facing + 6 - turn) % 4;
+            uint32_t next = 0;
+            if (grid.isOpen(cell, CLOCKWISE[heading]) && grid.neighbor(cell, CLOCKWISE[heading], next)) {
+                facing = heading;
+                cell = next;
+                break;
+            }
+        }
+        if (turn == 5) break; // Walled in
+        ++result.expanded;
+        walkRoute(route, cell);
+        peakRoute = std::max(peakRoute, bufferBytes(route));
+    }
+    result.peakBytes = std::max(peakRoute, bufferBytes(route));
+    if (cell != goal) return false;
+    result.path = std::move(route);
+    return true;
+}
+
+// Trémaux's algorithm: mark each passage as it is walked. Walk unmarked passages first,
+// turn back on reaching an already visited cell through a new passage, and never use a
+// passage marked twice. The passages marked once always form the route from start, and
+// every passage is walked at most twice, so it terminates in any maze.
+inline bool solveTremaux(const Grid& grid, uint32_t start, uint32_t goal, SolveResult& result) {
+    std::vector<uint8_t> marks(grid.size(), 0); // 2 bits per side, in directionIndex order
+    auto markOf = [&](uint32_t cell, Direction dir) { return (marks[cell] >> (2 * directionIndex(dir))) & 3; };
+    std::vector<uint32_t> route = {start};
+    uint32_t cell = start;
+    int entry = -1; // Side of cell we arrived through
+    while (cell != goal) {
+        int otherMarks = 0, choice = -1, choiceMark = 2;
+        for (int i = 0; i < 4; ++i) {
+            uint32_t next = 0;
+            if (i == entry || !grid.isOpen(cell, DIRECTIONS[i]) || !grid.neighbor(cell, DIRECTIONS[i], next)) continue;
+            int mark = markOf(cell, DIRECTIONS[i]);
+            otherMarks += mark;
+            if (mark < choiceMark) {
+                choice = i;
+                choiceMark = mark;
+            }
+        }
+        // Dead end, or a cell visited before reached through a new passage: go back
+        bool enteredFresh = entry >= 0 && markOf(cell, DIRECTIONS[entry]) == 1;
+        if (choice < 0 || (enteredFresh && otherMarks > 0)) choice = entry;
+        if (choice < 0 || markOf(cell, DIRECTIONS[choice]) >= 2) break; // Back at start with nothing left
+
+        Direction dir = DIRECTIONS[choice];
+        uint32_t next = 0;
+        grid.neighbor(cell, dir, next);
+        marks[cell] += static_cast<uint8_t>(1 << (2 * directionIndex(dir)));
+        marks[next] += static_cast<uint8_t>(1 << (2 * directionIndex(opposite(dir))));
+        ++result.expanded;
+        walkRoute(route, next);
+        cell = next;
+        entry = directionIndex(opposite(dir));
+    }
+    result.peakBytes = bufferBytes(marks) + bufferBytes(route);
+    if (cell != goal) return false;
+    result.path = std::move(route);
+    return true;
+}
+
+// Dead-end filling: repeatedly wall up dead ends other than start and goal until none are
+// left. In a perfect maze only the solution survives; with loops the loops survive too, so
+// the final walk is a breadth-first search over the surviving cells.
+inline bool solveDeadEndFilling(const Grid& grid, uint32_t start, uint32_t goal, SolveResult& result) {
+    std::vector<uint8_t> degree(grid.size()); // 0 once filled
+    std::vector<uint32_t> deadEnds;
+    for (uint32_t cell = 0; cell < grid.size(); ++cell) {
+        uint8_t count = 0;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next)) ++count;
+        }
+        degree[cell] = count;
+        if (count <= 1 && cell != start && cell != goal) deadEnds.push_back(cell);
+    }
+    while (!deadEnds.empty()) {
+        uint32_t cell = deadEnds.back();
+        deadEnds.pop_back();
+        degree[cell] = 0;
+        ++result.expanded;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (!grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, next) || !degree[next]) continue;
+            if (--degree[next] == 1 && next != start && next != goal) deadEnds.push_back(next);
+        }
+    }
+    size_t fillBytes = bufferBytes(degree) + bufferBytes(deadEnds);
+
+    std::vector<uint8_t> parent(grid.size(), 0);
+    std::vector<uint32_t> queue = {start};
+    parent[start] = 0xFF;
+    bool found = false;
+    for (size_t head = 0; head < queue.size() && !found; ++head) {
+        uint32_t cell = queue[head];
+        ++result.expanded;
+        found = cell == goal;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next) && degree[next] && !parent[next]) {
+                parent[next] = opposite(dir);
+                queue.push_back(next);
+            }
+        }
+    }
+    result.peakBytes = std::max(fillBytes, bufferBytes(degree) + bufferBytes(parent) + bufferBytes(queue));
+    if (found) tracePath(grid, parent, start, goal, result.path);
+    return found;
+}
+
+struct SolverInfo {
+    const char* name;
+    bool (*solve)(const Grid& grid, uint32_t start, uint32_t goal, SolveResult& result);
+    bool shortest;    // Always returns a shortest (for weighted solvers, cheapest) path
+    bool perfectOnly; // Only guaranteed to finish on perfect mazes
+};
+
+const SolverInfo SOLVERS[] = {
+    {"bfs", solveBfs, true, false},
+    {"bidirectional", solveBidirectionalBfs, true, false},
+    {"astar-heap", solveAStarHeap, true, false},
+    {"astar-buckets", solveAStarBuckets, true, false},
+    {"wall-follower", solveWallFollower, false, true},
+    {"tremaux", solveTremaux, false, false},
+    {"dead-end-fill", solveDeadEndFilling, true, false},
+};
+
+inline const SolverInfo* findSolver(const std::string& name) {
+    for (const SolverInfo& info : SOLVERS) {
+        if (name == info.name) return &info;
+    }
+    return nullptr;
+}
+
+// Weighted solvers over the terrain layer: stepping into a cell costs Grid::cost, and the
+// path found has the least total cost. Totals must fit in 32 bits.
+
+// Cost of walking a path: every cell entered after the first
+inline uint64_t pathCost(const Grid& grid, const std::vector<uint32_t>& path) {
+    uint64_t total = 0;
+    for (size_t i = 1; i < path.size(); ++i) total += grid.cost(path[i]);
+    return total;
+}
+
+// std::priority_queue of (key << 32 | cell), behind the same push/pop as RadixHeap
+class BinaryQueue {
+public:
+    struct Entry {
+        uint32_t key;
+        uint32_t value;
+    };
+
+    bool empty() const { return queue.empty(); }
+    void push(uint32_t key, uint32_t value) { queue.push((static_cast<uint64_t>(key) << 32) | value); }
+    Entry pop() {
+        uint64_t top = queue.top();
+        queue.pop();
+        return {static_cast<uint32_t>(top >> 32), static_cast<uint32_t>(top)};
+    }
+    size_t memoryBytes() const { return queue.size() * sizeof(uint64_t); } // Capacity is hidden; a lower bound
+
+private:
+    std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> queue;
+};
+
+// Dijkstra (scale 0) or A* with the Manhattan distance times scale as the heuristic. With
+// scale at most the cheapest cell cost every step costs at least as much as the heuristic
+// drops, so the heuristic is consistent and popped keys never decrease.
+template <typename Queue>
+bool solveWeighted(const Grid& grid, uint32_t start, uint32_t goal, uint32_t scale, SolveResult& result) {
+    const uint32_t INF = UINT32_MAX;
+    std::vector<uint32_t> gScore(grid.size(), INF);
+    std::vector<uint8_t> parent(grid.size(), 0);
+    Queue open;
+    size_t peakQueue = 0;
+    gScore[start] = 0;
+    open.push(manhattan(grid, start, goal) * scale, start);
+    bool found = false;
+    while (!open.empty()) {
+        auto [key, cell] = open.pop();
+        uint32_t g = gScore[cell];
+        if (key != g + manhattan(grid, cell, goal) * scale) continue; // Stale entry
+        ++result.expanded;
+        if (cell == goal) {
+            found = true;
+            break;
+        }
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (!grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, next)) continue;
+            uint32_t cost = g + grid.cost(next);
+            if (cost < gScore[next]) {
+                gScore[next] = cost;
+                parent[next] = opposite(dir);
+                open.push(cost + manhattan(grid, next, goal) * scale, next);
+            }
+        }
+        if ((result.expanded & 1023) == 0) peakQueue = std::max(peakQueue, open.memoryBytes());
+    }
+    result.peakBytes = bufferBytes(gScore) + bufferBytes(parent) + std::max(peakQueue, open.memoryBytes());
+    if (found) tracePath(grid, parent, start, goal, result.path);
+    return found;
+}
+
+inline uint32_t cheapestCost(const Grid& grid) {
+    return grid.costs.empty() ? 1 : std::max<uint32_t>(1, *std::min_element(grid.costs.begin(), grid.costs.end()));
+}
+
+inline bool solveDijkstraQueue(const Grid& grid, uint32_t start, uint32_t goal, SolveResult& result) {
+    return solveWeighted<BinaryQueue>(grid, start, goal, 0, result);
+}
+
+inline bool solveDijkstraRadix(const Grid& grid, uint32_t start, uint32_t goal, SolveResult& result) {
+    return solveWeighted<RadixHeap<uint32_t>>(grid, start, goal, 0, result);
+}
+
+inline bool solveAStarQueue(const Grid& grid, uint32_t start, uint32_t goal, SolveResult& result) {
+    return solveWeighted<BinaryQueue>(grid, start, goal, cheapestCost(grid), result);
+}
+
+inline bool solveAStarRadix(const Grid& grid, uint32_t start, uint32_t goal, SolveResult& result) {
+    return solveWeighted<RadixHeap<uint32_t>>(grid, start, goal, cheapestCost(grid), result);
+}
+
+const SolverInfo WEIGHTED_SOLVERS[] = {
+    {"dijkstra-queue", solveDijkstraQueue, true, false},
+    {"dijkstra-radix", solveDijkstraRadix, true, false},
+    {"astar-queue", solveAStarQueue, true, false},
+    {"astar-radix", solveAStarRadix, true, false},
+};
+
+#endif
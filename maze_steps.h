@@ -0,0 +1,765 @@
+#ifndef MAZE_STEPS_H
+#define MAZE_STEPS_H
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <random>
+#include <vector>
+#include "maze_grid.h"
+#include "maze_generators.h"
+#include "maze_log.h"
+#include "maze_solvers.h"
+
+// Generators and solvers written as C++20 coroutines that yield one step at a time, so the
+// same code runs flat out headless or a few steps per frame under a renderer, with no
+// threads, callbacks or sleeps inside the algorithm. Steps use the event kinds of the
+// event log (maze_log.h), so they can be drawn, recorded or just counted.
+//
+// Requires -std=c++20.
+//
+// Frames never touch the heap: every coroutine takes a StepArena as its first argument
+// and its frame is carved out of that arena. Resuming costs an indirect call, so a
+// generator can also collect a batch of steps per resume (setBatch); the consumer then
+// reads them all at once. Algorithms that work a row at a time can yield the row's steps
+// as one StepRun; they are still handed out a batch at a time.
+
+struct Step {
+    LogEvent event; // LOG_CARVE, LOG_VISIT, LOG_PATH or LOG_CLEAR
+    Direction dir;  // Passage direction for LOG_CARVE
+    uint32_t cell;
+};
+
+// Steps yielded together; they must stay valid until the coroutine resumes
+struct StepRun {
+    const Step* steps;
+    size_t count;
+};
+
+// Bump allocator for coroutine frames; space is reclaimed once every frame in it is gone
+class StepArena {
+public:
+    static constexpr size_t DEFAULT_BYTES = 16 * 1024;
+    static constexpr size_t ALIGN = 16;
+
+    explicit StepArena(size_t bytes = DEFAULT_BYTES) : buffer(bytes) {}
+
+    void* allocate(size_t size) noexcept {
+        size_t need = (size + ALIGN + ALIGN - 1) / ALIGN * ALIGN; // Header holding the arena, then the frame
+        if (used + need > buffer.size()) return nullptr;
+        std::byte* block = buffer.data() + used;
+        used += need;
+        ++live;
+        *reinterpret_cast<StepArena**>(block) = this;
+        return block + ALIGN;
+    }
+
+    static void release(void* frame) noexcept {
+        StepArena* arena = *reinterpret_cast<StepArena**>(static_cast<std::byte*>(frame) - ALIGN);
+        if (--arena->live == 0) arena->used = 0;
+    }
+
+    size_t bytesUsed() const { return used; }
+
+private:
+    std::vector<std::byte> buffer; // operator new alignment covers ALIGN
+    size_t used = 0;
+    int live = 0;
+};
+
+class StepGenerator {
+public:
+    static constexpr int MAX_BATCH = 256;
+
+    struct promise_type {
+        Step steps[MAX_BATCH];
+        int count = 0;
+        int batch = 1;
+        StepRun pending = {nullptr, 0}; // What is left of a run that overflowed the batch
+
+        // The frame comes from the arena passed as the coroutine's first argument
+        template <typename... Args>
+        static void* operator new(size_t size, StepArena& arena, Args&...) noexcept { return arena.allocate(size); }
+        static void operator delete(void* frame, size_t) noexcept { StepArena::release(frame); }
+        static StepGenerator get_return_object_on_allocation_failure() { return StepGenerator(nullptr); }
+
+        StepGenerator get_return_object() { return StepGenerator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        // Suspend only when the batch is full
+        struct BatchAwaiter {
+            bool full;
+            bool await_ready() const noexcept { return !full; }
+            void await_suspend(std::coroutine_handle<>) const noexcept {}
+            void await_resume() const noexcept {}
+        };
+
+        BatchAwaiter yield_value(const Step& step) noexcept {
+            steps[count++] = step;
+            return {count >= batch};
+        }
+
+        // Suspends while any of the run is left over
+        BatchAwaiter yield_value(StepRun run) noexcept {
+            pending = run;
+            takePending();
+            return {count >= batch};
+        }
+
+        void takePending() noexcept {
+            size_t take = std::min(pending.count, static_cast<size_t>(batch - count));
+            std::copy_n(pending.steps, take, steps + count);
+            count += static_cast<int>(take);
+            pending.steps += take;
+            pending.count -= take;
+        }
+    };
+
+    StepGenerator(StepGenerator&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    StepGenerator(const StepGenerator&) = delete;
+    StepGenerator& operator=(const StepGenerator&) = delete;
+    ~StepGenerator() {
+        if (handle) handle.destroy();
+    }
+
+    // False if the arena had no room for the frame
+    explicit operator bool() const { return static_cast<bool>(handle); }
+
+    void setBatch(int steps) {
+        if (handle) handle.promise().batch = std::clamp(steps, 1, MAX_BATCH);
+    }
+
+    // Run until the next batch of steps is ready; false once the algorithm has finished
+    // and every step has been handed out
+    bool next() {
+        if (!handle) return false;
+        promise_type& promise = handle.promise();
+        promise.count = 0;
+        promise.takePending();
+        if (promise.count < promise.batch && !handle.done()) handle.resume();
+        return promise.count > 0;
+    }
+
+    const Step* begin() const { return handle.promise().steps; }
+    const Step* end() const { return handle.promise().steps + handle.promise().count; }
+    int size() const { return handle.promise().count; }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit StepGenerator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+};
+
+// Generators. Each mirrors its plain loop in maze_generators.h, drawing the same random
+// numbers, so both produce the same maze from the same seed.
+
+inline StepGenerator backtrackerSteps(StepArena&, Grid& grid, std::mt19937& rng) {
+    std::vector<uint8_t> visited(grid.size(), 0);
+    std::vector<uint32_t> stack = {0};
+    visited[0] = 1;
+    while (!stack.empty()) {
+        uint32_t cell = stack.back();
+        Direction options[4];
+        uint32_t targets[4];
+        int count = 0;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.neighbor(cell, dir, next) && !visited[next]) {
+                options[count] = dir;
+                targets[count++] = next;
+            }
+        }
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+        int pick = static_cast<int>(rng() % count);
+        grid.carve(cell, options[pick]);
+        visited[targets[pick]] = 1;
+        stack.push_back(targets[pick]);
+        co_yield Step{LOG_CARVE, options[pick], cell};
+    }
+}
+
+inline StepGenerator kruskalSteps(StepArena&, Grid& grid, std::mt19937& rng) {
+    std::vector<uint32_t> walls;
+    walls.reserve(static_cast<size_t>(grid.size()) * 2);
+    for (int y = 0; y < grid.height; ++y) {
+        for (int x = 0; x < grid.width; ++x) {
+            uint32_t cell = grid.index(x, y);
+            if (x + 1 < grid.width) walls.push_back(cell * 2);
+            if (y + 1 < grid.height) walls.push_back(cell * 2 + 1);
+        }
+    }
+    std::shuffle(walls.begin(), walls.end(), rng);
+
+    UnionFind sets(grid.size());
+    for (uint32_t wall : walls) {
+        uint32_t cell = wall / 2;
+        Direction dir = (wall & 1) ? SOUTH : EAST;
+        uint32_t next = (wall & 1) ? cell + grid.width : cell + 1;
+        if (!sets.unite(cell, next)) continue;
+        grid.carve(cell, dir);
+        co_yield Step{LOG_CARVE, dir, cell};
+    }
+}
+
+inline StepGenerator primSteps(StepArena&, Grid& grid, std::mt19937& rng) {
+    std::vector<uint8_t> visited(grid.size(), 0);
+    std::vector<std::pair<uint32_t, Direction>> frontier;
+    auto addFrontier = [&](uint32_t cell) {
+        visited[cell] = 1;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.neighbor(cell, dir, next) && !visited[next]) frontier.push_back({cell, dir});
+        }
+    };
+
+    addFrontier(0);
+    while (!frontier.empty()) {
+        size_t pick = rng() % frontier.size();
+        auto [cell, dir] = frontier[pick];
+        frontier[pick] = frontier.back();
+        frontier.pop_back();
+
+        uint32_t next = 0;
+        grid.neighbor(cell, dir, next);
+        if (visited[next]) continue;
+        grid.carve(cell, dir);
+        addFrontier(next);
+        co_yield Step{LOG_CARVE, dir, cell};
+    }
+}
+
+// The stretches of a random walk that carve nothing, as runs of LOG_VISIT steps of up to
+// StepGenerator::MAX_BATCH moves. The grid does not change within a run, so handing it out
+// whole shows the same maze at every step as yielding move by move. Kept out of the
+// coroutine like packedRowCarves.
+
+// Aldous-Broder through cells already in the tree; true when it stopped before a move into
+// a new cell, with that move in dir and the cell in next
+inline bool walkInTree(const Grid& grid, const std::vector<uint8_t>& inTree, RandomDirections& directions, uint32_t& cell, std::vector<Step>& visits,
+                       Direction& dir, uint32_t& next) {
+    visits.clear();
+    while (visits.size() < StepGenerator::MAX_BATCH) {
+        dir = directions.next();
+        if (!grid.neighbor(cell, dir, next)) continue;
+        if (!inTree[next]) return true;
+        visits.push_back(Step{LOG_VISIT, dir, next});
+        cell = next;
+    }
+    return false;
+}
+
+// Wilson's walk from cell until it reaches the tree, recording the last exit from each cell
+inline void walkToTree(const Grid& grid, const std::vector<uint8_t>& inTree, std::vector<uint8_t>& exit, RandomDirections& directions, uint32_t& cell,
+                       std::vector<Step>& visits) {
+    visits.clear();
+    while (!inTree[cell] && visits.size() < StepGenerator::MAX_BATCH) {
+        Direction dir = directions.next();
+        uint32_t next = 0;
+        if (!grid.neighbor(cell, dir, next)) continue;
+        exit[cell] = dir;
+        cell = next;
+        visits.push_back(Step{LOG_VISIT, dir, cell});
+    }
+}
+
+// Aldous-Broder until at most stopAt cells are left outside the tree, then Wilson's
+// algorithm for the rest, as walkAldousBroder and finishWilson do. Every step of every
+// walk is shown, so the long unproductive stretches are visible; Wilson's walks are
+// shown before their loop-erased route is carved.
+inline StepGenerator randomWalkSteps(StepArena&, Grid& grid, std::mt19937& rng, uint32_t stopAt) {
+    std::vector<uint8_t> inTree(grid.size(), 0);
+    std::vector<Step> visits;
+    visits.reserve(StepGenerator::MAX_BATCH);
+    {
+        RandomDirections directions(rng);
+        uint32_t cell = rng() % grid.size();
+        inTree[cell] = 1;
+        for (uint32_t remaining = grid.size() - 1; remaining > stopAt;) {
+            Direction dir = NORTH;
+            uint32_t next = 0;
+            bool leaves = walkInTree(grid, inTree, directions, cell, visits, dir, next);
+            co_yield StepRun{visits.data(), visits.size()};
+            if (!leaves) continue;
+            grid.carve(cell, dir);
+            inTree[next] = 1;
+            --remaining;
+            co_yield Step{LOG_CARVE, dir, cell};
+            cell = next;
+        }
+    }
+
+    std::vector<uint8_t> exit(grid.size(), 0);
+    RandomDirections directions(rng);
+    for (uint32_t start = 0; start < grid.size(); ++start) {
+        uint32_t cell = start;
+        while (!inTree[cell]) {
+            walkToTree(grid, inTree, exit, directions, cell, visits);
+            co_yield StepRun{visits.data(), visits.size()};
+        }
+        for (cell = start; !inTree[cell];) {
+            Direction dir = static_cast<Direction>(exit[cell]);
+            inTree[cell] = 1;
+            grid.carve(cell, dir);
+            co_yield Step{LOG_CARVE, dir, cell};
+            grid.neighbor(cell, dir, cell);
+        }
+    }
+}
+
+inline StepGenerator aldousBroderSteps(StepArena& arena, Grid& grid, std::mt19937& rng) {
+    return randomWalkSteps(arena, grid, rng, 0);
+}
+
+inline StepGenerator wilsonSteps(StepArena& arena, Grid& grid, std::mt19937& rng) {
+    return randomWalkSteps(arena, grid, rng, grid.size() - 1);
+}
+
+inline StepGenerator hybridSteps(StepArena& arena, Grid& grid, std::mt19937& rng) {
+    return randomWalkSteps(arena, grid, rng, static_cast<uint32_t>(grid.size() * (1 - HYBRID_COVERAGE)));
+}
+
+// Eller's algorithm, one row at a time, from the streaming engine in eller_stream.h: the
+// joins along each row, then the passages it drops south
+inline StepGenerator ellerSteps(StepArena&, Grid& grid, std::mt19937& rng) {
+    EllerStream stream(grid.width, rng);
+    for (int y = 0; y < grid.height; ++y) {
+        const std::vector<uint8_t>& row = stream.nextRow(y + 1 == grid.height);
+        for (Direction dir : {EAST, SOUTH}) {
+            for (int x = 0; x < grid.width; ++x) {
+                if (!(row[x] & dir)) continue;
+                grid.carve(grid.index(x, y), dir);
+                co_yield Step{LOG_CARVE, dir, grid.index(x, y)};
+            }
+        }
+    }
+}
+
+// The carves of one packed row: the joins east, then the passages south. Kept out of the
+// coroutine so the scan runs on registers rather than frame slots.
+inline void packedRowCarves(const uint8_t* row, int width, bool lastRow, uint32_t base, std::vector<Step>& carves) {
+    carves.clear();
+    size_t bytes = packedRowBytes(width);
+    for (Direction dir : {EAST, SOUTH}) {
+        if (dir == SOUTH && lastRow) break;
+        uint8_t mask = dir == EAST ? 0x55 : 0xaa;
+        for (size_t i = 0; i < bytes; ++i) {
+            for (unsigned bits = row[i] & mask; bits; bits &= bits - 1) {
+                int x = static_cast<int>(i * 4) + __builtin_ctz(bits) / 2;
+                if (dir == EAST && x + 1 >= width) break;
+                carves.push_back(Step{LOG_CARVE, dir, base + static_cast<uint32_t>(x)});
+            }
+        }
+    }
+}
+
+// Binary tree and sidewinder from the packed row generator. Like the plain loop, each row
+// is unpacked into the grid at once and its carves are yielded as one run, so the grid can
+// be up to a row ahead of the steps.
+inline StepGenerator packedSteps(StepArena&, Grid& grid, std::mt19937& rng, PackedAlgorithm algorithm) {
+    uint64_t seed = rng();
+    seed = (seed << 32) | rng();
+    PackedRowGenerator generator(algorithm, seed, grid.width, grid.height);
+    std::vector<uint8_t> row(generator.rowBytes());
+    std::vector<Step> carves;
+    carves.reserve(2 * static_cast<size_t>(grid.width));
+    std::fill(grid.cells.begin(), grid.cells.end(), 0);
+    for (int y = 0; y < grid.height; ++y) {
+        generator.row(y, row.data());
+        unpackRow(grid, y, row.data());
+        packedRowCarves(row.data(), grid.width, y + 1 == grid.height, grid.index(0, y), carves);
+        co_yield StepRun{carves.data(), carves.size()};
+    }
+}
+
+inline StepGenerator binaryTreeSteps(StepArena& arena, Grid& grid, std::mt19937& rng) {
+    return packedSteps(arena, grid, rng, PACKED_BINARY_TREE);
+}
+
+inline StepGenerator sidewinderSteps(StepArena& arena, Grid& grid, std::mt19937& rng) {
+    return packedSteps(arena, grid, rng, PACKED_SIDEWINDER);
+}
+
+// Recursive division on one thread, as divideSerial: the passage through each cut, then
+// each single row or column opened along its length
+inline StepGenerator divisionSteps(StepArena&, Grid& grid, std::mt19937& rng) {
+    uint64_t seed = rng();
+    seed = (seed << 32) | rng();
+    std::vector<Chamber> stack = {{0, 0, grid.width, grid.height, seed}};
+    while (!stack.empty()) {
+        Chamber current = stack.back(), first, second;
+        stack.pop_back();
+        uint32_t door = 0;
+        if (divideChamber(grid, current, first, second, &door)) {
+            stack.push_back(second);
+            stack.push_back(first);
+            co_yield Step{LOG_CARVE, second.y != current.y ? SOUTH : EAST, door};
+            continue;
+        }
+        Direction dir = current.width == 1 ? SOUTH : EAST;
+        for (int i = 0; i + 1 < current.width * current.height; ++i) {
+            co_yield Step{LOG_CARVE, dir, grid.index(current.x + (dir == EAST ? i : 0), current.y + (dir == SOUTH ? i : 0))};
+        }
+    }
+}
+
+// Solvers, from the top-left to the bottom-right corner. Each one in SOLVERS mirrors its
+// plain version in maze_solvers.h and finds the same path. They yield LOG_VISIT as cells are expanded,
+// LOG_CLEAR when a walker backs out of one, and the final route as LOG_PATH steps.
+
+inline StepGenerator bfsSteps(StepArena&, Grid& grid, std::mt19937&) {
+    uint32_t goal = grid.size() - 1;
+    std::vector<uint8_t> parent(grid.size(), 0);
+    std::vector<uint32_t> queue = {0};
+    parent[0] = 0xFF;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t cell = queue[head];
+        co_yield Step{LOG_VISIT, NORTH, cell};
+        if (cell == goal) break;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next) && !parent[next]) {
+                parent[next] = opposite(dir);
+                queue.push_back(next);
+            }
+        }
+    }
+    if (!parent[goal]) co_return;
+    for (uint32_t cell = goal;; grid.neighbor(cell, static_cast<Direction>(parent[cell]), cell)) {
+        co_yield Step{LOG_PATH, NORTH, cell};
+        if (cell == 0) break;
+    }
+}
+
+// Depth-first search with an explicit stack, like the recursive solver in maze1.cpp
+inline StepGenerator dfsSteps(StepArena&, Grid& grid, std::mt19937&) {
+    uint32_t goal = grid.size() - 1;
+    std::vector<uint8_t> visited(grid.size(), 0);
+    std::vector<uint32_t> stack = {0};
+    std::vector<uint8_t> tried = {0}; // Directions already tried from each stack entry
+    visited[0] = 1;
+    co_yield Step{LOG_VISIT, NORTH, 0};
+    while (!stack.empty() && stack.back() != goal) {
+        uint32_t cell = stack.back();
+        bool advanced = false;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if ((tried.back() & dir) || !grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, next)) continue;
+            tried.back() |= dir;
+            if (visited[next]) continue;
+            visited[next] = 1;
+            stack.push_back(next);
+            tried.push_back(0);
+            advanced = true;
+            co_yield Step{LOG_VISIT, dir, next};
+            break;
+        }
+        if (!advanced) {
+            stack.pop_back();
+            tried.pop_back();
+            co_yield Step{LOG_CLEAR, NORTH, cell};
+        }
+    }
+    for (uint32_t cell : stack) co_yield Step{LOG_PATH, NORTH, cell};
+}
+
+inline StepGenerator aStarHeapSteps(StepArena&, Grid& grid, std::mt19937&) {
+    uint32_t goal = grid.size() - 1;
+    std::vector<uint32_t> gScore(grid.size(), UINT32_MAX);
+    std::vector<uint8_t> parent(grid.size(), 0);
+    std::vector<uint64_t> open;
+    auto heuristic = [&](uint32_t cell) {
+        Point p = grid.point(cell);
+        return static_cast<uint32_t>((grid.width - 1 - p.x) + (grid.height - 1 - p.y));
+    };
+    auto push = [&](uint32_t cell) {
+        open.push_back((static_cast<uint64_t>(gScore[cell] + heuristic(cell)) << 32) | cell);
+        std::push_heap(open.begin(), open.end(), std::greater<uint64_t>());
+    };
+
+    gScore[0] = 0;
+    push(0);
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), std::greater<uint64_t>());
+        uint64_t top = open.back();
+        open.pop_back();
+        uint32_t cell = static_cast<uint32_t>(top);
+        if ((top >> 32) != gScore[cell] + heuristic(cell)) continue;
+        co_yield Step{LOG_VISIT, NORTH, cell};
+        if (cell == goal) break;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next) && gScore[cell] + 1 < gScore[next]) {
+                gScore[next] = gScore[cell] + 1;
+                parent[next] = opposite(dir);
+                push(next);
+            }
+        }
+    }
+    if (gScore[goal] == UINT32_MAX) co_return;
+    for (uint32_t cell = goal;; grid.neighbor(cell, static_cast<Direction>(parent[cell]), cell)) {
+        co_yield Step{LOG_PATH, NORTH, cell};
+        if (cell == 0) break;
+    }
+}
+
+// Breadth-first search from both ends, a whole level at a time from the smaller frontier,
+// as solveBidirectionalBfs
+inline StepGenerator bidirectionalSteps(StepArena&, Grid& grid, std::mt19937&) {
+    uint32_t start = 0, goal = grid.size() - 1;
+    std::vector<uint8_t> side(grid.size(), 0);
+    std::vector<uint8_t> parent(grid.size(), 0);
+    std::vector<uint32_t> depth(grid.size(), 0);
+    std::vector<uint32_t> frontier[2] = {{start}, {goal}}, next;
+    side[start] = 1;
+    side[goal] = 2;
+    uint32_t best = UINT32_MAX, meetA = 0, meetB = 0;
+    while (best == UINT32_MAX && !frontier[0].empty() && !frontier[1].empty()) {
+        int s = frontier[0].size() <= frontier[1].size() ? 0 : 1;
+        uint8_t mine = static_cast<uint8_t>(s + 1);
+        next.clear();
+        for (uint32_t cell : frontier[s]) {
+            co_yield Step{LOG_VISIT, NORTH, cell};
+            for (Direction dir : DIRECTIONS) {
+                uint32_t to = 0;
+                if (!grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, to)) continue;
+                if (!side[to]) {
+                    side[to] = mine;
+                    parent[to] = opposite(dir);
+                    depth[to] = depth[cell] + 1;
+                    next.push_back(to);
+                } else if (side[to] != mine && depth[cell] + 1 + depth[to] < best) {
+                    best = depth[cell] + 1 + depth[to];
+                    meetA = s == 0 ? cell : to;
+                    meetB = s == 0 ? to : cell;
+                }
+            }
+        }
+        std::swap(frontier[s], next);
+    }
+    if (best == UINT32_MAX) co_return;
+    std::vector<uint32_t> path;
+    tracePath(grid, parent, start, meetA, path);
+    for (uint32_t cell = meetB;; grid.neighbor(cell, static_cast<Direction>(parent[cell]), cell)) {
+        path.push_back(cell);
+        if (cell == goal) break;
+    }
+    for (uint32_t cell : path) co_yield Step{LOG_PATH, NORTH, cell};
+}
+
+// A* over a bucket queue indexed by f, as solveAStarBuckets
+inline StepGenerator aStarBucketsSteps(StepArena&, Grid& grid, std::mt19937&) {
+    uint32_t start = 0, goal = grid.size() - 1;
+    std::vector<uint32_t> gScore(grid.size(), UINT32_MAX);
+    std::vector<uint8_t> parent(grid.size(), 0);
+    std::vector<std::vector<uint32_t>> buckets;
+    auto push = [&](uint32_t cell, uint32_t f) {
+        if (f >= buckets.size()) buckets.resize(f + 1);
+        buckets[f].push_back(cell);
+    };
+
+    gScore[start] = 0;
+    uint32_t f = manhattan(grid, start, goal);
+    push(start, f);
+    bool found = false;
+    for (; f < buckets.size() && !found; ++f) {
+        while (!buckets[f].empty()) {
+            uint32_t cell = buckets[f].back();
+            buckets[f].pop_back();
+            if (gScore[cell] + manhattan(grid, cell, goal) != f) continue;
+            co_yield Step{LOG_VISIT, NORTH, cell};
+            if (cell == goal) {
+                found = true;
+                break;
+            }
+            for (Direction dir : DIRECTIONS) {
+                uint32_t next = 0;
+                if (!grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, next)) continue;
+                if (gScore[cell] + 1 < gScore[next]) {
+                    gScore[next] = gScore[cell] + 1;
+                    parent[next] = opposite(dir);
+                    push(next, gScore[next] + manhattan(grid, next, goal));
+                }
+            }
+        }
+    }
+    if (!found) co_return;
+    std::vector<uint32_t> path;
+    tracePath(grid, parent, start, goal, path);
+    for (uint32_t cell : path) co_yield Step{LOG_PATH, NORTH, cell};
+}
+
+// Right-hand wall follower, as solveWallFollower. Each move is a LOG_VISIT; a move back
+// along the route clears the cell it leaves, so the marks always show the route so far.
+inline StepGenerator wallFollowerSteps(StepArena&, Grid& grid, std::mt19937&) {
+    const Direction CLOCKWISE[4] = {NORTH, EAST, SOUTH, WEST};
+    uint32_t start = 0, goal = grid.size() - 1;
+    std::vector<uint32_t> route = {start};
+    uint64_t limit = static_cast<uint64_t>(grid.size()) * 4 + 4, moves = 0;
+    uint32_t cell = start;
+    int facing = -1;
+    uint32_t outside = 0;
+    for (int f = 0; f < 4 && facing < 0; ++f) {
+        if (!grid.neighbor(start, CLOCKWISE[(f + 1) % 4], outside)) facing = f;
+    }
+    for (int f = 0; f < 4 && facing < 0; ++f) {
+        if (!grid.isOpen(start, CLOCKWISE[(f + 1) % 4])) facing = f;
+    }
+    facing = std::max(facing, 0);
+    co_yield Step{LOG_VISIT, NORTH, start};
+    while (cell != goal && moves < limit) {
+        int turn = 1;
+        for (; turn < 5; ++turn) {
+            int heading = (facing + 6 - turn) % 4;
+            uint32_t next = 0;
+            if (grid.isOpen(cell, CLOCKWISE[heading]) && grid.neighbor(cell, CLOCKWISE[heading], next)) {
+                facing = heading;
+                cell = next;
+                break;
+            }
+        }
+        if (turn == 5) break;
+        ++moves;
+        uint32_t left = route.back();
+        size_t length = route.size();
+        walkRoute(route, cell);
+        if (route.size() > length) co_yield Step{LOG_VISIT, CLOCKWISE[facing], cell};
+        else co_yield Step{LOG_CLEAR, CLOCKWISE[facing], left};
+    }
+    if (cell != goal) co_return;
+    for (uint32_t step : route) co_yield Step{LOG_PATH, NORTH, step};
+}
+
+// Trémaux's algorithm, as solveTremaux, shown like the wall follower
+inline StepGenerator tremauxSteps(StepArena&, Grid& grid, std::mt19937&) {
+    uint32_t start = 0, goal = grid.size() - 1;
+    std::vector<uint8_t> marks(grid.size(), 0);
+    auto markOf = [&](uint32_t cell, Direction dir) { return (marks[cell] >> (2 * directionIndex(dir))) & 3; };
+    std::vector<uint32_t> route = {start};
+    uint32_t cell = start;
+    int entry = -1;
+    co_yield Step{LOG_VISIT, NORTH, start};
+    while (cell != goal) {
+        int otherMarks = 0, choice = -1, choiceMark = 2;
+        for (int i = 0; i < 4; ++i) {
+            uint32_t next = 0;
+            if (i == entry || !grid.isOpen(cell, DIRECTIONS[i]) || !grid.neighbor(cell, DIRECTIONS[i], next)) continue;
+            int mark = markOf(cell, DIRECTIONS[i]);
+            otherMarks += mark;
+            if (mark < choiceMark) {
+                choice = i;
+                choiceMark = mark;
+            }
+        }
+        bool enteredFresh = entry >= 0 && markOf(cell, DIRECTIONS[entry]) == 1;
+        if (choice < 0 || (enteredFresh && otherMarks > 0)) choice = entry;
+        if (choice < 0 || markOf(cell, DIRECTIONS[choice]) >= 2) break;
+
+        Direction dir = DIRECTIONS[choice];
+        uint32_t next = 0;
+        grid.neighbor(cell, dir, next);
+        marks[cell] += static_cast<uint8_t>(1 << (2 * directionIndex(dir)));
+        marks[next] += static_cast<uint8_t>(1 << (2 * directionIndex(opposite(dir))));
+        size_t length = route.size();
+        walkRoute(route, next);
+        if (route.size() > length) co_yield Step{LOG_VISIT, dir, next};
+        else co_yield Step{LOG_CLEAR, dir, cell};
+        cell = next;
+        entry = directionIndex(opposite(dir));
+    }
+    if (cell != goal) co_return;
+    for (uint32_t step : route) co_yield Step{LOG_PATH, NORTH, step};
+}
+
+// Dead-end filling, as solveDeadEndFilling: each filled cell is a LOG_VISIT, then the
+// route through the cells left over
+inline StepGenerator deadEndFillSteps(StepArena&, Grid& grid, std::mt19937&) {
+    uint32_t start = 0, goal = grid.size() - 1;
+    std::vector<uint8_t> degree(grid.size());
+    std::vector<uint32_t> deadEnds;
+    for (uint32_t cell = 0; cell < grid.size(); ++cell) {
+        uint8_t count = 0;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next)) ++count;
+        }
+        degree[cell] = count;
+        if (count <= 1 && cell != start && cell != goal) deadEnds.push_back(cell);
+    }
+    while (!deadEnds.empty()) {
+        uint32_t cell = deadEnds.back();
+        deadEnds.pop_back();
+        degree[cell] = 0;
+        co_yield Step{LOG_VISIT, NORTH, cell};
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (!grid.isOpen(cell, dir) || !grid.neighbor(cell, dir, next) || !degree[next]) continue;
+            if (--degree[next] == 1 && next != start && next != goal) deadEnds.push_back(next);
+        }
+    }
+
+    std::vector<uint8_t> parent(grid.size(), 0);
+    std::vector<uint32_t> queue = {start};
+    parent[start] = 0xFF;
+    bool found = false;
+    for (size_t head = 0; head < queue.size() && !found; ++head) {
+        uint32_t cell = queue[head];
+        found = cell == goal;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.isOpen(cell, dir) && grid.neighbor(cell, dir, next) && degree[next] && !parent[next]) {
+                parent[next] = opposite(dir);
+                queue.push_back(next);
+            }
+        }
+    }
+    if (!found) co_return;
+    std::vector<uint32_t> path;
+    tracePath(grid, parent, start, goal, path);
+    for (uint32_t cell : path) co_yield Step{LOG_PATH, NORTH, cell};
+}
+
+struct StepAlgorithm {
+    const char* name;
+    bool generator; // Carves an all-walls grid; otherwise solves a finished maze
+    StepGenerator (*start)(StepArena& arena, Grid& grid, std::mt19937& rng);
+};
+
+// Every generator in GENERATORS and every solver in SOLVERS, under the same names, plus
+// the depth-first solver of maze1 and maze2
+const StepAlgorithm STEP_ALGORITHMS[] = {
+    {"backtracker", true, backtrackerSteps},
+    {"kruskal", true, kruskalSteps},
+    {"prim", true, primSteps},
+    {"aldous-broder", true, aldousBroderSteps},
+    {"wilson", true, wilsonSteps},
+    {"hybrid", true, hybridSteps},
+    {"eller", true, ellerSteps},
+    {"binary-tree", true, binaryTreeSteps},
+    {"sidewinder", true, sidewinderSteps},
+    {"division", true, divisionSteps},
+    {"bfs", false, bfsSteps},
+    {"bidirectional", false, bidirectionalSteps},
+    {"astar-heap", false, aStarHeapSteps},
+    {"astar-buckets", false, aStarBucketsSteps},
+    {"wall-follower", false, wallFollowerSteps},
+    {"tremaux", false, tremauxSteps},
+    {"dead-end-fill", false, deadEndFillSteps},
+    {"dfs", false, dfsSteps},
+};
+
+inline const StepAlgorithm* findStepAlgorithm(const std::string& name) {
+    for (const StepAlgorithm& algorithm : STEP_ALGORITHMS) {
+        if (name == algorithm.name) return &algorithm;
+    }
+    return nullptr;
+}
+
+#endif
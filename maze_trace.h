@@ -0,0 +1,158 @@
+#ifndef MAZE_TRACE_H
+#define MAZE_TRACE_H
+
+// Chrome/Perfetto trace-event export.
+//
+// Compile with -DMAZE_TRACE and call MAZE_TRACE_START("trace.json") to record. Spans are
+// appended to a buffer owned by the calling thread, so recording takes no locks; each
+// buffer is linked into a global list once, with a compare-and-swap. MAZE_TRACE_STOP()
+// writes every buffer as trace-event JSON, after the worker threads have been joined.
+//
+//   MAZE_TRACE_SCOPE("solve");           span covering the rest of the enclosing scope
+//   MAZE_TRACE_THREAD("generator");      name the calling thread in the viewer
+
+#ifdef MAZE_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct TraceSpan {
+    const char* name; // Must be a string literal
+    int64_t startUs;
+    int64_t durationUs;
+};
+
+struct TraceBuffer {
+    std::vector<TraceSpan> spans;
+    std::string threadName;
+    int tid = 0;
+    TraceBuffer* next = nullptr;
+};
+
+class Tracer {
+public:
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    void start(const std::string& path) {
+        outputPath = path;
+        epoch = std::chrono::steady_clock::now();
+        enabled.store(true, std::memory_order_release);
+    }
+
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    int64_t nowUs() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    void record(const char* name, int64_t startUs, int64_t durationUs) {
+        threadBuffer().spans.push_back({name, startUs, durationUs});
+    }
+
+    void nameThread(const char* name) {
+        if (isEnabled()) threadBuffer().threadName = name;
+    }
+
+    // Write all buffers and stop recording; call once every traced thread has finished
+    bool stop() {
+        if (!enabled.exchange(false)) return true;
+        std::FILE* out = std::fopen(outputPath.c_str(), "w");
+        if (!out) return false;
+        std::fprintf(out, "{\"traceEvents\":[\n");
+        bool first = true;
+        for (TraceBuffer* buffer = head.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+            if (!buffer->threadName.empty()) {
+                std::fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                             first ? "" : ",\n", buffer->tid, buffer->threadName.c_str());
+                first = false;
+            }
+            for (const TraceSpan& span : buffer->spans) {
+                std::fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%lld,\"dur\":%lld}",
+                             first ? "" : ",\n", span.name, buffer->tid, static_cast<long long>(span.startUs),
+                             static_cast<long long>(span.durationUs));
+                first = false;
+            }
+        }
+        std::fprintf(out, "\n],\"displayTimeUnit\":\"ms\"}\n");
+        std::fclose(out);
+        return true;
+    }
+
+private:
+    std::atomic<bool> enabled{false};
+    std::atomic<TraceBuffer*> head{nullptr};
+    std::atomic<int> nextTid{1};
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::string outputPath;
+
+    // Buffers are never freed: they must outlive their threads until the trace is written
+    TraceBuffer& threadBuffer() {
+        thread_local TraceBuffer* buffer = nullptr;
+        if (!buffer) {
+            buffer = new TraceBuffer();
+            buffer->tid = nextTid.fetch_add(1, std::memory_order_relaxed);
+            buffer->spans.reserve(1 << 12);
+            buffer->next = head.load(std::memory_order_relaxed);
+            while (!head.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+        return *buffer;
+    }
+};
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name(name), startUs(Tracer::instance().isEnabled() ? Tracer::instance().nowUs() : -1) {}
+    ~TraceScope() {
+        if (startUs >= 0) Tracer::instance().record(name, startUs, Tracer::instance().nowUs() - startUs);
+    }
+
+private:
+    const char* name;
+    int64_t startUs;
+};
+
+#define MAZE_TRACE_CONCAT_(a, b) a##b
+#define MAZE_TRACE_CONCAT(a, b) MAZE_TRACE_CONCAT_(a, b)
+#define MAZE_TRACE_START(path) Tracer::instance().start(path)
+#define MAZE_TRACE_STOP() Tracer::instance().stop()
+#define MAZE_TRACE_SCOPE(name) TraceScope MAZE_TRACE_CONCAT(traceScope, __LINE__)(name)
+#define MAZE_TRACE_THREAD(name) Tracer::instance().nameThread(name)
+
+#else
+
+#define MAZE_TRACE_START(path) ((void)0)
+#define MAZE_TRACE_STOP() ((void)0)
+#define MAZE_TRACE_SCOPE(name) ((void)0)
+#define MAZE_TRACE_THREAD(name) ((void)0)
+
+#endif
+
+#include <cstring>
+#include <iostream>
+
+// For programs that read their arguments by position: removes "--trace path" from argv and
+// starts recording to path (or says tracing is not compiled in)
+inline void startTraceFromArgs(int& argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--trace") != 0) continue;
+#ifdef MAZE_TRACE
+        MAZE_TRACE_START(argv[i + 1]);
+        MAZE_TRACE_THREAD("main");
+#else
+        std::cerr << "Tracing is not compiled in; rebuild with -DMAZE_TRACE" << std::endl;
+#endif
+        for (int j = i + 2; j <= argc; ++j) argv[j - 2] = argv[j];
+        argc -= 2;
+        return;
+    }
+}
+
+#endif
@@ -0,0 +1,317 @@
+#ifndef MAZE_VERIFIER_H
+#define MAZE_VERIFIER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "maze_grid.h"
+
+// Streaming check that a maze is perfect (a spanning tree of the grid): connected,
+// acyclic, every wall bit matching its neighbour's, and nothing open through the border.
+//
+// Rows are consumed top to bottom the way Eller's algorithm produces them. Only the
+// component label of each cell in the previous row is kept, so memory is O(width):
+// each row builds a small union-find over the previous row's labels plus its own
+// horizontal runs. A vertical passage joining two parts that already share a root closes
+// a cycle; a label from the previous row that reaches no run of the new row is a
+// finished component. Per-cell work is branch-free; only vertical passages touch the
+// union-find.
+struct VerifyReport {
+    uint64_t cells = 0;
+    uint64_t passages = 0;
+    uint64_t components = 0;
+    uint64_t cycles = 0;
+    uint64_t asymmetric = 0; // Wall bits that disagree between two neighbours
+    uint64_t border = 0;     // Passages leading out of the grid
+
+    bool perfect() const { return components == 1 && cycles == 0 && asymmetric == 0 && border == 0; }
+};
+
+// What a horizontal band of rows looks like from outside, for BandMerger. Components are
+// identified by "anchors": the components of the band's first row, tracked down the band.
+// Ids below width are anchor sets; width + label is an unanchored bottom-row component.
+struct BandSummary {
+    VerifyReport report;               // Finished components here are the unanchored ones
+    std::vector<uint8_t> topRow, bottomRow;
+    std::vector<uint32_t> topComponent;
+    std::vector<uint32_t> bottomComponent;
+};
+
+class StreamingVerifier {
+public:
+    static constexpr uint32_t NO_ANCHOR = UINT32_MAX;
+
+    // A band verifier sees a slice of the maze: its first row is not the top border, and
+    // it tracks which of its components touch that first row
+    explicit StreamingVerifier(int width, bool band = false)
+        : width(width), band(band), labels(width, 0), previous(width, 0), runOf(width), runLabel(width), verticals(width),
+          parent(2 * static_cast<size_t>(width)), remap(2 * static_cast<size_t>(width)), reached(2 * static_cast<size_t>(width)),
+          anchorOf(band ? width : 0, NO_ANCHOR), anchorParent(band ? width : 0), rootAnchor(band ? 2 * static_cast<size_t>(width) : 0) {}
+
+    // Next row of per-cell passage bits (N=1 S=2 E=4 W=8)
+    void addRow(const uint8_t* cells) {
+        uint32_t w = static_cast<uint32_t>(width);
+        report.cells += w;
+        report.border += (cells[0] >> 3) & 1;      // West out of the first cell
+        report.border += (cells[w - 1] >> 2) & 1;  // East out of the last cell
+
+        // Horizontal passages split the row into runs. A run is a path, so it has no cycle
+        // of its own; everything below works per run or per vertical passage, not per cell.
+        // Locals rather than members in the hot loops: the compiler must assume a store
+        // through a uint8_t pointer may alias them
+        uint32_t* runs = runOf.data();
+        uint32_t* vertical = verticals.data();
+        const uint8_t* above = previous.data();
+        uint64_t asymmetric = 0;
+        uint32_t runCount = 1, verticalCount = 0;
+        runs[0] = 0;
+        for (uint32_t x = 1; x < w; ++x) {
+            uint32_t right = (cells[x - 1] >> 2) & 1, left = (cells[x] >> 3) & 1;
+            asymmetric += right ^ left;
+            runCount += 1 - (right & left);
+            runs[x] = runCount - 1;
+        }
+        report.passages += w - runCount;
+        if (rows == 0) {
+            if (!band) {
+                for (uint32_t x = 0; x < w; ++x) report.border += cells[x] & 1;
+            }
+        } else {
+            for (uint32_t x = 0; x < w; ++x) {
+                uint32_t down = (above[x] >> 1) & 1, up = cells[x] & 1;
+                asymmetric += down ^ up;
+                vertical[verticalCount] = x;
+                verticalCount += down & up;
+            }
+        }
+        report.asymmetric += asymmetric;
+
+        // Slots 0..labelCount-1 are the previous row's labels, w.. are this row's runs
+        for (uint32_t i = 0; i < labelCount; ++i) parent[i] = i;
+        for (uint32_t r = 0; r < runCount; ++r) parent[w + r] = w + r;
+        for (uint32_t i = 0; i < verticalCount; ++i) join(labels[vertical[i]], w + runs[vertical[i]]);
+
+        // A previous-row component reaching no run of this row cannot grow any more. It
+        // cannot have merged with another one either, since that needs a run of this row.
+        std::fill(reached.begin(), reached.begin() + labelCount, 0);
+        std::fill(reached.begin() + w, reached.begin() + w + runCount, 0);
+        for (uint32_t r = 0; r < runCount; ++r) reached[find(w + r)] = 1;
+        if (band) {
+            carryAnchors(runCount);
+        } else {
+            for (uint32_t label = 0; label < labelCount; ++label) report.components += 1 - reached[find(label)];
+        }
+
+        // Relabel this row densely so labels stay below width
+        std::fill(remap.begin(), remap.begin() + labelCount, UINT32_MAX);
+        std::fill(remap.begin() + w, remap.begin() + w + runCount, UINT32_MAX);
+        labelCount = 0;
+        for (uint32_t r = 0; r < runCount; ++r) {
+            uint32_t root = find(w + r);
+            if (remap[root] == UINT32_MAX) remap[root] = labelCount++;
+            runLabel[r] = remap[root];
+        }
+        uint32_t* label = labels.data();
+        const uint32_t* runToLabel = runLabel.data();
+        for (uint32_t x = 0; x < w; ++x) label[x] = runToLabel[runs[x]];
+
+        if (band && rows == 0) {
+            top.assign(cells, cells + w);
+            topLabels.assign(label, label + w);
+            for (uint32_t l = 0; l < labelCount; ++l) anchorOf[l] = anchorParent[l] = l; // Every first-row component is an anchor
+        } else if (band) {
+            for (uint32_t r = 0; r < runCount; ++r) anchorOf[runLabel[r]] = rootAnchor[find(w + r)];
+        }
+        std::copy(cells, cells + w, previous.begin());
+        rows++;
+    }
+
+    // For band verifiers, instead of finish(): the band's counts plus its boundary rows
+    BandSummary summarize() {
+        BandSummary summary;
+        summary.report = report;
+        summary.topRow = top;
+        summary.bottomRow = previous;
+        uint32_t w = static_cast<uint32_t>(width);
+        summary.topComponent.resize(w);
+        summary.bottomComponent.resize(w);
+        for (uint32_t x = 0; x < w; ++x) summary.topComponent[x] = findAnchor(topLabels[x]);
+        for (uint32_t x = 0; x < w; ++x) {
+            uint32_t anchor = anchorOf[labels[x]];
+            summary.bottomComponent[x] = anchor == NO_ANCHOR ? w + labels[x] : findAnchor(anchor);
+        }
+        return summary;
+    }
+
+    // Call once after the last row
+    VerifyReport finish() {
+        VerifyReport result = report;
+        if (rows > 0) {
+            uint32_t w = static_cast<uint32_t>(width);
+            for (uint32_t x = 0; x < w; ++x) {
+                if (previous[x] & SOUTH) result.border++;
+            }
+            result.components += labelCount;
+        }
+        return result;
+    }
+
+private:
+    int width;
+    bool band;
+    uint64_t rows = 0;
+    std::vector<uint32_t> labels;   // Component label of each cell in the previous row
+    std::vector<uint8_t> previous;  // Passage bits of the previous row
+    std::vector<uint32_t> runOf;    // Run index of each cell in the current row
+    std::vector<uint32_t> runLabel;
+    std::vector<uint32_t> verticals; // Columns with a passage up into the previous row
+    std::vector<uint32_t> parent;   // Union-find over 2 * width slots, rebuilt every row
+    std::vector<uint32_t> remap;    // Root to dense label for the current row
+    std::vector<uint8_t> reached;   // Roots that contain a run of the current row
+    uint32_t labelCount = 0;        // Distinct labels in the previous row
+    VerifyReport report;
+
+    // Band mode only
+    std::vector<uint8_t> top;            // The band's first row
+    std::vector<uint32_t> topLabels;     // Labels of the first row, which double as anchor ids
+    std::vector<uint32_t> anchorOf;      // Anchor set of each previous-row label, or NO_ANCHOR
+    std::vector<uint32_t> anchorParent;  // Union-find over anchors, kept for the whole band
+    std::vector<uint32_t> rootAnchor;    // Anchor of each union-find root in the current row
+
+    uint32_t findAnchor(uint32_t a) {
+        while (anchorParent[a] != a) {
+            anchorParent[a] = anchorParent[anchorParent[a]];
+            a = anchorParent[a];
+        }
+        return a;
+    }
+
+    // Merge anchor sets of previous-row components joined through this row. Unanchored
+    // components that stop here are finished; anchored ones may still connect upwards.
+    void carryAnchors(uint32_t runCount) {
+        uint32_t w = static_cast<uint32_t>(width);
+        std::fill(rootAnchor.begin(), rootAnchor.begin() + labelCount, NO_ANCHOR);
+        std::fill(rootAnchor.begin() + w, rootAnchor.begin() + w + runCount, NO_ANCHOR);
+        for (uint32_t label = 0; label < labelCount; ++label) {
+            uint32_t root = find(label);
+            if (anchorOf[label] == NO_ANCHOR) {
+                report.components += 1 - reached[root];
+                continue;
+            }
+            uint32_t anchor = findAnchor(anchorOf[label]);
+            if (rootAnchor[root] == NO_ANCHOR) rootAnchor[root] = anchor;
+            else if (rootAnchor[root] != anchor) anchorParent[anchor] = rootAnchor[root];
+        }
+    }
+
+    uint32_t find(uint32_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    // Count the passage; a passage inside one component closes a cycle
+    void join(uint32_t a, uint32_t b) {
+        report.passages++;
+        a = find(a);
+        b = find(b);
+        if (a == b) report.cycles++;
+        else if (a < b) parent[b] = a; // Older slots become roots, which keeps the trees flat
+        else parent[a] = b;
+    }
+};
+
+// Joins band summaries, in order from the top, into the report for the whole maze. The
+// seam between two bands is checked here, as if it were one more row boundary.
+class BandMerger {
+public:
+    explicit BandMerger(int width) : width(width) {}
+
+    void add(const BandSummary& next) {
+        uint32_t w = static_cast<uint32_t>(width);
+        total.cells += next.report.cells;
+        total.passages += next.report.passages;
+        total.components += next.report.components;
+        total.cycles += next.report.cycles;
+        total.asymmetric += next.report.asymmetric;
+        total.border += next.report.border;
+
+        // Slots 0..k-1 are the components open at the bottom so far, k.. the band's ids
+        uint32_t k = openCount;
+        parent.resize(k + 2 * w);
+        for (uint32_t i = 0; i < parent.size(); ++i) parent[i] = i;
+        if (started) {
+            for (uint32_t x = 0; x < w; ++x) {
+                bool down = bottomRow[x] & SOUTH, up = next.topRow[x] & NORTH;
+                if (down != up) total.asymmetric++;
+                if (down && up) {
+                    total.passages++;
+                    uint32_t a = find(open[x]), b = find(k + next.topComponent[x]);
+                    if (a == b) total.cycles++;
+                    else parent[std::max(a, b)] = std::min(a, b);
+                }
+            }
+        } else {
+            for (uint32_t x = 0; x < w; ++x) total.border += next.topRow[x] & NORTH;
+        }
+
+        // Anything not connected to the band's bottom row is finished
+        std::vector<uint8_t> live(parent.size(), 0), counted(parent.size(), 0);
+        for (uint32_t x = 0; x < w; ++x) live[find(k + next.bottomComponent[x])] = 1;
+        auto retire = [&](uint32_t slot) {
+            uint32_t root = find(slot);
+            if (!live[root] && !counted[root]) {
+                counted[root] = 1;
+                total.components++;
+            }
+        };
+        for (uint32_t i = 0; i < k; ++i) retire(i);
+        for (uint32_t x = 0; x < w; ++x) retire(k + next.topComponent[x]);
+
+        std::vector<uint32_t> remap(parent.size(), UINT32_MAX);
+        open.resize(w);
+        openCount = 0;
+        for (uint32_t x = 0; x < w; ++x) {
+            uint32_t root = find(k + next.bottomComponent[x]);
+            if (remap[root] == UINT32_MAX) remap[root] = openCount++;
+            open[x] = remap[root];
+        }
+        bottomRow = next.bottomRow;
+        started = true;
+    }
+
+    VerifyReport finish() {
+        VerifyReport result = total;
+        result.components += openCount;
+        for (uint8_t cell : bottomRow) result.border += (cell & SOUTH) ? 1 : 0;
+        return result;
+    }
+
+private:
+    int width;
+    bool started = false;
+    VerifyReport total;
+    std::vector<uint8_t> bottomRow;
+    std::vector<uint32_t> open; // Dense component id of each cell in the bottom row so far
+    uint32_t openCount = 0;
+    std::vector<uint32_t> parent;
+
+    uint32_t find(uint32_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+};
+
+// Verify an in-memory grid through the same streaming path
+inline VerifyReport verifyGrid(const Grid& grid) {
+    StreamingVerifier verifier(grid.width);
+    for (int y = 0; y < grid.height; ++y) verifier.addRow(grid.cells.data() + grid.index(0, y));
+    return verifier.finish();
+}
+
+#endif
@@ -0,0 +1,224 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+#include "maze_generators.h"
+#include "maze_io.h"
+#include "maze_verifier.h"
+
+// Checks that maze files (or every registered generator) produce perfect mazes.
+//   maze_verify <file> [--threads n]                          stream-verify a maze file
+//   maze_verify --generators [size] [seeds]                   regression check of all generators
+//   maze_verify --write <algorithm> <seed> <w> <h> <file> [--bits 2|4]
+const int DEFAULT_CHECK_SIZE = 64;
+const int DEFAULT_CHECK_SEEDS = 20;
+const int BANDS_PER_THREAD = 4;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void printReport(const VerifyReport& report) {
+    std::cout << report.cells << " cells, " << report.passages << " passages, " << report.components << " components, " << report.cycles
+              << " cycles, " << report.asymmetric << " asymmetric walls, " << report.border << " border openings: "
+              << (report.perfect() ? "perfect" : "NOT perfect") << std::endl;
+}
+
+// Verify rows [first, last) of a file as one band
+bool verifyBand(const std::string& path, int first, int last, BandSummary& summary) {
+    MazeFileReader reader;
+    if (!reader.open(path) || !reader.seekRow(first)) return false;
+    StreamingVerifier verifier(reader.width(), true);
+    std::vector<uint8_t> row;
+    for (int y = first; y < last; ++y) {
+        if (!reader.readRow(row)) return false;
+        verifier.addRow(row.data());
+    }
+    summary = verifier.summarize();
+    return true;
+}
+
+int verifyFile(const std::string& path, int threads) {
+    MazeFileReader reader;
+    if (!reader.open(path)) {
+        std::cerr << "Failed to read maze file: " << path << std::endl;
+        return 2;
+    }
+    auto start = std::chrono::steady_clock::now();
+    VerifyReport report;
+    bool complete = true;
+    if (threads <= 1) {
+        StreamingVerifier verifier(reader.width());
+        std::vector<uint8_t> row;
+        for (int y = 0; y < reader.height() && complete; ++y) {
+            complete = reader.readRow(row);
+            if (complete) verifier.addRow(row.data());
+        }
+        report = verifier.finish();
+    } else {
+        // Bands of rows on worker threads, each with its own reader; the seams are
+        // checked while the summaries are merged in order
+        int bands = std::min(reader.height(), threads * BANDS_PER_THREAD);
+        std::vector<BandSummary> summaries(bands);
+        std::vector<uint8_t> ok(bands, 0);
+        std::atomic<int> nextBand(0);
+        auto work = [&] {
+            for (int b; (b = nextBand++) < bands;) {
+                int first = static_cast<int>(static_cast<int64_t>(reader.height()) * b / bands);
+                int last = static_cast<int>(static_cast<int64_t>(reader.height()) * (b + 1) / bands);
+                ok[b] = verifyBand(path, first, last, summaries[b]);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; ++t) pool.emplace_back(work);
+        for (auto& thread : pool) thread.join();
+
+        BandMerger merger(reader.width());
+        for (int b = 0; b < bands; ++b) {
+            complete = complete && ok[b];
+            if (complete) merger.add(summaries[b]);
+        }
+        report = merger.finish();
+    }
+    if (!complete) {
+        std::cerr << "Truncated maze file: " << path << std::endl;
+        return 2;
+    }
+    double seconds = secondsSince(start);
+
+    double megabytes = (MAZE_FILE_HEADER + mazeRowBytes(reader.width(), reader.bitsPerCell()) * reader.height()) / (1024.0 * 1024.0);
+    std::cout << reader.width() << "x" << reader.height() << " (" << reader.bitsPerCell() << " bits per cell) in " << seconds << " s, "
+              << megabytes / seconds << " MB/s, " << report.cells / seconds / 1e6 << " Mcells/s" << std::endl;
+    printReport(report);
+    return report.perfect() ? 0 : 1;
+}
+
+VerifyReport verifyGridBands(const Grid& grid, int bandRows) {
+    BandMerger merger(grid.width);
+    for (int first = 0; first < grid.height; first += bandRows) {
+        StreamingVerifier verifier(grid.width, true);
+        for (int y = first; y < std::min(first + bandRows, grid.height); ++y) verifier.addRow(grid.cells.data() + grid.index(0, y));
+        merger.add(verifier.summarize());
+    }
+    return merger.finish();
+}
+
+int writeFile(const std::string& algorithm, uint64_t seed, int width, int height, const std::string& path, int bits) {
+    const GeneratorInfo* generator = findGenerator(algorithm);
+    if (!generator) {
+        std::cerr << "Unknown algorithm: " << algorithm << std::endl;
+        return 2;
+    }
+    Grid grid = buildMaze(*generator, seed, width, height);
+    MazeFileWriter writer;
+    if (!writer.open(path, width, height, bits) || !writer.writeGrid(grid) || !writer.close()) {
+        std::cerr << "Failed to write maze file: " << path << std::endl;
+        return 2;
+    }
+    return 0;
+}
+
+// Every generator over a range of seeds and shapes, a round trip through both file
+// formats, and damaged mazes that the verifier has to reject
+int checkGenerators(int size, int seeds) {
+    int failures = 0;
+    auto expect = [&](bool ok, const std::string& what) {
+        if (!ok) {
+            std::cout << "FAIL " << what << std::endl;
+            ++failures;
+        }
+    };
+    const int shapes[][2] = {{size, size}, {1, size}, {size, 1}, {size + 3, size / 2 + 1}};
+
+    for (const GeneratorInfo& generator : GENERATORS) {
+        auto start = std::chrono::steady_clock::now();
+        for (int seed = 1; seed <= seeds; ++seed) {
+            for (const auto& shape : shapes) {
+                Grid grid = buildMaze(generator, seed, shape[0], shape[1]);
+                VerifyReport report = verifyGrid(grid);
+                expect(report.perfect() && report.passages + 1 == report.cells,
+                       std::string(generator.name) + " seed " + std::to_string(seed) + " " + std::to_string(shape[0]) + "x" + std::to_string(shape[1]));
+            }
+        }
+        std::cout << generator.name << ": " << seeds * 4 << " mazes checked in " << secondsSince(start) * 1000 << " ms" << std::endl;
+    }
+
+    Grid grid = buildMaze(GENERATORS[0], 7, size, size);
+    std::string path = "maze_verify_check.tmp";
+
+    // Band merging must agree with a single pass, on good and damaged mazes alike
+    Grid cut = grid;
+    std::mt19937 damage(5);
+    for (int i = 0; i < size; ++i) cut.fill(damage() % cut.size(), DIRECTIONS[damage() % 4]);
+    braidMaze(cut, damage, 0.2);
+    cut.cells[cut.index(3, 3)] ^= SOUTH;
+    for (const Grid* g : {&grid, &cut}) {
+        VerifyReport single = verifyGrid(*g);
+        for (int bandRows : {1, 2, 5, size / 3}) {
+            VerifyReport banded = verifyGridBands(*g, bandRows);
+            expect(banded.cells == single.cells && banded.passages == single.passages && banded.components == single.components &&
+                       banded.cycles == single.cycles && banded.asymmetric == single.asymmetric && banded.border == single.border,
+                   "bands of " + std::to_string(bandRows) + " rows match a single pass");
+        }
+    }
+    for (int bits : {2, 4}) {
+        MazeFileWriter writer;
+        bool written = writer.open(path, grid.width, grid.height, bits) && writer.writeGrid(grid) && writer.close();
+        MazeFileReader reader;
+        bool same = written && reader.open(path) && reader.width() == grid.width && reader.height() == grid.height;
+        std::vector<uint8_t> row;
+        for (int y = 0; same && y < grid.height; ++y) {
+            same = reader.readRow(row) && std::equal(row.begin(), row.end(), grid.cells.begin() + grid.index(0, y));
+        }
+        expect(same, std::to_string(bits) + "-bit file round trip");
+    }
+    std::remove(path.c_str());
+
+    Grid damaged = grid;
+    damaged.fill(grid.index(size / 2, size / 2), EAST);
+    damaged.fill(grid.index(size / 2, size / 2), SOUTH);
+    damaged.fill(grid.index(size / 2, size / 2), NORTH);
+    damaged.fill(grid.index(size / 2, size / 2), WEST);
+    expect(verifyGrid(damaged).components > 1, "walled-in cell is reported as a separate component");
+
+    Grid looped = grid;
+    std::mt19937 rng(1);
+    braidMaze(looped, rng, 1.0);
+    expect(verifyGrid(looped).cycles > 0, "braided maze is reported as having cycles");
+
+    Grid asymmetric = grid;
+    asymmetric.cells[grid.index(1, 1)] ^= EAST;
+    expect(verifyGrid(asymmetric).asymmetric > 0, "one-sided wall bit is reported");
+
+    Grid leaking = grid;
+    leaking.cells[grid.index(size - 1, 0)] |= EAST;
+    expect(verifyGrid(leaking).border > 0, "opening through the border is reported");
+
+    std::cout << (failures ? "FAILED: " + std::to_string(failures) + " checks" : std::string("all checks passed")) << std::endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string first = argc > 1 ? argv[1] : "";
+    if (first == "--generators") {
+        int size = argc > 2 ? std::stoi(argv[2]) : DEFAULT_CHECK_SIZE;
+        int seeds = argc > 3 ? std::stoi(argv[3]) : DEFAULT_CHECK_SEEDS;
+        return checkGenerators(std::max(4, size), std::max(1, seeds));
+    }
+    if (first == "--write" && argc >= 7) {
+        int bits = (argc >= 9 && std::string(argv[7]) == "--bits") ? std::stoi(argv[8]) : 2;
+        return writeFile(argv[2], std::stoull(argv[3]), std::stoi(argv[4]), std::stoi(argv[5]), argv[6], bits);
+    }
+    if (!first.empty() && first[0] != '-') {
+        int threads = (argc >= 4 && std::string(argv[2]) == "--threads") ? std::stoi(argv[3]) : 1;
+        return verifyFile(first, threads);
+    }
+
+    std::cerr << "Usage: maze_verify <file> [--threads n]\n"
+              << "       maze_verify --generators [size] [seeds]\n"
+              << "       maze_verify --write <algorithm> <seed> <width> <height> <file> [--bits 2|4]" << std::endl;
+    return 2;
+}
@@ -0,0 +1,147 @@
+#ifndef PACKED_GENERATORS_H
+#define PACKED_GENERATORS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include "maze_grid.h"
+#include "maze_trace.h"
+
+// Binary tree and sidewinder written straight into the packed 2-bit rows of maze_grid.h.
+//
+// Both make every decision from random bits local to one row, so any row can be generated
+// on its own: the random bits of row y come from a counter (mixBits of the seed, the row
+// and the word), not from a shared generator. Rows are done 64 cells at a time in a pair
+// of bit planes, one bit per cell for "east open" and one for "south open", which are then
+// interleaved into the packed layout. The result depends only on the seed, never on the
+// thread count or on which rows a thread gets.
+//
+//   binary tree: every cell opens east or south on one random bit; the last column always
+//                goes south and the last row always east.
+//   sidewinder:  a random bit per cell decides whether the run of cells continues east.
+//                Each run drops one passage south, at the first cell of the run that wins
+//                a second coin flip, or at its last cell if none does. Finding that cell
+//                for every run in a word at once is one subtraction: borrowing from each
+//                run's first cell stops at the first candidate, and a borrow out of the
+//                top of a word carries an unfinished run into the next word. (The classic
+//                algorithm picks a uniformly random cell of the run; on the short runs a
+//                fair coin gives, the difference is small.) The last row is one long run.
+//
+// Packed rows are written as 64-bit words, so this assumes a little-endian machine.
+enum PackedAlgorithm { PACKED_BINARY_TREE, PACKED_SIDEWINDER };
+
+const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+
+// Spreads the low 32 bits of x to the even bit positions
+inline uint64_t spreadBits(uint64_t x) {
+    x &= 0xFFFFFFFFull;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+}
+
+class PackedRowGenerator {
+public:
+    PackedRowGenerator(PackedAlgorithm algorithm, uint64_t seed, int width, int height)
+        : algorithm(algorithm), seed(seed), width(width), height(height), words((width + 63) / 64), packed(words * 2) {}
+
+    size_t rowBytes() const { return packedRowBytes(width); }
+
+    // Writes packed row y to out (rowBytes() bytes)
+    void row(int y, uint8_t* out) {
+        uint64_t key = mixBits(seed ^ mixBits(static_cast<uint64_t>(y)));
+        bool lastRow = y + 1 == height;
+        uint64_t borrow = 0, previousEnds = 1; // The row starts a run
+        for (size_t k = 0; k < words; ++k) {
+            uint64_t valid = validMask(k), lastColumn = k + 1 == words ? uint64_t(1) << ((width - 1) & 63) : 0;
+            uint64_t r = mixBits(key + (2 * k + 1) * GOLDEN_GAMMA);
+            uint64_t east = 0, south = 0;
+            if (lastRow) {
+                east = valid & ~lastColumn;
+            } else if (algorithm == PACKED_BINARY_TREE) {
+                east = r & valid & ~lastColumn;
+                south = (~r & valid) | lastColumn;
+            } else {
+                uint64_t coin = mixBits(key + (2 * k + 2) * GOLDEN_GAMMA);
+                east = r & valid & ~lastColumn;
+                uint64_t ends = valid & ~east;            // Last cell of every run
+                uint64_t candidates = (coin & valid) | ends; // Every run has at least its end
+                uint64_t starts = (ends << 1) | (previousEnds >> 63);
+                if (k == 0) starts |= 1;
+                uint64_t difference = candidates - starts;
+                uint64_t outBorrow = candidates < starts;
+                outBorrow |= difference < borrow;
+                difference -= borrow;
+                south = candidates & (candidates ^ difference);
+                borrow = outBorrow;
+                previousEnds = ends;
+            }
+            packed[2 * k] = spreadBits(east) | (spreadBits(south) << 1);
+            packed[2 * k + 1] = spreadBits(east >> 32) | (spreadBits(south >> 32) << 1);
+        }
+        std::memcpy(out, packed.data(), rowBytes());
+    }
+
+private:
+    PackedAlgorithm algorithm;
+    uint64_t seed;
+    int width, height;
+    size_t words;
+    std::vector<uint64_t> packed;
+
+    uint64_t validMask(size_t k) const {
+        int cells = std::min(64, width - static_cast<int>(k * 64));
+        return cells == 64 ? ~uint64_t(0) : (uint64_t(1) << cells) - 1;
+    }
+};
+
+// Packed rows [firstRow, firstRow + rows) of a width x height maze into out, in bands of
+// rows spread over threads
+inline void generatePackedRows(PackedAlgorithm algorithm, uint64_t seed, int width, int height, int firstRow, int rows, int threads, uint8_t* out) {
+    size_t rowBytes = packedRowBytes(width);
+    int count = std::max(1, std::min(threads, rows));
+    auto band = [&](int t) {
+        if (t > 0) MAZE_TRACE_THREAD("row band");
+        MAZE_TRACE_SCOPE("generate rows");
+        PackedRowGenerator generator(algorithm, seed, width, height);
+        int begin = static_cast<int>(static_cast<int64_t>(rows) * t / count), end = static_cast<int>(static_cast<int64_t>(rows) * (t + 1) / count);
+        for (int y = begin; y < end; ++y) generator.row(firstRow + y, out + static_cast<size_t>(y) * rowBytes);
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < count; ++t) workers.emplace_back(band, t);
+    band(0);
+    for (auto& worker : workers) worker.join();
+}
+
+inline void generatePacked(PackedAlgorithm algorithm, uint64_t seed, int width, int height, int threads, uint8_t* out) {
+    generatePackedRows(algorithm, seed, width, height, 0, height, threads, out);
+}
+
+// Grid versions for the generator table; the seed comes from the caller's rng
+inline void generatePackedGrid(PackedAlgorithm algorithm, Grid& grid, std::mt19937& rng) {
+    uint64_t seed = rng();
+    seed = (seed << 32) | rng();
+    PackedRowGenerator generator(algorithm, seed, grid.width, grid.height);
+    std::vector<uint8_t> row(generator.rowBytes());
+    std::fill(grid.cells.begin(), grid.cells.end(), 0);
+    for (int y = 0; y < grid.height; ++y) {
+        generator.row(y, row.data());
+        unpackRow(grid, y, row.data());
+    }
+}
+
+inline void generateBinaryTree(Grid& grid, std::mt19937& rng) {
+    generatePackedGrid(PACKED_BINARY_TREE, grid, rng);
+}
+
+inline void generateSidewinder(Grid& grid, std::mt19937& rng) {
+    generatePackedGrid(PACKED_SIDEWINDER, grid, rng);
+}
+
+#endif
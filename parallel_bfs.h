@@ -0,0 +1,305 @@
+#ifndef PARALLEL_BFS_H
+#define PARALLEL_BFS_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "maze_grid.h"
+#include "maze_trace.h"
+
+// Level-synchronous parallel breadth-first search that fills in the distance from one
+// cell to every other cell.
+//
+// Each level runs either top-down or bottom-up, after Beamer's direction-optimizing BFS:
+//   top-down:  every frontier cell looks at its neighbours. The frontier is a set of
+//              per-thread lists; each thread takes an even slice of their concatenation
+//              and appends what it discovers to its own list, so there is no shared
+//              queue. A cell is claimed with one fetch_or on the visited bitmap.
+//   bottom-up: every unvisited cell looks for a neighbour in the frontier bitmap. Each
+//              thread owns a range of whole bitmap words and only writes to its own
+//              cells, so no atomic read-modify-writes are needed at all.
+// Top-down is cheap while the frontier is small; bottom-up wins once the frontier is a
+// large share of what is left. Small levels run on the calling thread alone, since a
+// maze can have hundreds of thousands of thin levels.
+//
+// The grid's border walls must be closed (maze_verify checks this), which lets the inner
+// loops step to a neighbour by adding an offset. A grid with an open border falls back to
+// Grid::neighbor.
+class ParallelBfs {
+public:
+    static constexpr uint32_t UNREACHED = UINT32_MAX;
+    static constexpr int ALPHA = 14;              // Go bottom-up when frontier * ALPHA > unvisited
+    static constexpr int BETA = 24;               // Go back top-down when frontier * BETA < cells
+    static constexpr size_t PARALLEL_MIN = 2048;  // Smaller top-down levels stay on one thread
+
+    ParallelBfs(const Grid& grid, int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+        : grid(grid), words((grid.size() + 63) / 64), visited(words), frontierBits(words), nextBits(words), lanes(std::max(1, threads)) {
+        closedBorder = true;
+        for (int x = 0; x < grid.width; ++x) {
+            if (grid.cells[grid.index(x, 0)] & NORTH || grid.cells[grid.index(x, grid.height - 1)] & SOUTH) closedBorder = false;
+        }
+        for (int y = 0; y < grid.height; ++y) {
+            if (grid.cells[grid.index(0, y)] & WEST || grid.cells[grid.index(grid.width - 1, y)] & EAST) closedBorder = false;
+        }
+        for (int t = 1; t < threadCount(); ++t) workers.emplace_back([this, t] { work(t); });
+    }
+
+    ~ParallelBfs() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            active = true;
+        }
+        wake.notify_all();
+        dispatch(EXIT);
+        for (auto& worker : workers) worker.join();
+    }
+
+    int threadCount() const { return static_cast<int>(lanes.size()); }
+
+    // Distances from source to every cell, UNREACHED where there is no path
+    const std::vector<uint32_t>& run(uint32_t source) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            active = true;
+        }
+        wake.notify_all();
+
+        levelCount = topDownLevels = bottomUpLevels = edgesChecked = 0;
+        distances.resize(grid.size());
+        dispatch(RESET);
+        distances[source] = 0;
+        visited[source >> 6].store(uint64_t(1) << (source & 63), std::memory_order_relaxed);
+        for (Lane& lane : lanes) lane.list.clear();
+        lanes[0].list.push_back(source);
+
+        uint64_t frontier = 1, unvisited = grid.size() - 1;
+        bool bottomUp = false;
+        for (level = 0; frontier > 0; ++level) {
+            bool wantBottomUp = bottomUp ? frontier * BETA >= grid.size() : frontier * ALPHA > unvisited;
+            if (wantBottomUp && !bottomUp) {
+                dispatch(CLEAR_FRONTIER);
+                dispatch(MARK_FRONTIER); // Lists to bitmap
+            } else if (!wantBottomUp && bottomUp) {
+                dispatch(COLLECT_FRONTIER); // Bitmap to lists
+            }
+            bottomUp = wantBottomUp;
+
+            if (bottomUp) {
+                dispatch(BOTTOM_UP);
+                std::swap(frontierBits, nextBits);
+                ++bottomUpLevels;
+            } else {
+                offsets.assign(1, 0);
+                for (Lane& lane : lanes) offsets.push_back(offsets.back() + lane.list.size());
+                if (offsets.back() < PARALLEL_MIN) {
+                    // Too small to be worth waking the workers: one lane does the whole level
+                    for (Lane& lane : lanes) lane.found = lane.edges = 0;
+                    lanes[0].next.clear();
+                    topDown(0, 0, offsets.back());
+                    for (int t = 1; t < threadCount(); ++t) lanes[t].next.clear();
+                } else {
+                    dispatch(TOP_DOWN);
+                }
+                for (Lane& lane : lanes) std::swap(lane.list, lane.next);
+                ++topDownLevels;
+            }
+
+            frontier = 0;
+            for (Lane& lane : lanes) {
+                frontier += lane.found;
+                edgesChecked += lane.edges;
+            }
+            unvisited -= frontier;
+            ++levelCount;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        active = false;
+        return distances;
+    }
+
+    const std::vector<uint32_t>& distance() const { return distances; }
+    uint32_t levels() const { return levelCount; }
+    uint32_t topDown() const { return topDownLevels; }
+    uint32_t bottomUp() const { return bottomUpLevels; }
+    uint64_t edgesExamined() const { return edgesChecked; }
+
+private:
+    enum Phase { RESET, TOP_DOWN, BOTTOM_UP, CLEAR_FRONTIER, MARK_FRONTIER, COLLECT_FRONTIER, EXIT };
+
+    // Per-thread state on its own cache lines
+    struct alignas(64) Lane {
+        std::vector<uint32_t> list; // This lane's part of the frontier (top-down)
+        std::vector<uint32_t> next;
+        uint64_t found = 0;
+        uint64_t edges = 0;
+    };
+
+    const Grid& grid;
+    size_t words;
+    std::vector<std::atomic<uint64_t>> visited;
+    std::vector<std::atomic<uint64_t>> frontierBits;
+    std::vector<std::atomic<uint64_t>> nextBits;
+    std::vector<uint32_t> distances;
+    std::vector<Lane> lanes;
+    std::vector<size_t> offsets; // Prefix sums of the lane list sizes
+    bool closedBorder = true;
+    uint32_t level = 0;
+    uint32_t levelCount = 0, topDownLevels = 0, bottomUpLevels = 0;
+    uint64_t edgesChecked = 0;
+
+    std::vector<std::thread> workers;
+    std::atomic<uint64_t> generation{0};
+    std::atomic<int> remaining{0};
+    Phase phase = RESET;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool active = false; // Workers sleep on wake between runs and spin during one
+
+    size_t wordBegin(int lane) const { return words * lane / lanes.size(); }
+
+    bool step(uint32_t cell, Direction dir, uint32_t& next) const {
+        if (!closedBorder) return grid.neighbor(cell, dir, next);
+        switch (dir) {
+            case NORTH: next = cell - grid.width; break;
+            case SOUTH: next = cell + grid.width; break;
+            case EAST: next = cell + 1; break;
+            case WEST: next = cell - 1; break;
+        }
+        return true;
+    }
+
+    // Run one phase on every lane; the calling thread takes lane 0
+    void dispatch(Phase next) {
+        phase = next;
+        remaining.store(threadCount() - 1, std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_release);
+        if (next == EXIT) return;
+        runPhase(0);
+        while (remaining.load(std::memory_order_acquire) > 0) std::this_thread::yield();
+    }
+
+    void work(int lane) {
+        MAZE_TRACE_THREAD("bfs lane");
+        uint64_t seen = 0;
+        while (true) {
+            for (int spins = 0; generation.load(std::memory_order_acquire) == seen; ++spins) {
+                if (spins < 64) continue;
+                std::unique_lock<std::mutex> lock(mutex);
+                if (active) {
+                    lock.unlock();
+                    std::this_thread::yield();
+                } else {
+                    wake.wait(lock, [&] { return active; });
+                }
+            }
+            ++seen;
+            if (phase == EXIT) return;
+            runPhase(lane);
+            remaining.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void runPhase(int t) {
+        MAZE_TRACE_SCOPE("bfs phase");
+        Lane& lane = lanes[t];
+        size_t first = wordBegin(t), last = wordBegin(t + 1);
+        switch (phase) {
+            case RESET:
+                std::fill(distances.begin() + std::min<size_t>(first * 64, grid.size()), distances.begin() + std::min<size_t>(last * 64, grid.size()), UNREACHED);
+                for (size_t w = first; w < last; ++w) visited[w].store(0, std::memory_order_relaxed);
+                break;
+            case TOP_DOWN:
+                lane.next.clear();
+                topDown(t, offsets.back() * t / lanes.size(), offsets.back() * (t + 1) / lanes.size());
+                break;
+            case BOTTOM_UP:
+                bottomUpRange(lane, first, last);
+                break;
+            case CLEAR_FRONTIER:
+                for (size_t w = first; w < last; ++w) frontierBits[w].store(0, std::memory_order_relaxed);
+                break;
+            case MARK_FRONTIER:
+                for (uint32_t cell : lane.list) frontierBits[cell >> 6].fetch_or(uint64_t(1) << (cell & 63), std::memory_order_relaxed);
+                break;
+            case COLLECT_FRONTIER:
+                lane.list.clear();
+                for (size_t w = first; w < last; ++w) {
+                    for (uint64_t bits = frontierBits[w].load(std::memory_order_relaxed); bits; bits &= bits - 1) {
+                        lane.list.push_back(static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits)));
+                    }
+                }
+                break;
+            case EXIT:
+                break;
+        }
+    }
+
+    // Expand frontier entries [begin, end) of the concatenated lane lists into lanes[t].next
+    void topDown(int t, size_t begin, size_t end) {
+        Lane& lane = lanes[t];
+        uint64_t found = 0, edges = 0;
+        uint32_t depth = level + 1;
+        size_t chunk = std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin() - 1;
+        for (size_t i = begin; i < end; ++chunk) {
+            const std::vector<uint32_t>& list = lanes[chunk].list;
+            size_t stop = std::min(end, offsets[chunk + 1]);
+            for (; i < stop; ++i) {
+                uint32_t cell = list[i - offsets[chunk]];
+                uint8_t open = grid.cells[cell];
+                for (Direction dir : DIRECTIONS) {
+                    uint32_t next = 0;
+                    if (!(open & dir) || !step(cell, dir, next)) continue;
+                    ++edges;
+                    uint64_t bit = uint64_t(1) << (next & 63);
+                    std::atomic<uint64_t>& word = visited[next >> 6];
+                    if (word.load(std::memory_order_relaxed) & bit) continue;
+                    if (word.fetch_or(bit, std::memory_order_relaxed) & bit) continue; // Another lane won it
+                    distances[next] = depth;
+                    lane.next.push_back(next);
+                    ++found;
+                }
+            }
+        }
+        lane.found = found;
+        lane.edges = edges;
+    }
+
+    // Every unvisited cell in words [first, last) joins the next frontier if a neighbour
+    // is in the current one
+    void bottomUpRange(Lane& lane, size_t first, size_t last) {
+        uint64_t found = 0, edges = 0;
+        uint32_t depth = level + 1;
+        for (size_t w = first; w < last; ++w) {
+            uint64_t seen = visited[w].load(std::memory_order_relaxed);
+            uint64_t added = 0;
+            uint64_t todo = ~seen;
+            if (w == words - 1 && grid.size() % 64) todo &= (uint64_t(1) << (grid.size() % 64)) - 1;
+            for (; todo; todo &= todo - 1) {
+                uint32_t cell = static_cast<uint32_t>(w * 64 + __builtin_ctzll(todo));
+                uint8_t open = grid.cells[cell];
+                for (Direction dir : DIRECTIONS) {
+                    uint32_t next = 0;
+                    if (!(open & dir) || !step(cell, dir, next)) continue;
+                    ++edges;
+                    if (frontierBits[next >> 6].load(std::memory_order_relaxed) & (uint64_t(1) << (next & 63))) {
+                        distances[cell] = depth;
+                        added |= uint64_t(1) << (cell & 63);
+                        ++found;
+                        break;
+                    }
+                }
+            }
+            visited[w].store(seen | added, std::memory_order_relaxed);
+            nextBits[w].store(added, std::memory_order_relaxed);
+        }
+        lane.found = found;
+        lane.edges = edges;
+    }
+};
+
+#endif
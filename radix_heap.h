@@ -0,0 +1,72 @@
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Monotone priority queue for integer keys (Ahuja, Mehlhorn, Orlin and Tarjan). Keys must
+// never be smaller than the last key popped, which holds for Dijkstra and for A* with a
+// consistent heuristic.
+//
+// Bucket 0 holds keys equal to the last popped key and bucket i holds keys whose highest
+// bit differing from it is bit i - 1. Push is a bit scan and an append. When bucket 0 runs
+// dry, the lowest non-empty bucket is spread over the buckets below it. Each entry moves
+// down at most 32 times, and in practice only once or twice, with no comparisons between
+// entries.
+template <typename Value>
+class RadixHeap {
+public:
+    struct Entry {
+        uint32_t key;
+        Value value;
+    };
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    void push(uint32_t key, const Value& value) {
+        buckets[bucketOf(key)].push_back({key, value});
+        ++count;
+    }
+
+    Entry pop() {
+        if (buckets[0].empty()) {
+            int i = 1;
+            while (buckets[i].empty()) ++i;
+            uint32_t smallest = buckets[i][0].key;
+            for (const Entry& entry : buckets[i]) smallest = std::min(smallest, entry.key);
+            last = smallest;
+            for (const Entry& entry : buckets[i]) buckets[bucketOf(entry.key)].push_back(entry);
+            buckets[i].clear();
+        }
+        Entry top = buckets[0].back();
+        buckets[0].pop_back();
+        --count;
+        return top;
+    }
+
+    void clear() {
+        for (auto& bucket : buckets) bucket.clear();
+        count = 0;
+        last = 0;
+    }
+
+    // Bytes held by the buckets, including spare capacity
+    size_t memoryBytes() const {
+        size_t bytes = 0;
+        for (const auto& bucket : buckets) bytes += bucket.capacity() * sizeof(Entry);
+        return bytes;
+    }
+
+private:
+    std::vector<Entry> buckets[33];
+    size_t count = 0;
+    uint32_t last = 0;
+
+    int bucketOf(uint32_t key) const { return key == last ? 0 : 32 - __builtin_clz(key ^ last); }
+};
+
+#endif
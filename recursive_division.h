@@ -0,0 +1,113 @@
+#ifndef RECURSIVE_DIVISION_H
+#define RECURSIVE_DIVISION_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "maze_grid.h"
+#include "maze_trace.h"
+#include "work_stealing_pool.h"
+
+// Recursive division, written as a carver so it starts from the same all-walls grid as
+// the other generators. A chamber is cut in two across its longer side (either way when
+// square), one passage is opened through the cut, and the two halves are handled the same
+// way; a chamber one cell wide or tall is opened along its length. The walls left standing
+// are exactly the walls classic recursive division would add.
+//
+// The two halves of a chamber never touch each other's cells, so they can run as separate
+// tasks on a WorkStealingPool. Chambers below a size cutoff finish serially on the thread
+// that reached them. Every random choice comes from a key derived from the parent
+// chamber's key, never from a shared generator, so the maze depends only on the seed and
+// not on the thread count, the cutoff or the order in which tasks run.
+const uint64_t DIVISION_SPLIT_KEYS[2] = {0x8CB92BA72F3D8DD7ull, 0x2545F4914F6CDD1Dull};
+const uint32_t DIVISION_CUTOFF = 1 << 14; // Cells below which a chamber is not split into tasks
+
+struct Chamber {
+    int x, y, width, height;
+    uint64_t key;
+};
+
+// Cuts chamber and opens one passage through the cut, or opens the whole chamber when it
+// is a single row or column. Returns false in that case, otherwise fills the two halves
+// and, if door is given, the cell the passage was opened from (south when second lies
+// below first, east when it lies to the right).
+inline bool divideChamber(Grid& grid, const Chamber& chamber, Chamber& first, Chamber& second, uint32_t* door = nullptr) {
+    if (chamber.width == 1 || chamber.height == 1) {
+        Direction dir = chamber.width == 1 ? SOUTH : EAST;
+        for (int i = 0; i + 1 < chamber.width * chamber.height; ++i) {
+            int x = chamber.x + (dir == EAST ? i : 0), y = chamber.y + (dir == SOUTH ? i : 0);
+            grid.carve(grid.index(x, y), dir);
+        }
+        return false;
+    }
+    uint64_t bits = mixBits(chamber.key);
+    bool horizontal = chamber.height > chamber.width || (chamber.height == chamber.width && (bits & 1));
+    bits >>= 1;
+    first = chamber;
+    second = chamber;
+    first.key = mixBits(chamber.key ^ DIVISION_SPLIT_KEYS[0]);
+    second.key = mixBits(chamber.key ^ DIVISION_SPLIT_KEYS[1]);
+    if (horizontal) {
+        // Cut below row first.height - 1, passage south from one cell of that row
+        first.height = 1 + static_cast<int>((bits & 0xFFFFFFFF) % (chamber.height - 1));
+        second.y += first.height;
+        second.height -= first.height;
+        uint32_t cell = grid.index(chamber.x + static_cast<int>((bits >> 32) % chamber.width), second.y - 1);
+        grid.carve(cell, SOUTH);
+        if (door) *door = cell;
+    } else {
+        first.width = 1 + static_cast<int>((bits & 0xFFFFFFFF) % (chamber.width - 1));
+        second.x += first.width;
+        second.width -= first.width;
+        uint32_t cell = grid.index(second.x - 1, chamber.y + static_cast<int>((bits >> 32) % chamber.height));
+        grid.carve(cell, EAST);
+        if (door) *door = cell;
+    }
+    return true;
+}
+
+// Whole chamber on the calling thread, with an explicit stack since long thin chambers
+// would otherwise recurse once per row or column
+inline void divideSerial(Grid& grid, const Chamber& chamber) {
+    std::vector<Chamber> stack = {chamber};
+    while (!stack.empty()) {
+        Chamber current = stack.back(), first, second;
+        stack.pop_back();
+        if (divideChamber(grid, current, first, second)) {
+            stack.push_back(second);
+            stack.push_back(first);
+        }
+    }
+}
+
+// Fork-join: the second half goes to the pool, the first stays on this thread
+inline void divideParallel(Grid& grid, const Chamber& chamber, WorkStealingPool& pool, uint32_t cutoff) {
+    Chamber current = chamber;
+    TaskGroup group(pool);
+    while (static_cast<uint32_t>(current.width) * current.height >= cutoff) {
+        Chamber first, second;
+        if (!divideChamber(grid, current, first, second)) {
+            group.wait();
+            return;
+        }
+        group.run([&grid, second, &pool, cutoff] { divideParallel(grid, second, pool, cutoff); });
+        current = first;
+    }
+    {
+        MAZE_TRACE_SCOPE("divide serial");
+        divideSerial(grid, current);
+    }
+    group.wait();
+}
+
+inline void generateRecursiveDivision(Grid& grid, std::mt19937& rng) {
+    uint64_t seed = rng();
+    seed = (seed << 32) | rng();
+    divideSerial(grid, {0, 0, grid.width, grid.height, seed});
+}
+
+inline void generateRecursiveDivisionParallel(Grid& grid, uint64_t seed, WorkStealingPool& pool, uint32_t cutoff = DIVISION_CUTOFF) {
+    divideParallel(grid, {0, 0, grid.width, grid.height, seed}, pool, cutoff);
+}
+
+#endif
@@ -0,0 +1,406 @@
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include "maze_generators.h"
+
+// Measures what each way of drawing a maze costs, away from any display. Frames go to
+// SDL's software renderer on a plain surface, or to a target texture of a renderer on a
+// hidden window of the dummy (or any other, --driver) video driver; vsync is never asked
+// for, so nothing waits on a refresh. SDL_VIDEODRIVER in the environment still wins.
+//
+// Every path draws the same animation: a backtracker maze appearing over FRAMES_PER_RUN
+// frames, a share of its carves per frame (row order), plus a cursor on the last carved
+// cell. Cells are at least MIN_CELL pixels, so a carved wall always has pixels to erase
+// between its corners; for big mazes the frame grows past --view to 2 * size + 1 pixels.
+// Each size runs until the frames are done or --seconds is spent (at least
+// MIN_FRAMES), and reports frames per second and draw calls (clears, lines, rects,
+// geometry and copies) per frame. A pixel is read back after each frame so renderers
+// that queue work are timed doing it.
+//
+// Paths, one entry each in DRAW_PATHS; add new draw code there:
+//   lines     a line per wall per cell, as animate_maze, maze_replay and archive_view draw
+//   rects     a rect per wall per cell, the per-cell SDL_RenderFillRect of kruskal_maze
+//   batched   every wall in one SDL_RenderFillRects call per BATCH_RECTS walls
+//   geometry  every wall as a quad, one SDL_RenderGeometry call per BATCH_RECTS walls
+//   texture   a cached maze texture, redrawn whole when the maze changes, then copied
+//   carves    a cached texture with only the newly carved walls erased, as maze.cpp does
+//   dirty     no clear and no texture: only the changed walls and cursor are redrawn
+//             in the frame, which keeps its pixels between frames on both backends
+//
+// Usage: render_bench [--backend software|window] [--driver name] [--sizes 30,100,...]
+//                     [--paths lines,batched,...] [--seconds s] [--view pixels]
+const int DEFAULT_VIEW = 1024;           // Frame edge the maze is scaled to, when cells fit in it
+const int MIN_CELL = 2;                  // Pixels a cell: a wall pixel and an open one
+const int FRAMES_PER_RUN = 120;          // Frames for the whole maze to appear
+const int MIN_FRAMES = 3;
+const double DEFAULT_SECONDS = 2.0;      // Per path and size
+const size_t BATCH_RECTS = 1 << 16;      // Walls per batched call
+const uint32_t BENCH_SEED = 1;
+
+// The animation every path draws, and the renderer state they share
+struct BenchFrame {
+    SDL_Renderer* renderer = nullptr;
+    SDL_Texture* target = nullptr;    // The frame (nullptr: the renderer's own surface)
+    SDL_Texture* texture = nullptr;   // Cached maze for the texture paths
+    bool textureStale = true;
+    Grid maze;                        // Finished maze
+    Grid shown;                       // Walls as of this frame
+    std::vector<std::pair<uint32_t, Direction>> carves;
+    size_t applied = 0;               // Carves shown so far
+    size_t changedFrom = 0;           // First carve of this frame
+    uint32_t cursor = 0, lastCursor = 0;
+    int cellSize = 1;
+    int pixels = 1;                   // Frame edge
+    uint64_t calls = 0;               // Draw calls so far
+    std::vector<SDL_Rect> rects;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+
+    BenchFrame(int size, int view) : maze(size, size), shown(size, size) {
+        cellSize = std::max(MIN_CELL, view / size);
+        pixels = size * cellSize + 1;
+        buildMaze(*findGenerator("backtracker"), BENCH_SEED, maze);
+        for (uint32_t cell = 0; cell < maze.size(); ++cell) {
+            if (maze.isOpen(cell, EAST)) carves.push_back({cell, EAST});
+            if (maze.isOpen(cell, SOUTH)) carves.push_back({cell, SOUTH});
+        }
+    }
+
+    ~BenchFrame() {
+        if (texture) SDL_DestroyTexture(texture);
+    }
+
+    void restart() {
+        std::fill(shown.cells.begin(), shown.cells.end(), 0);
+        applied = changedFrom = 0;
+        cursor = lastCursor = 0;
+        textureStale = true;
+    }
+
+    // Apply frame's share of the carves; false once the maze is complete
+    bool advance(int frame) {
+        if (applied == carves.size()) return false;
+        size_t until = std::min(carves.size(), carves.size() * (frame + 1) / FRAMES_PER_RUN);
+        changedFrom = applied;
+        lastCursor = cursor;
+        for (; applied < until; ++applied) {
+            shown.carve(carves[applied].first, carves[applied].second);
+            cursor = carves[applied].first;
+        }
+        textureStale = textureStale || until > changedFrom;
+        return true;
+    }
+
+    // Rects of the walls standing at cell, borders included
+    template <typename Visit>
+    void walls(uint32_t cell, Visit visit) const {
+        Point p = shown.point(cell);
+        int x1 = p.x * cellSize, y1 = p.y * cellSize;
+        if (!shown.isOpen(cell, NORTH)) visit(SDL_Rect{x1, y1, cellSize + 1, 1});
+        if (!shown.isOpen(cell, WEST)) visit(SDL_Rect{x1, y1, 1, cellSize + 1});
+        if (p.x == shown.width - 1) visit(SDL_Rect{x1 + cellSize, y1, 1, cellSize + 1});
+        if (p.y == shown.height - 1) visit(SDL_Rect{x1, y1 + cellSize, cellSize + 1, 1});
+    }
+
+    SDL_Rect cursorRect(uint32_t cell) const {
+        Point p = shown.point(cell);
+        return {p.x * cellSize + cellSize / 4, p.y * cellSize + cellSize / 4, std::max(1, cellSize / 2), std::max(1, cellSize / 2)};
+    }
+
+    void clear() {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+        SDL_RenderClear(renderer);
+        ++calls;
+    }
+
+    void drawCursor() {
+        SDL_Rect rect = cursorRect(cursor);
+        SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
+        SDL_RenderFillRect(renderer, &rect);
+        ++calls;
+    }
+
+    void flushRects() {
+        if (rects.empty()) return;
+        SDL_RenderFillRects(renderer, rects.data(), static_cast<int>(rects.size()));
+        ++calls;
+        rects.clear();
+    }
+
+    // Every wall, BATCH_RECTS rects to a call
+    void fillWalls() {
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+        for (uint32_t cell = 0; cell < shown.size(); ++cell) {
+            walls(cell, [&](const SDL_Rect& rect) {
+                rects.push_back(rect);
+                if (rects.size() == BATCH_RECTS) flushRects();
+            });
+        }
+        flushRects();
+    }
+};
+
+void drawLines(BenchFrame& frame) {
+    frame.clear();
+    SDL_SetRenderDrawColor(frame.renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+    for (uint32_t cell = 0; cell < frame.shown.size(); ++cell) {
+        frame.walls(cell, [&](const SDL_Rect& rect) {
+            SDL_RenderDrawLine(frame.renderer, rect.x, rect.y, rect.x + rect.w - 1, rect.y + rect.h - 1);
+            ++frame.calls;
+        });
+    }
+    frame.drawCursor();
+}
+
+void drawRects(BenchFrame& frame) {
+    frame.clear();
+    SDL_SetRenderDrawColor(frame.renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+    for (uint32_t cell = 0; cell < frame.shown.size(); ++cell) {
+        frame.walls(cell, [&](const SDL_Rect& rect) {
+            SDL_RenderFillRect(frame.renderer, &rect);
+            ++frame.calls;
+        });
+    }
+    frame.drawCursor();
+}
+
+void drawBatched(BenchFrame& frame) {
+    frame.clear();
+    frame.fillWalls();
+    frame.drawCursor();
+}
+
+void flushGeometry(BenchFrame& frame) {
+    if (frame.indices.empty()) return;
+    SDL_RenderGeometry(frame.renderer, nullptr, frame.vertices.data(), static_cast<int>(frame.vertices.size()), frame.indices.data(),
+                       static_cast<int>(frame.indices.size()));
+    ++frame.calls;
+    frame.vertices.clear();
+    frame.indices.clear();
+}
+
+void drawGeometry(BenchFrame& frame) {
+    frame.clear();
+    const SDL_Color white = {255, 255, 255, SDL_ALPHA_OPAQUE};
+    for (uint32_t cell = 0; cell < frame.shown.size(); ++cell) {
+        frame.walls(cell, [&](const SDL_Rect& rect) {
+            int first = static_cast<int>(frame.vertices.size());
+            float x1 = static_cast<float>(rect.x), y1 = static_cast<float>(rect.y);
+            float x2 = x1 + rect.w, y2 = y1 + rect.h;
+            frame.vertices.push_back({{x1, y1}, white, {0, 0}});
+            frame.vertices.push_back({{x2, y1}, white, {0, 0}});
+            frame.vertices.push_back({{x2, y2}, white, {0, 0}});
+            frame.vertices.push_back({{x1, y2}, white, {0, 0}});
+            for (int corner : {0, 1, 2, 0, 2, 3}) frame.indices.push_back(first + corner);
+            if (frame.vertices.size() == 4 * BATCH_RECTS) flushGeometry(frame);
+        });
+    }
+    flushGeometry(frame);
+    frame.drawCursor();
+}
+
+bool ensureTexture(BenchFrame& frame) {
+    if (frame.texture) return true;
+    frame.texture = SDL_CreateTexture(frame.renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, frame.pixels, frame.pixels);
+    return frame.texture != nullptr;
+}
+
+void copyTexture(BenchFrame& frame) {
+    frame.clear();
+    SDL_RenderCopy(frame.renderer, frame.texture, nullptr, nullptr);
+    ++frame.calls;
+    frame.drawCursor();
+}
+
+void drawTexture(BenchFrame& frame) {
+    if (!ensureTexture(frame)) return;
+    if (frame.textureStale) {
+        SDL_SetRenderTarget(frame.renderer, frame.texture);
+        frame.clear();
+        frame.fillWalls();
+        SDL_SetRenderTarget(frame.renderer, frame.target);
+        frame.textureStale = false;
+    }
+    copyTexture(frame);
+}
+
+// Erase this frame's carved walls, leaving the corner pixels so neighbouring walls stay joined
+void eraseCarves(BenchFrame& frame) {
+    SDL_SetRenderDrawColor(frame.renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+    for (size_t i = frame.changedFrom; i < frame.applied; ++i) {
+        Point p = frame.shown.point(frame.carves[i].first);
+        int x1 = p.x * frame.cellSize, y1 = p.y * frame.cellSize;
+        if (frame.carves[i].second == EAST) frame.rects.push_back({x1 + frame.cellSize, y1 + 1, 1, frame.cellSize - 1});
+        else frame.rects.push_back({x1 + 1, y1 + frame.cellSize, frame.cellSize - 1, 1});
+        if (frame.rects.size() == BATCH_RECTS) frame.flushRects();
+    }
+    frame.flushRects();
+}
+
+void drawCarves(BenchFrame& frame) {
+    if (!ensureTexture(frame)) return;
+    SDL_SetRenderTarget(frame.renderer, frame.texture);
+    if (frame.changedFrom == 0) {
+        frame.clear();
+        frame.fillWalls();
+    } else {
+        eraseCarves(frame);
+    }
+    SDL_SetRenderTarget(frame.renderer, frame.target);
+    copyTexture(frame);
+}
+
+void drawDirty(BenchFrame& frame) {
+    if (frame.changedFrom == 0) {
+        frame.clear();
+        frame.fillWalls();
+    } else {
+        SDL_Rect old = frame.cursorRect(frame.lastCursor);
+        SDL_SetRenderDrawColor(frame.renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+        SDL_RenderFillRect(frame.renderer, &old);
+        ++frame.calls;
+        eraseCarves(frame);
+    }
+    frame.drawCursor();
+}
+
+struct DrawPath {
+    const char* name;
+    void (*draw)(BenchFrame&);
+};
+
+const DrawPath DRAW_PATHS[] = {
+    {"lines", drawLines},     {"rects", drawRects},     {"batched", drawBatched}, {"geometry", drawGeometry},
+    {"texture", drawTexture}, {"carves", drawCarves},   {"dirty", drawDirty},
+};
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    std::string backend = "software", driver = "dummy";
+    std::vector<int> sizes = {30, 100, 300, 1000, 4000};
+    std::vector<const DrawPath*> paths;
+    double budget = DEFAULT_SECONDS;
+    int view = DEFAULT_VIEW;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--backend" && i + 1 < argc) backend = argv[++i];
+        else if (arg == "--driver" && i + 1 < argc) driver = argv[++i];
+        else if (arg == "--seconds" && i + 1 < argc) budget = std::atof(argv[++i]);
+        else if (arg == "--view" && i + 1 < argc) view = std::max(2, std::atoi(argv[++i]));
+        else if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            for (const std::string& size : splitList(argv[++i])) sizes.push_back(std::max(2, std::atoi(size.c_str())));
+        } else if (arg == "--paths" && i + 1 < argc) {
+            for (const std::string& name : splitList(argv[++i])) {
+                auto it = std::find_if(std::begin(DRAW_PATHS), std::end(DRAW_PATHS), [&](const DrawPath& path) { return name == path.name; });
+                if (it == std::end(DRAW_PATHS)) {
+                    std::cerr << "Unknown draw path: " << name << std::endl;
+                    return 1;
+                }
+                paths.push_back(&*it);
+            }
+        } else {
+            std::cerr << "Usage: render_bench [--backend software|window] [--driver name] [--sizes 30,100,...] [--paths lines,batched,...]\n"
+                      << "                    [--seconds s] [--view pixels]" << std::endl;
+            return 1;
+        }
+    }
+    if (paths.empty()) {
+        for (const DrawPath& path : DRAW_PATHS) paths.push_back(&path);
+    }
+    if (backend != "software" && backend != "window") {
+        std::cerr << "Unknown backend: " << backend << std::endl;
+        return 1;
+    }
+
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, driver.c_str());
+    SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    std::cout << backend << " backend, " << driver << " video driver, vsync off" << std::endl;
+    std::cout << std::setw(6) << "size" << std::setw(6) << "cell" << std::setw(10) << "path" << std::setw(8) << "frames" << std::setw(12) << "fps"
+              << std::setw(12) << "ms/frame" << std::setw(14) << "calls/frame" << std::endl;
+    for (int size : sizes) {
+        BenchFrame frame(size, view);
+
+        // The frame: a surface of its own, or a target texture of a hidden window's renderer
+        SDL_Surface* surface = nullptr;
+        SDL_Window* window = nullptr;
+        if (backend == "software") {
+            surface = SDL_CreateRGBSurfaceWithFormat(0, frame.pixels, frame.pixels, 32, SDL_PIXELFORMAT_ARGB8888);
+            frame.renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+        } else {
+            window = SDL_CreateWindow("render_bench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, std::min(frame.pixels, view), std::min(frame.pixels, view),
+                                      SDL_WINDOW_HIDDEN);
+            frame.renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_TARGETTEXTURE) : nullptr;
+            frame.target = frame.renderer ? SDL_CreateTexture(frame.renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, frame.pixels, frame.pixels) : nullptr;
+        }
+        if (!frame.renderer || (window && !frame.target)) {
+            std::cout << std::setw(6) << size << "  skipped: cannot create a " << frame.pixels << "x" << frame.pixels << " frame: " << SDL_GetError()
+                      << std::endl;
+            if (frame.target) SDL_DestroyTexture(frame.target);
+            if (frame.renderer) SDL_DestroyRenderer(frame.renderer);
+            if (window) SDL_DestroyWindow(window);
+            if (surface) SDL_FreeSurface(surface);
+            continue;
+        }
+
+        for (const DrawPath* path : paths) {
+            frame.restart();
+            if (frame.texture) {
+                SDL_DestroyTexture(frame.texture);
+                frame.texture = nullptr;
+            }
+            SDL_SetRenderTarget(frame.renderer, frame.target);
+            frame.calls = 0;
+            int frames = 0;
+            uint32_t pixel = 0;
+            SDL_Rect probe = {0, 0, 1, 1};
+            auto start = std::chrono::steady_clock::now();
+            while (frames < FRAMES_PER_RUN && (frames < MIN_FRAMES || secondsSince(start) < budget)) {
+                frame.advance(frames);
+                path->draw(frame);
+                SDL_RenderReadPixels(frame.renderer, &probe, SDL_PIXELFORMAT_ARGB8888, &pixel, sizeof(pixel));
+                SDL_RenderPresent(frame.renderer);
+                ++frames;
+            }
+            double seconds = secondsSince(start);
+            std::cout << std::setw(6) << size << std::setw(6) << frame.cellSize << std::setw(10) << path->name << std::setw(8) << frames << std::setw(12)
+                      << std::fixed << std::setprecision(1) << frames / seconds << std::setw(12) << std::setprecision(3) << 1000 * seconds / frames
+                      << std::setw(14) << std::setprecision(0) << static_cast<double>(frame.calls) / frames << std::defaultfloat << std::endl;
+        }
+
+        if (frame.texture) {
+            SDL_DestroyTexture(frame.texture);
+            frame.texture = nullptr;
+        }
+        if (frame.target) SDL_DestroyTexture(frame.target);
+        SDL_DestroyRenderer(frame.renderer);
+        if (window) SDL_DestroyWindow(window);
+        if (surface) SDL_FreeSurface(surface);
+    }
+    SDL_Quit();
+    return 0;
+}
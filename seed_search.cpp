@@ -0,0 +1,146 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include "maze_generators.h"
+#include "maze_metrics.h"
+
+// Searches successive seeds for mazes that meet difficulty constraints (maze_metrics.h).
+// Every thread claims the next seed, builds the maze into its own grid and evaluates it
+// with early exits. The search stops once N matches are known and every seed below the
+// N-th of them has been tried, so the seeds printed are the first N matching seeds from
+// the base whatever the thread count. Each can be rebuilt with buildMaze, e.g. through
+// maze_server's "GEN <algorithm> <seed> <width> <height>".
+// Usage: seed_search [--algorithm name] [--size w h] [--seed base] [--matches n] [--threads n]
+//                    [--limit candidates] [--length min max] [--dead-ends min max] [--corridor min max]
+// A bound of "-" is open, e.g. --corridor - 40.
+const int DEFAULT_SIZE = 256;
+const int DEFAULT_MATCHES = 10;
+const uint64_t DEFAULT_LIMIT = 1000000; // Candidates tried before giving up
+
+struct Match {
+    uint64_t seed;
+    MazeMetrics metrics;
+    double seconds; // Since the search started
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool parseBound(const char* text, uint64_t& value) {
+    if (std::string(text) == "-") return true;
+    char* end = nullptr;
+    value = std::strtoull(text, &end, 10);
+    return end && *end == '\0';
+}
+
+std::string rangeText(const MetricRange& range) {
+    if (!range.bounded()) return "any";
+    return (range.min > 0 ? std::to_string(range.min) : "") + ".." + (range.max < UINT64_MAX ? std::to_string(range.max) : "");
+}
+
+int main(int argc, char* argv[]) {
+    std::string algorithm = "backtracker";
+    int width = DEFAULT_SIZE, height = DEFAULT_SIZE;
+    uint64_t base = 1, limit = DEFAULT_LIMIT;
+    size_t wanted = DEFAULT_MATCHES;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    MazeConstraints constraints;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        MetricRange* range = arg == "--length" ? &constraints.length : arg == "--dead-ends" ? &constraints.deadEnds : arg == "--corridor" ? &constraints.corridor : nullptr;
+        if (range && i + 2 < argc) {
+            if (!parseBound(argv[i + 1], range->min) || !parseBound(argv[i + 2], range->max)) {
+                std::cerr << "Bad bounds for " << arg << std::endl;
+                return 1;
+            }
+            i += 2;
+        } else if (arg == "--algorithm" && i + 1 < argc) algorithm = argv[++i];
+        else if (arg == "--size" && i + 2 < argc) {
+            width = std::atoi(argv[++i]);
+            height = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) base = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--matches" && i + 1 < argc) wanted = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--threads" && i + 1 < argc) threads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--limit" && i + 1 < argc) limit = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "Usage: seed_search [--algorithm name] [--size w h] [--seed base] [--matches n] [--threads n]\n"
+                      << "                   [--limit candidates] [--length min max] [--dead-ends min max] [--corridor min max]" << std::endl;
+            return 1;
+        }
+    }
+    const GeneratorInfo* generator = findGenerator(algorithm);
+    if (!generator || width < 2 || height < 2) {
+        std::cerr << "Unknown algorithm or bad size: " << algorithm << " " << width << "x" << height << std::endl;
+        return 1;
+    }
+
+    std::atomic<uint64_t> next(0);
+    std::atomic<uint64_t> stopAt(limit); // Candidates from here on are not started
+    std::atomic<uint64_t> rejected[STAGE_PASSED] = {};
+    std::atomic<uint64_t> examined(0);
+    std::mutex matchesMutex;
+    std::vector<Match> matches;
+    auto start = std::chrono::steady_clock::now();
+
+    auto search = [&] {
+        Grid grid(width, height);
+        MetricEvaluator evaluator;
+        MazeMetrics metrics;
+        for (uint64_t i = next.fetch_add(1); i < stopAt.load(); i = next.fetch_add(1)) {
+            buildMaze(*generator, base + i, grid);
+            MetricStage stage = evaluator.evaluate(grid, constraints, metrics);
+            if (stage != STAGE_PASSED) {
+                rejected[stage].fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            evaluator.evaluate(grid, constraints, metrics, true);
+            std::lock_guard<std::mutex> lock(matchesMutex);
+            matches.push_back({base + i, metrics, secondsSince(start)});
+            if (matches.size() >= wanted) {
+                // The wanted-th smallest seed so far bounds the search
+                std::nth_element(matches.begin(), matches.begin() + (wanted - 1), matches.end(),
+                                 [](const Match& a, const Match& b) { return a.seed < b.seed; });
+                uint64_t bound = matches[wanted - 1].seed - base + 1;
+                if (bound < stopAt.load()) stopAt.store(bound);
+            }
+        }
+        examined.fetch_add(evaluator.cellsExamined(), std::memory_order_relaxed);
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) workers.emplace_back(search);
+    search();
+    for (auto& worker : workers) worker.join();
+    double seconds = secondsSince(start);
+
+    uint64_t candidates = matches.size();
+    for (int stage = 0; stage < STAGE_PASSED; ++stage) candidates += rejected[stage].load();
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) { return a.seed < b.seed; });
+    if (matches.size() > wanted) matches.resize(wanted);
+    double firstSeconds = seconds;
+    for (const Match& match : matches) firstSeconds = std::min(firstSeconds, match.seconds);
+
+    std::cout << algorithm << " " << width << "x" << height << ", length " << rangeText(constraints.length) << ", dead ends " << rangeText(constraints.deadEnds)
+              << ", corridor " << rangeText(constraints.corridor) << ", " << threads << " threads" << std::endl;
+    for (const Match& match : matches) {
+        std::cout << "  seed " << std::setw(10) << match.seed << "  length " << std::setw(6) << match.metrics.length << "  dead ends " << std::setw(6)
+                  << match.metrics.deadEnds << "  corridor " << std::setw(4) << match.metrics.corridor << "  found at " << std::fixed << std::setprecision(3)
+                  << match.seconds << " s" << std::defaultfloat << std::endl;
+    }
+    std::cout << matches.size() << " of " << wanted << " matches in " << candidates << " candidates, " << seconds << " s, " << candidates / seconds
+              << " candidates/s";
+    if (!matches.empty()) std::cout << ", first match after " << firstSeconds << " s";
+    std::cout << std::endl;
+    std::cout << "rejected by";
+    for (int stage = 0; stage < STAGE_PASSED; ++stage) std::cout << " " << METRIC_STAGE_NAMES[stage] << " " << rejected[stage].load();
+    std::cout << "; evaluation looked at " << 100.0 * examined.load() / (static_cast<double>(candidates) * width * height) << "% of cells per candidate"
+              << std::endl;
+    return matches.size() == wanted ? 0 : 1;
+}
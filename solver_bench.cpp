@@ -0,0 +1,83 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "maze_generators.h"
+#include "maze_solvers.h"
+
+// Benchmark: every solver on every generator's output at several sizes, corner to corner.
+// Usage: solver_bench [maxSize] [repeats] [braid]
+// Sizes run from MIN_SIZE up to maxSize, growing 4x; braid > 0 adds loops to each maze.
+const int MIN_SIZE = 64;
+const int DEFAULT_MAX_SIZE = 1024;
+const int DEFAULT_REPEATS = 3;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Every step of the path must go through an open passage
+bool validPath(const Grid& grid, const std::vector<uint32_t>& path, uint32_t start, uint32_t goal) {
+    if (path.empty() || path.front() != start || path.back() != goal) return false;
+    for (size_t i = 1; i < path.size(); ++i) {
+        bool linked = false;
+        for (Direction dir : DIRECTIONS) {
+            uint32_t next = 0;
+            if (grid.isOpen(path[i - 1], dir) && grid.neighbor(path[i - 1], dir, next) && next == path[i]) linked = true;
+        }
+        if (!linked) return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    int maxSize = argc > 1 ? std::atoi(argv[1]) : DEFAULT_MAX_SIZE;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : DEFAULT_REPEATS;
+    double braid = argc > 3 ? std::atof(argv[3]) : 0.0;
+    if (maxSize < MIN_SIZE || repeats < 1) {
+        std::cerr << "Usage: solver_bench [maxSize >= " << MIN_SIZE << "] [repeats] [braid]" << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    std::cout << std::left << std::setw(13) << "generator" << std::setw(7) << "size" << std::setw(15) << "solver" << std::right
+              << std::setw(11) << "ms" << std::setw(12) << "expanded" << std::setw(11) << "peak KB" << std::setw(9) << "length" << std::endl;
+    for (const GeneratorInfo& generator : GENERATORS) {
+        for (int size = MIN_SIZE; size <= maxSize; size *= 4) {
+            Grid grid = buildMaze(generator, 1, size, size);
+            std::mt19937 rng(2);
+            if (braid > 0) braidMaze(grid, rng, braid);
+            uint32_t start = 0, goal = grid.size() - 1;
+
+            size_t shortest = 0;
+            for (const SolverInfo& solver : SOLVERS) {
+                SolveResult result;
+                bool found = false;
+                double best = 1e30;
+                for (int r = 0; r < repeats; ++r) {
+                    result = SolveResult();
+                    auto began = std::chrono::steady_clock::now();
+                    found = solver.solve(grid, start, goal, result);
+                    best = std::min(best, secondsSince(began));
+                }
+
+                // BFS runs first and sets the length every shortest-path solver must match
+                std::string note;
+                if (!found) note = solver.perfectOnly && braid > 0 ? " (gave up on loops)" : " FAIL: no path";
+                else if (!validPath(grid, result.path, start, goal)) note = " FAIL: invalid path";
+                else if (shortest == 0) shortest = result.path.size();
+                else if (solver.shortest && result.path.size() != shortest) note = " FAIL: not shortest";
+                if (note.find("FAIL") != std::string::npos) ++failures;
+
+                std::cout << std::left << std::setw(13) << generator.name << std::setw(7) << size << std::setw(15) << solver.name << std::right
+                          << std::fixed << std::setprecision(3) << std::setw(11) << best * 1000 << std::setw(12) << result.expanded
+                          << std::setw(11) << result.peakBytes / 1024 << std::setw(9) << (found ? result.path.size() - 1 : 0) << note << std::endl;
+            }
+        }
+    }
+    if (failures) std::cout << failures << " failures" << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,61 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Lock-free ring buffer for exactly one producer thread and one consumer thread.
+// Capacity is rounded up to a power of two so indices wrap with a mask.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        buffer.resize(size);
+        mask = size - 1;
+    }
+
+    // Producer side: returns false when the queue is full
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead == buffer.size()) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead == buffer.size()) return false;
+        }
+        buffer[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: returns false when the queue is empty
+    bool pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) return false;
+        }
+        item = buffer[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    std::vector<T> buffer;
+    size_t mask;
+
+    // Consumer-owned index, kept on its own cache line away from the producer's
+    alignas(64) std::atomic<size_t> head{0};
+    size_t cachedTail = 0;
+
+    // Producer-owned index
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "maze_generators.h"
+#include "maze_solvers.h"
+
+// Benchmark: Dijkstra and A* with std::priority_queue against the same searches on a radix
+// heap, over braided mazes with terrain costs 1-16 and 1-255.
+// Usage: terrain_bench [size] [queries] [braid]
+// Braiding matters here: a perfect maze has only one route, whatever the terrain.
+const int DEFAULT_SIZE = 2048;
+const int DEFAULT_QUERIES = 10;
+const double DEFAULT_BRAID = 1.0;
+const int COST_RANGES[][2] = {{1, 16}, {1, 255}};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int size = argc > 1 ? std::atoi(argv[1]) : DEFAULT_SIZE;
+    int queries = argc > 2 ? std::atoi(argv[2]) : DEFAULT_QUERIES;
+    double braid = argc > 3 ? std::atof(argv[3]) : DEFAULT_BRAID;
+    if (size < 2 || queries < 1) {
+        std::cerr << "Usage: terrain_bench [size] [queries] [braid]" << std::endl;
+        return 1;
+    }
+
+    Grid grid = buildMaze(GENERATORS[1], 1, size, size);
+    std::mt19937 rng(2);
+    braidMaze(grid, rng, braid);
+    std::cout << size << "x" << size << " kruskal maze, braid " << braid << ", " << queries << " queries (first one corner to corner)" << std::endl;
+
+    int mismatches = 0;
+    for (const auto& range : COST_RANGES) {
+        generateTerrain(grid, rng, range[0], range[1]);
+        std::vector<std::pair<uint32_t, uint32_t>> pairs = {{0, grid.size() - 1}};
+        std::uniform_int_distribution<uint32_t> anyCell(0, grid.size() - 1);
+        while (static_cast<int>(pairs.size()) < queries) pairs.push_back({anyCell(rng), anyCell(rng)});
+
+        std::cout << "costs " << range[0] << "-" << range[1] << ":" << std::endl;
+        double baseline[2] = {0, 0}; // priority_queue times for Dijkstra and A*
+        std::vector<uint64_t> costs;
+        for (size_t s = 0; s < std::size(WEIGHTED_SOLVERS); ++s) {
+            const SolverInfo& solver = WEIGHTED_SOLVERS[s];
+            double seconds = 0;
+            uint64_t expanded = 0;
+            size_t peak = 0;
+            for (size_t q = 0; q < pairs.size(); ++q) {
+                SolveResult result;
+                auto start = std::chrono::steady_clock::now();
+                solver.solve(grid, pairs[q].first, pairs[q].second, result);
+                seconds += secondsSince(start);
+                expanded += result.expanded;
+                peak = std::max(peak, result.peakBytes);
+
+                // Every solver must find a route of the same total cost
+                uint64_t cost = pathCost(grid, result.path);
+                if (s == 0) costs.push_back(cost);
+                else if (cost != costs[q]) ++mismatches;
+            }
+            bool radix = std::string(solver.name).find("radix") != std::string::npos;
+            double& base = baseline[s / 2];
+            if (!radix) base = seconds;
+            std::cout << "  " << std::left << std::setw(16) << solver.name << std::right << std::fixed << std::setprecision(3) << std::setw(9)
+                      << seconds * 1000 / pairs.size() << " ms/query" << std::setw(11) << expanded / pairs.size() << " expanded"
+                      << std::setw(8) << peak / (1024 * 1024) << " MB peak";
+            if (radix) std::cout << ", " << std::setprecision(2) << base / seconds << "x priority_queue";
+            std::cout << std::endl;
+        }
+    }
+    std::cout << (mismatches ? std::to_string(mismatches) + " cost mismatches" : std::string("all solvers agree on every route cost")) << std::endl;
+    return mismatches ? 1 : 0;
+}
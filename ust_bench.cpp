@@ -0,0 +1,104 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <functional>
+#include "maze_generators.h"
+#include "maze_verifier.h"
+
+// Benchmark for the uniform spanning tree generators: wall-clock time for Aldous-Broder,
+// Wilson, the hybrid and the parallel walkers on one large grid, every maze checked with
+// verifyGrid. Then a uniformity check: a 3x3 grid has 192 spanning trees, so many small
+// mazes are drawn from each generator and a chi-square statistic (191 degrees of freedom)
+// is compared against the uniform distribution. Only Aldous-Broder and Wilson are exact;
+// the hybrid and the parallel walkers are reported but not required to pass, and the
+// backtracker and Kruskal's are listed as contrast.
+// Usage: ust_bench [size] [threads] [samples per tree] [--trace file]
+const int DEFAULT_SIZE = 4096;
+const int DEFAULT_SAMPLES = 200;
+const int TREES_3X3 = 192;
+const double CHI_SQUARE_LIMIT = 270; // About four standard deviations above the mean of 191
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Candidate {
+    std::string name;
+    std::function<void(Grid&, std::mt19937&)> generate;
+    bool timed;
+    bool exact;
+};
+
+// Draws trees from generate on a 3x3 grid and returns the chi-square statistic
+double chiSquare(const Candidate& candidate, int samplesPerTree, size_t& distinct) {
+    std::map<std::vector<uint8_t>, int> counts;
+    std::mt19937 rng(7);
+    int samples = samplesPerTree * TREES_3X3;
+    for (int i = 0; i < samples; ++i) {
+        Grid grid(3, 3);
+        candidate.generate(grid, rng);
+        ++counts[grid.cells];
+    }
+    distinct = counts.size();
+    // Trees never drawn contribute their full expected count
+    double statistic = static_cast<double>(TREES_3X3 - distinct) * samplesPerTree;
+    for (const auto& [tree, count] : counts) {
+        double diff = count - samplesPerTree;
+        statistic += diff * diff / samplesPerTree;
+    }
+    return statistic;
+}
+
+int main(int argc, char* argv[]) {
+    startTraceFromArgs(argc, argv);
+    int size = argc > 1 ? std::atoi(argv[1]) : DEFAULT_SIZE;
+    int threads = argc > 2 ? std::atoi(argv[2]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int samplesPerTree = argc > 3 ? std::atoi(argv[3]) : DEFAULT_SAMPLES;
+    if (size < 2 || threads < 1 || samplesPerTree < 1) {
+        std::cerr << "Usage: ust_bench [size] [threads] [samples per tree] [--trace file]" << std::endl;
+        return 1;
+    }
+
+    std::vector<Candidate> candidates = {
+        {"aldous-broder", generateAldousBroder, true, true},
+        {"wilson", generateWilson, true, true},
+        {"hybrid", generateHybridUst, true, false},
+        {"parallel x" + std::to_string(threads), [threads](Grid& grid, std::mt19937& rng) { generateParallelAldousBroder(grid, rng, threads); }, true, false},
+        {"parallel x" + std::to_string(threads) + " full", [threads](Grid& grid, std::mt19937& rng) { generateParallelAldousBroder(grid, rng, threads, 1.0); },
+         true, false},
+        {"backtracker", generateBacktracker, false, false},
+        {"kruskal", generateKruskal, false, false},
+    };
+
+    int failures = 0;
+    std::cout << size << "x" << size << " uniform spanning trees, " << threads << " threads:" << std::endl;
+    for (const Candidate& candidate : candidates) {
+        if (!candidate.timed) continue;
+        Grid grid(size, size);
+        std::mt19937 rng(1);
+        auto start = std::chrono::steady_clock::now();
+        candidate.generate(grid, rng);
+        double seconds = secondsSince(start);
+        bool perfect = verifyGrid(grid).perfect();
+        if (!perfect) ++failures;
+        std::cout << "  " << candidate.name << ": " << seconds << " s, " << grid.size() / seconds / 1e6 << " Mcells/s" << (perfect ? "" : ", NOT A PERFECT MAZE")
+                  << std::endl;
+    }
+
+    std::cout << "3x3 uniformity, " << samplesPerTree * TREES_3X3 << " samples, chi-square limit " << CHI_SQUARE_LIMIT << ":" << std::endl;
+    for (const Candidate& candidate : candidates) {
+        size_t distinct = 0;
+        double statistic = chiSquare(candidate, samplesPerTree, distinct);
+        bool passed = statistic < CHI_SQUARE_LIMIT;
+        if (candidate.exact && !passed) ++failures;
+        std::cout << "  " << candidate.name << ": chi-square " << statistic << ", " << distinct << " of " << TREES_3X3 << " trees"
+                  << (passed ? ", uniform" : ", biased") << std::endl;
+    }
+    MAZE_TRACE_STOP();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,170 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "maze_trace.h"
+
+// Thread pool where every worker owns a deque of tasks. A worker pushes and pops at the
+// back of its own deque (newest first, good for locality and for fork-join recursion)
+// and, when it runs dry, steals from the front of another worker's deque (oldest first,
+// usually the largest piece of work). Tasks submitted from outside the pool are spread
+// round-robin. Each deque has its own small lock, so workers rarely contend.
+class WorkStealingPool {
+public:
+    typedef std::function<void()> Task;
+
+    explicit WorkStealingPool(int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+        : queues(std::max(1, threads)) {
+        for (size_t i = 0; i < queues.size(); ++i) queues[i] = std::make_unique<Queue>();
+        for (size_t i = 0; i < queues.size(); ++i) workers.emplace_back([this, i] { work(static_cast<int>(i)); });
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    int threadCount() const { return static_cast<int>(queues.size()); }
+
+    // Index of the calling worker in this pool, or -1 on any other thread
+    int workerIndex() const { return currentPool() == this ? currentIndex() : -1; }
+
+    void submit(Task task) {
+        int index = workerIndex();
+        if (index < 0) index = static_cast<int>(nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size());
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        pending.fetch_add(1, std::memory_order_release);
+        if (sleeping.load(std::memory_order_acquire) > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            wake.notify_one();
+        }
+    }
+
+    // Run one queued task on the calling thread, if any; used to help while waiting
+    bool runOne() {
+        Task task;
+        int index = workerIndex();
+        if (!take(index < 0 ? 0 : index, task)) return false;
+        MAZE_TRACE_SCOPE("pool task");
+        task();
+        return true;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> nextQueue{0};
+    std::atomic<size_t> pending{0};
+    std::atomic<int> sleeping{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    static const WorkStealingPool*& currentPool() {
+        thread_local const WorkStealingPool* pool = nullptr;
+        return pool;
+    }
+
+    static int& currentIndex() {
+        thread_local int index = -1;
+        return index;
+    }
+
+    // Own deque from the back, then every other deque from the front
+    bool take(int self, Task& task) {
+        if (pending.load(std::memory_order_acquire) == 0) return false;
+        {
+            Queue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        for (size_t i = 1; i < queues.size(); ++i) {
+            Queue& victim = *queues[(self + i) % queues.size()];
+            std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+            if (!lock.owns_lock() || victim.tasks.empty()) continue;
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void work(int index) {
+        currentPool() = this;
+        currentIndex() = index;
+        MAZE_TRACE_THREAD("pool worker");
+        Task task;
+        while (true) {
+            if (take(index, task)) {
+                MAZE_TRACE_SCOPE("pool task");
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            if (stopping && pending.load(std::memory_order_acquire) == 0) return;
+            sleeping.fetch_add(1, std::memory_order_acq_rel);
+            // A task may slip in between the failed take and here; the timeout covers
+            // a missed wake-up and a failed try_lock on a busy deque
+            wake.wait_for(lock, std::chrono::milliseconds(1), [&] { return stopping || pending.load(std::memory_order_acquire) > 0; });
+            sleeping.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+};
+
+// Tasks that can be waited on together. wait() runs queued tasks on the waiting thread
+// instead of blocking, so recursive fork-join code cannot starve the pool.
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkStealingPool& pool) : pool(pool) {}
+
+    ~TaskGroup() { wait(); }
+
+    void run(WorkStealingPool::Task task) {
+        outstanding.fetch_add(1, std::memory_order_relaxed);
+        pool.submit([this, task = std::move(task)] {
+            task();
+            outstanding.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    void wait() {
+        while (outstanding.load(std::memory_order_acquire) > 0) {
+            if (!pool.runOne()) std::this_thread::yield();
+        }
+    }
+
+private:
+    WorkStealingPool& pool;
+    std::atomic<size_t> outstanding{0};
+};
+
+#endif